@@ -20,6 +20,23 @@ namespace l0 {
 namespace {
 using namespace lua;
 static bool bypass_luascript;
+<%
+  hooked_names = [func.get('name') for func in functions.values()
+                  if is_latest_version(functions, func) and
+                  func.get('component') != 'ze_gits_extension']
+%>
+enum HookId : unsigned {
+%for hooked_name in hooked_names:
+  HOOK_${hooked_name},
+%endfor
+  HOOKS_COUNT
+};
+const char* const hookNames[] = {
+%for hooked_name in hooked_names:
+  "${hooked_name}",
+%endfor
+};
+HookTable hooks(hookNames, HOOKS_COUNT);
 bool load_l0_function_from_original_library_generic(void*& func, const char* name) {
   auto lib = drv.Library();
   if (lib == nullptr) {
@@ -164,26 +181,23 @@ ${func.get('type')} __zecall special_${func.get('name')}(
   %endif
   %if func.get('component') != 'ze_gits_extension':
   bool call_orig = true;
-  if (Configurator::Get().common.shared.useEvents) {
+  if (hooks.Exists(HOOK_${func.get('name')})) {
     std::unique_lock<std::recursive_mutex> lock(luaMutex);
     if (!bypass_luascript) {
       auto L = CGits::Instance().GetLua().get();
-      bool exists = FunctionExists("${func.get('name')}", L);
-      if (exists) {
-        LOG_TRACE_RAW << " Lua begin" << std::endl;
-        lua_getglobal(L, "${func.get('name')}");
-      %for arg in func['args']:
-        lua_push_ext(L, ${get_arg_name(arg['name'])});
-      %endfor
-        if (lua_pcall(L, ${len(func['args'])}, 1, 0) != 0) {
-          RaiseHookError("${func.get('name')}", L);
-        }
-        call_orig = false;
-        const auto top = lua_gettop(L);
-        ret = lua_to_ext<${func.get('type')}>(L, top);
-        lua_pop(L, top);
-        LOG_TRACE_RAW << "${name}" << " Lua End = " << ToStringHelper(ret) << std::endl;
+      LOG_TRACE_RAW << " Lua begin" << std::endl;
+      hooks.Push(L, HOOK_${func.get('name')});
+    %for arg in func['args']:
+      lua_push_ext(L, ${get_arg_name(arg['name'])});
+    %endfor
+      if (lua_pcall(L, ${len(func['args'])}, 1, 0) != 0) {
+        RaiseHookError("${func.get('name')}", L);
       }
+      call_orig = false;
+      const auto top = lua_gettop(L);
+      ret = lua_to_ext<${func.get('type')}>(L, top);
+      lua_pop(L, top);
+      LOG_TRACE_RAW << "${name}" << " Lua End = " << ToStringHelper(ret) << std::endl;
     }
   }
   if (call_orig) {
@@ -316,6 +330,7 @@ void RegisterLuaDriverFunctions() {
   auto L = CGits::Instance().GetLua();
   luaL_newlib(L.get(), exports);
   lua_setglobal(L.get(), "drvl0");
+  hooks.Resolve(L.get());
 }
 } // namespace
 
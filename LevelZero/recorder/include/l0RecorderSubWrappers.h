@@ -28,6 +28,7 @@
 #include "recorder.h"
 #include "l0StateRestore.h"
 #include <cstdint>
+#include <set>
 #include <string>
 #include <vector>
 #include <future>
@@ -179,6 +180,71 @@ void SaveKernelArgumentsForStateRestore(CStateDynamic& sd,
   }
   driver.inject.zeCommandListAppendBarrier(hCommandList, nullptr, numEvents, waitList);
 }
+// Returns the allocations a kernel can access: its buffer arguments, the
+// allocations resident in its context or of a memory type it accesses
+// indirectly and, transitively, the allocations pointed to from the offsets
+// found by the indirect pointers scan.
+std::set<void*> GetAllocationsReachableFromKernel(CStateDynamic& sd,
+                                                  const CDriver& driver,
+                                                  const CKernelExecutionInfo& kernelInfo) {
+  std::set<void*> reachable;
+  std::vector<void*> toVisit;
+  const auto visit = [&](const void* ptr) {
+    const auto allocInfo = GetAllocFromRegion(const_cast<void*>(ptr), sd);
+    if (allocInfo.first != nullptr && reachable.insert(allocInfo.first).second) {
+      toVisit.push_back(allocInfo.first);
+    }
+  };
+
+  for (const auto& arg : kernelInfo.GetArguments()) {
+    if (arg.second.type == KernelArgType::buffer) {
+      visit(arg.second.argValue);
+    }
+  }
+  const auto hModule = sd.Get<CKernelState>(kernelInfo.handle, EXCEPTION_MESSAGE).hModule;
+  const auto kernelContext = sd.Get<CModuleState>(hModule, EXCEPTION_MESSAGE).hContext;
+  for (const auto& allocState : sd.Map<CAllocState>()) {
+    const auto isResidencySet = allocState.second->residencyInfo &&
+                                allocState.second->residencyInfo->hContext == kernelContext;
+    const auto isIndirectionSet =
+        (static_cast<unsigned>(allocState.second->memType) & kernelInfo.indirectUsmTypes) != 0U;
+    if (isResidencySet || isIndirectionSet) {
+      visit(allocState.first);
+    }
+  }
+
+  while (!toVisit.empty()) {
+    void* ptr = toVisit.back();
+    toVisit.pop_back();
+    const auto& allocState = sd.Get<CAllocState>(ptr, EXCEPTION_MESSAGE);
+    if (allocState.allocType != AllocStateType::pointer &&
+        allocState.allocType != AllocStateType::global_pointer) {
+      continue;
+    }
+    for (const auto& indirectOffset : allocState.indirectPointersOffsets) {
+      if (indirectOffset.first + sizeof(void*) > allocState.size) {
+        continue;
+      }
+      const void* pointerLocation = GetOffsetPointer(ptr, indirectOffset.first);
+      void* pointer = nullptr;
+      if (allocState.memType == UnifiedMemoryType::device) {
+        const auto commandList = GetCommandListImmediate(sd, driver, allocState.hContext);
+        if (driver.inject.zeCommandListAppendMemoryCopy(commandList, &pointer, pointerLocation,
+                                                        sizeof(pointer), nullptr, 0,
+                                                        nullptr) != ZE_RESULT_SUCCESS) {
+          continue;
+        }
+      } else {
+        std::memcpy(&pointer, pointerLocation, sizeof(pointer));
+      }
+      visit(pointer);
+    }
+  }
+  return reachable;
+}
+// Snapshots, before the kernel runs, the memory it can access that no earlier
+// kernel of the subcapture range could. Memory out of reach of every kernel in
+// the range keeps its contents and is read back at state restore instead.
 void SaveAllBuffersForStateRestore(CStateDynamic& sd,
                                    const CDriver& driver,
                                    const ze_kernel_handle_t& hKernel,
@@ -186,28 +252,38 @@ void SaveAllBuffersForStateRestore(CStateDynamic& sd,
                                    const uint32_t numEvents,
                                    ze_event_handle_t* waitList) {
   auto& kernelState = sd.Get<CKernelState>(hKernel, EXCEPTION_MESSAGE);
-  auto& stateRestoreBuffersSnapshot = kernelState.currentKernelInfo->stateRestoreBuffers;
-  for (const auto& allocState : sd.Map<CAllocState>()) {
-    if (!allocState.second->savedForStateRestore) {
+  auto& kernelInfo = *kernelState.currentKernelInfo;
+  auto& stateRestoreBuffersSnapshot = kernelInfo.stateRestoreBuffers;
+  const auto snapshotsCount = stateRestoreBuffersSnapshot.size();
+  for (auto* ptr : GetAllocationsReachableFromKernel(sd, driver, kernelInfo)) {
+    auto& allocState = sd.Get<CAllocState>(ptr, EXCEPTION_MESSAGE);
+    if (!allocState.savedForStateRestore) {
       stateRestoreBuffersSnapshot.emplace_back(
-          std::make_unique<CKernelArgument>(allocState.second->size, allocState.first));
+          std::make_unique<CKernelArgument>(allocState.size, ptr));
       driver.inject.zeCommandListAppendMemoryCopy(
-          hCommandList, stateRestoreBuffersSnapshot.back()->buffer.data(), allocState.first,
-          allocState.second->size, nullptr, numEvents, waitList);
-      allocState.second->savedForStateRestore = true;
+          hCommandList, stateRestoreBuffersSnapshot.back()->buffer.data(), ptr, allocState.size,
+          nullptr, numEvents, waitList);
+      allocState.savedForStateRestore = true;
     }
   }
-  for (const auto& imageState : sd.Map<CImageState>()) {
-    if (!imageState.second->savedForStateRestore) {
-      stateRestoreBuffersSnapshot.emplace_back(std::make_unique<CKernelArgument>(
-          CalculateImageSize(imageState.second->desc), imageState.first));
+  for (const auto& arg : kernelInfo.GetArguments()) {
+    if (arg.second.type != KernelArgType::image) {
+      continue;
+    }
+    auto hImage = reinterpret_cast<ze_image_handle_t>(const_cast<void*>(arg.second.argValue));
+    auto& imageState = sd.Get<CImageState>(hImage, EXCEPTION_MESSAGE);
+    if (!imageState.savedForStateRestore) {
+      stateRestoreBuffersSnapshot.emplace_back(
+          std::make_unique<CKernelArgument>(CalculateImageSize(imageState.desc), hImage));
       driver.inject.zeCommandListAppendImageCopyToMemory(
-          hCommandList, stateRestoreBuffersSnapshot.back()->buffer.data(), imageState.first,
-          nullptr, nullptr, numEvents, waitList);
-      imageState.second->savedForStateRestore = true;
+          hCommandList, stateRestoreBuffersSnapshot.back()->buffer.data(), hImage, nullptr,
+          nullptr, numEvents, waitList);
+      imageState.savedForStateRestore = true;
     }
   }
-  driver.inject.zeCommandListAppendBarrier(hCommandList, nullptr, numEvents, waitList);
+  if (stateRestoreBuffersSnapshot.size() != snapshotsCount) {
+    driver.inject.zeCommandListAppendBarrier(hCommandList, nullptr, numEvents, waitList);
+  }
 }
 std::vector<ze_command_list_handle_t> GetCommandListsToSubcapture(
     bool isRecorderRunning,
@@ -25,6 +25,21 @@ namespace gits {
 namespace OpenCL {
 namespace {
 static bool bypass_luascript;
+
+enum HookId : unsigned {
+%for name, func in without_field(functions, 'version').items():
+  HOOK_${name},
+%endfor
+  HOOKS_COUNT
+};
+
+const char* const hookNames[] = {
+%for name, func in without_field(functions, 'version').items():
+    "${name}",
+%endfor
+};
+
+HookTable hooks(hookNames, HOOKS_COUNT);
 } // namespace
 %for name, func in without_field(functions, 'version').items():
 int lua_${name}(lua_State* L) {
@@ -51,29 +66,26 @@ ${get_return_type(func)} STDCALL special_${name}(${make_params(func, with_types=
     LOG_TRACE_RAW << ")${'\\n' if func['type'] == 'void' else ''}";
   }
   bool call_orig = true;
-  if (Configurator::Get().common.shared.useEvents) {
+  if (hooks.Exists(HOOK_${name})) {
     std::unique_lock<std::recursive_mutex> lock(gits::lua::luaMutex);
     if (!bypass_luascript) {
       auto L = GetLuaState();
-      bool exists = lua::FunctionExists("${name}", L);
-      if (exists || !doTrace) {
-        if(doTrace) {
-          LOG_TRACE_RAW << " Lua Begin" << std::endl;
-        }
-        lua_getglobal(L, "${name}");
-        ArgsPusher ap(L);
-        ap.push(${make_params(func, one_line=True)});
-        call_orig = false;
-        if (lua_pcall(L, ${len(func['args'])}, 1, 0) != 0) {
-          RaiseHookError("${name}", L);
-        }
-        int top = lua_gettop(L);
-        gits_ret = lua::lua_to<${get_return_type(func)}>(L, top);
-        lua_pop(L, top);
-        if (doTrace) {
-          LOG_TRACE_RAW << "${name}" << " Lua End";
-          Tracer::TraceRet(gits_ret);
-        }
+      if (doTrace) {
+        LOG_TRACE_RAW << " Lua Begin" << std::endl;
+      }
+      hooks.Push(L, HOOK_${name});
+      ArgsPusher ap(L);
+      ap.push(${make_params(func, one_line=True)});
+      call_orig = false;
+      if (lua_pcall(L, ${len(func['args'])}, 1, 0) != 0) {
+        RaiseHookError("${name}", L);
+      }
+      int top = lua_gettop(L);
+      gits_ret = lua::lua_to<${get_return_type(func)}>(L, top);
+      lua_pop(L, top);
+      if (doTrace) {
+        LOG_TRACE_RAW << "${name}" << " Lua End";
+        Tracer::TraceRet(gits_ret);
       }
     }
   }
@@ -99,7 +111,7 @@ ${get_return_type(func)} STDCALL default_${name}(${make_params(func, with_types=
   }
   drvOcl.orig_${name} = drvOcl.${name};
   if ((gits::log::ShouldLog(LogLevel::TRACE)) ||
-      (Configurator::Get().common.shared.useEvents && LUA_FUNCTION_EXISTS("${name}")) ||
+      hooks.Exists(HOOK_${name}) ||
       (!Configurator::Get().common.player.traceSelectedFrames.empty())) {
     drvOcl.${name} = special_${name};
   }
@@ -124,6 +136,7 @@ void RegisterLuaDriverFunctions() {
   auto L = CGits::Instance().GetLua();
   luaL_newlib(L.get(), exports);
   lua_setglobal(L.get(), "drvCl");
+  hooks.Resolve(L.get());
 }
 
 COclDriver::COclDriver() : _initialized(false), _lib(nullptr) {
@@ -134,8 +134,6 @@ static NOINLINE lua_State* GetLuaState() {
   return CGits::Instance().GetLua().get();
 }
 
-#define LUA_FUNCTION_EXISTS(function) lua::FunctionExists(function, GetLuaState())
-
 int export_CLStatusToStr(lua_State* L) {
   int top = lua_gettop(L);
   if (top != 1) {
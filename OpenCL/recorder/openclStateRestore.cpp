@@ -21,6 +21,9 @@
 #include "recorder.h"
 #include "openclHelperFunctions.h"
 
+#include <deque>
+#include <utility>
+
 namespace gits {
 namespace OpenCL {
 namespace {
@@ -116,62 +119,142 @@ void RestoreSubBuffer(gits::CScheduler& scheduler,
                                             nullptr));
 }
 
-void RestoreBuffer(gits::CScheduler& scheduler,
-                   const cl_mem& memObj,
-                   std::shared_ptr<CCLMemState>& state,
-                   const cl_command_queue& commandQueue) {
-  std::vector<char> buffer(state->size);
+// Host memory that mem object contents read back by RestoreMemObjects may occupy at
+// once.  Reads are issued ahead of token registration up to this limit, so device to
+// host transfers overlap with writing earlier objects to the stream.
+constexpr size_t memObjectReadBudget = 256 * 1024 * 1024;
+
+// A mem object being restored whose contents may still be in flight from the device.
+struct MemObjectRestore {
+  cl_mem memObj = nullptr;
+  std::shared_ptr<CCLMemState> state;
+  cl_command_queue commandQueue = nullptr;
+  std::vector<char> contents;
+  cl_event readEvent = nullptr;
+
+  MemObjectRestore(const cl_mem& mem,
+                   std::shared_ptr<CCLMemState>& memState,
+                   const cl_command_queue& queue)
+      : memObj(mem), state(memState), commandQueue(queue) {}
+  // Moving keeps the contents allocation, so a read in flight stays valid.
+  MemObjectRestore(MemObjectRestore&& other) noexcept
+      : memObj(other.memObj),
+        state(std::move(other.state)),
+        commandQueue(other.commandQueue),
+        contents(std::move(other.contents)),
+        readEvent(std::exchange(other.readEvent, nullptr)) {}
+  MemObjectRestore(const MemObjectRestore&) = delete;
+  MemObjectRestore& operator=(const MemObjectRestore&) = delete;
+  MemObjectRestore& operator=(MemObjectRestore&&) = delete;
+  // The device must not write into freed contents, e.g. when restore throws.
+  ~MemObjectRestore() {
+    WaitForContents();
+  }
+
+  bool HasContents() const {
+    return ResourceExists(state->context) && (state->buffer || state->image);
+  }
+
+  // Enqueues a non-blocking read of the whole object.  If it cannot be enqueued the
+  // contents stay zero-filled, as they did when a blocking read failed.
+  void ReadContents() {
+    contents.resize(state->size);
+    cl_int err = CL_SUCCESS;
+    if (state->buffer) {
+      err = drvOcl.clEnqueueReadBuffer(commandQueue, memObj, CL_FALSE, 0, state->size,
+                                       contents.data(), 0, nullptr, &readEvent);
+    } else {
+      size_t origin[3] = {0, 0, 0};
+      size_t region[3];
+      GetRegionForWholeImage(state->image_desc, region);
+      err = drvOcl.clEnqueueReadImage(commandQueue, memObj, CL_FALSE, origin, region,
+                                      state->image_desc.image_row_pitch,
+                                      state->image_desc.image_slice_pitch, contents.data(), 0,
+                                      nullptr, &readEvent);
+    }
+    if (err != CL_SUCCESS) {
+      readEvent = nullptr;
+      return;
+    }
+    drvOcl.clFlush(commandQueue);
+  }
+
+  void WaitForContents() {
+    if (readEvent == nullptr) {
+      return;
+    }
+    drvOcl.clWaitForEvents(1, &readEvent);
+    drvOcl.clReleaseEvent(readEvent);
+    readEvent = nullptr;
+  }
+};
+
+void RestoreBuffer(gits::CScheduler& scheduler, MemObjectRestore& restore) {
+  auto& state = restore.state;
+  std::vector<char>& buffer = restore.contents;
   void* bufferPtr = nullptr;
-  drvOcl.clEnqueueReadBuffer(commandQueue, memObj, CL_TRUE, 0, state->size, buffer.data(), 0,
-                             nullptr, nullptr);
   if ((state->flags & (CL_MEM_COPY_HOST_PTR | CL_MEM_USE_HOST_PTR)) != 0U) {
     bufferPtr = buffer.data();
   }
   if (state->intel_mem_properties.empty()) {
-    scheduler.Register(
-        new CclCreateBuffer(memObj, state->context, state->flags, state->size, bufferPtr, nullptr));
+    scheduler.Register(new CclCreateBuffer(restore.memObj, state->context, state->flags,
+                                           state->size, bufferPtr, nullptr));
   } else {
     scheduler.Register(new CclCreateBufferWithPropertiesINTEL(
-        memObj, state->context, &state->intel_mem_properties[0], state->flags, state->size,
-        bufferPtr, nullptr));
+        restore.memObj, state->context, &state->intel_mem_properties[0], state->flags,
+        state->size, bufferPtr, nullptr));
   }
   if (bufferPtr == nullptr) {
-    scheduler.Register(new CclEnqueueWriteBuffer(CL_SUCCESS, commandQueue, memObj, CL_TRUE, 0,
-                                                 state->size, buffer.data(), 0, nullptr, nullptr));
+    scheduler.Register(new CclEnqueueWriteBuffer(CL_SUCCESS, restore.commandQueue, restore.memObj,
+                                                 CL_TRUE, 0, state->size, buffer.data(), 0,
+                                                 nullptr, nullptr));
   }
 }
 
-void RestoreImage(CScheduler& scheduler,
-                  const cl_mem& memObj,
-                  std::shared_ptr<CCLMemState>& state,
-                  const cl_command_queue& commandQueue) {
-  std::vector<char> buffer(state->size);
+void RestoreImage(CScheduler& scheduler, MemObjectRestore& restore) {
+  auto& state = restore.state;
+  std::vector<char>& buffer = restore.contents;
   void* bufferPtr = nullptr;
   size_t origin[3] = {0, 0, 0};
   size_t region[3];
   GetRegionForWholeImage(state->image_desc, region);
-  drvOcl.clEnqueueReadImage(commandQueue, memObj, CL_TRUE, origin, region,
-                            state->image_desc.image_row_pitch, state->image_desc.image_slice_pitch,
-                            buffer.data(), 0, nullptr, nullptr);
   if ((state->flags & (CL_MEM_COPY_HOST_PTR | CL_MEM_USE_HOST_PTR)) != 0U) {
     bufferPtr = buffer.data();
   }
   if (state->intel_mem_properties.empty()) {
-    scheduler.Register(new CclCreateImage(memObj, state->context, state->flags,
+    scheduler.Register(new CclCreateImage(restore.memObj, state->context, state->flags,
                                           &state->image_format, &state->image_desc, bufferPtr,
                                           nullptr));
   } else {
     scheduler.Register(new CclCreateImageWithPropertiesINTEL(
-        memObj, state->context, &state->intel_mem_properties[0], state->flags, &state->image_format,
-        &state->image_desc, bufferPtr, nullptr));
+        restore.memObj, state->context, &state->intel_mem_properties[0], state->flags,
+        &state->image_format, &state->image_desc, bufferPtr, nullptr));
   }
   if (bufferPtr == nullptr) {
-    scheduler.Register(new CclEnqueueWriteImage(CL_SUCCESS, commandQueue, memObj, CL_TRUE, origin,
-                                                region, state->image_desc.image_row_pitch,
-                                                state->image_desc.image_slice_pitch, buffer.data(),
-                                                0, nullptr, nullptr));
+    scheduler.Register(new CclEnqueueWriteImage(
+        CL_SUCCESS, restore.commandQueue, restore.memObj, CL_TRUE, origin, region,
+        state->image_desc.image_row_pitch, state->image_desc.image_slice_pitch, buffer.data(), 0,
+        nullptr, nullptr));
   }
 }
+
+// Registers the tokens of a mem object whose contents, if any, have been read.
+void FinishMemObjectRestore(CScheduler& scheduler, MemObjectRestore& restore) {
+  auto& state = restore.state;
+  if (state->context == nullptr && !state->buffer && !state->image) {
+    RestoreSubBuffer(scheduler, restore.memObj, state);
+  } else if (restore.HasContents() && state->buffer) {
+    RestoreBuffer(scheduler, restore);
+  } else if (restore.HasContents() && state->image) {
+    RestoreImage(scheduler, restore);
+  }
+  // Adjust refcount
+  cl_uint refCount = state->GetRefCount();
+  for (cl_uint i = 1; i < refCount; i++) {
+    scheduler.Register(new CclRetainMemObject(CL_SUCCESS, restore.memObj));
+  }
+  state->RestoreFinished();
+}
 } // namespace
 } // namespace OpenCL
 } // namespace gits
@@ -273,20 +356,12 @@ void gits::OpenCL::RestoreMemObject(CScheduler& scheduler,
                                     const cl_mem& memObj,
                                     std::shared_ptr<CCLMemState>& state,
                                     const cl_command_queue& commandQueue) {
-  const auto contextExists = ResourceExists(state->context);
-  if (state->context == nullptr && !state->buffer && !state->image) {
-    RestoreSubBuffer(scheduler, memObj, state);
-  } else if (contextExists && state->buffer) {
-    RestoreBuffer(scheduler, memObj, state, commandQueue);
-  } else if (contextExists && state->image) {
-    RestoreImage(scheduler, memObj, state, commandQueue);
-  }
-  // Adjust refcount
-  cl_uint refCount = state->GetRefCount();
-  for (cl_uint i = 1; i < refCount; i++) {
-    scheduler.Register(new CclRetainMemObject(CL_SUCCESS, memObj));
+  MemObjectRestore restore(memObj, state, commandQueue);
+  if (restore.HasContents()) {
+    restore.ReadContents();
+    restore.WaitForContents();
   }
-  state->RestoreFinished();
+  FinishMemObjectRestore(scheduler, restore);
 }
 
 void gits::OpenCL::RestoreMemObjects(CScheduler& scheduler, CStateDynamic& sd) {
@@ -299,13 +374,43 @@ void gits::OpenCL::RestoreMemObjects(CScheduler& scheduler, CStateDynamic& sd) {
     }
   } customCompare;
   std::sort(memStates.begin(), memStates.end(), customCompare);
+
+  // Contents are read without blocking, up to memObjectReadBudget ahead, and each
+  // object's tokens are registered in the original order once its read completes.
+  std::deque<MemObjectRestore> inFlight;
+  size_t inFlightBytes = 0;
+  const auto finishOldest = [&]() {
+    MemObjectRestore& oldest = inFlight.front();
+    oldest.WaitForContents();
+    inFlightBytes -= oldest.contents.size();
+    FinishMemObjectRestore(scheduler, oldest);
+    inFlight.pop_front();
+  };
   for (auto& state : memStates) {
     if (state.second->pipe) {
       throw gits::ENotImplemented("Subcaptures with pipe objects are not implemented");
     }
+    // Creating a queue registers a token, which must follow every earlier object's.
+    const auto context = state.second->context;
+    if (context && commandQueuesContext.find(context) == commandQueuesContext.end()) {
+      while (!inFlight.empty()) {
+        finishOldest();
+      }
+    }
     // Create command queue to sync data
-    const auto& commandQueue = GetCommandQueue(scheduler, sd, nullptr, state.second->context);
-    RestoreMemObject(scheduler, state.first, state.second, commandQueue);
+    const auto& commandQueue = GetCommandQueue(scheduler, sd, nullptr, context);
+    MemObjectRestore restore(state.first, state.second, commandQueue);
+    if (restore.HasContents()) {
+      while (!inFlight.empty() && inFlightBytes + state.second->size > memObjectReadBudget) {
+        finishOldest();
+      }
+      restore.ReadContents();
+      inFlightBytes += restore.contents.size();
+    }
+    inFlight.push_back(std::move(restore));
+  }
+  while (!inFlight.empty()) {
+    finishOldest();
   }
 }
 
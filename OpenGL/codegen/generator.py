@@ -8497,7 +8497,7 @@ function(name='glBindTransformFeedback', enabled=True, function_type=FuncType.BI
 
 function(name='glBindTransformFeedbackNV', enabled=True, function_type=FuncType.BIND, inherit_from='glBindTransformFeedback')
 
-function(name='glBindVertexArray', enabled=True, function_type=FuncType.BIND,
+function(name='glBindVertexArray', enabled=True, function_type=FuncType.BIND, state_track=True,
     return_value=ReturnValue(type='void'),
     args=[
         Argument(name='array', type='GLuint', wrap_type='CGLVertexArray'),
@@ -8513,7 +8513,7 @@ function(name='glBindVertexArrayAPPLE', enabled=False, function_type=FuncType.BI
 
 function(name='glBindVertexArrayOES', enabled=True, function_type=FuncType.BIND, inherit_from='glBindVertexArray')
 
-function(name='glBindVertexBuffer', enabled=True, function_type=FuncType.BIND,
+function(name='glBindVertexBuffer', enabled=True, function_type=FuncType.BIND, state_track=True,
     return_value=ReturnValue(type='void'),
     args=[
         Argument(name='bindingindex', type='GLuint'),
@@ -10612,7 +10612,7 @@ function(name='glConvolutionParameterxvOES', enabled=False, function_type=FuncTy
     ],
 )
 
-function(name='glCopyBufferSubData', enabled=True, function_type=FuncType.COPY,
+function(name='glCopyBufferSubData', enabled=True, function_type=FuncType.COPY, state_track=True,
     return_value=ReturnValue(type='void'),
     args=[
         Argument(name='readTarget', type='GLenum'),
@@ -10778,7 +10778,7 @@ function(name='glCopyMultiTexSubImage3DEXT', enabled=True, function_type=FuncTyp
     ],
 )
 
-function(name='glCopyNamedBufferSubData', enabled=True, function_type=FuncType.COPY,
+function(name='glCopyNamedBufferSubData', enabled=True, function_type=FuncType.COPY, state_track=True,
     return_value=ReturnValue(type='void'),
     args=[
         Argument(name='readBuffer', type='GLuint', wrap_type='CGLBuffer'),
@@ -12721,7 +12721,7 @@ function(name='glEndTilingQCOM', enabled=True, function_type=FuncType.PARAM,
     ],
 )
 
-function(name='glEndTransformFeedback', enabled=True, function_type=FuncType.PARAM,
+function(name='glEndTransformFeedback', enabled=True, function_type=FuncType.PARAM, state_track=True,
     return_value=ReturnValue(type='void'),
     args=[],
 )
@@ -19887,7 +19887,7 @@ function(name='glMaxShaderCompilerThreadsKHR', enabled=False, function_type=Func
     ],
 )
 
-function(name='glMemoryBarrier', enabled=True, function_type=FuncType.PARAM,
+function(name='glMemoryBarrier', enabled=True, function_type=FuncType.PARAM, state_track=True,
     return_value=ReturnValue(type='void'),
     args=[
         Argument(name='barriers', type='GLbitfield'),
@@ -21302,7 +21302,7 @@ function(name='glNamedBufferSubData', enabled=True, function_type=FuncType.RESOU
 
 function(name='glNamedBufferSubDataEXT', enabled=True, function_type=FuncType.RESOURCE, inherit_from='glNamedBufferSubData')
 
-function(name='glNamedCopyBufferSubDataEXT', enabled=True, function_type=FuncType.COPY,
+function(name='glNamedCopyBufferSubDataEXT', enabled=True, function_type=FuncType.COPY, state_track=True,
     return_value=ReturnValue(type='void'),
     args=[
         Argument(name='readBuffer', type='GLuint', wrap_type='CGLBuffer'),
@@ -30272,7 +30272,7 @@ function(name='glVertexArrayVertexAttribLOffsetEXT', enabled=True, function_type
     ],
 )
 
-function(name='glVertexArrayVertexAttribOffsetEXT', enabled=True, function_type=FuncType.PARAM,
+function(name='glVertexArrayVertexAttribOffsetEXT', enabled=True, function_type=FuncType.PARAM, state_track=True,
     return_value=ReturnValue(type='void'),
     args=[
         Argument(name='vaobj', type='GLuint'),
@@ -30295,7 +30295,7 @@ function(name='glVertexArrayVertexBindingDivisorEXT', enabled=True, function_typ
     ],
 )
 
-function(name='glVertexArrayVertexBuffer', enabled=True, function_type=FuncType.PARAM,
+function(name='glVertexArrayVertexBuffer', enabled=True, function_type=FuncType.PARAM, state_track=True,
     return_value=ReturnValue(type='void'),
     args=[
         Argument(name='vaobj', type='GLuint'),
@@ -8,6 +8,12 @@
 
 #include "clientArrays.h"
 
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <map>
+#include <tuple>
+
 /* ************************* ClientArraysUpdate *********************************** */
 gits::OpenGL::ClientArraysUpdate::ClientArraysUpdate(GLuint index) {
   // VAO check
@@ -79,11 +85,11 @@ gits::OpenGL::ClientArraysUpdate::ClientArraysUpdate(GLenum type,
     return;
   }
 
-  // Dump indices and get sorted list of indices
-  std::set<GLuint> indicesSorted;
+  // Dump indices and get sorted indices ranges
+  CIndicesRanges indicesRanges;
   for (unsigned i = 0; i < primcount; i++) {
     if (count[i] > 0) {
-      DumpIndicesUpdate(buff, type, count[i], indices[i], 0, indicesSorted);
+      DumpIndicesUpdate(buff, type, count[i], indices[i], 0, indicesRanges);
     }
   }
 
@@ -92,8 +98,20 @@ gits::OpenGL::ClientArraysUpdate::ClientArraysUpdate(GLenum type,
     return;
   }
 
+  // Merge ranges of all draws
+  std::sort(indicesRanges.begin(), indicesRanges.end());
+  CIndicesRanges mergedRanges;
+  for (auto& range : indicesRanges) {
+    if (!mergedRanges.empty() &&
+        range.first <= static_cast<uint64_t>(mergedRanges.back().second) + 1) {
+      mergedRanges.back().second = std::max(mergedRanges.back().second, range.second);
+    } else {
+      mergedRanges.push_back(range);
+    }
+  }
+
   // Dump attribs updates in optimized ranges
-  DumpAttribsUpdateOptimized(std::move(indicesSorted), 0, 0);
+  DumpAttribsUpdateOptimized(mergedRanges, 0, 0);
 }
 
 gits::OpenGL::ClientArraysUpdate::ClientArraysUpdate(GLsizei count,
@@ -126,9 +144,9 @@ gits::OpenGL::ClientArraysUpdate::ClientArraysUpdate(GLsizei count,
     return;
   }
 
-  // Dump indices and get sorted list of indices
-  std::set<GLuint> indicesSorted;
-  DumpIndicesUpdate(buff, type, count, indices, basevertex, indicesSorted);
+  // Dump indices and get sorted indices ranges
+  CIndicesRanges indicesRanges;
+  DumpIndicesUpdate(buff, type, count, indices, basevertex, indicesRanges);
 
   // return if attribs stored in buffers
   if (!clientAttribs) {
@@ -136,24 +154,163 @@ gits::OpenGL::ClientArraysUpdate::ClientArraysUpdate(GLsizei count,
   }
 
   // Dump attribs updates in optimized ranges
-  DumpAttribsUpdateOptimized(std::move(indicesSorted), instances, baseinstance);
+  DumpAttribsUpdateOptimized(indicesRanges, instances, baseinstance);
+}
+
+namespace {
+using namespace gits;
+using namespace OpenGL;
+
+typedef std::vector<std::pair<GLuint, GLuint>> CIndicesRanges;
+
+// Indices are marked in a bitmap if its size is comparable to the indices data,
+// otherwise they are sorted.
+const uint64_t BITMAP_MAX_BITS_PER_INDEX = 64;
+const uint64_t BITMAP_MIN_BITS = 65536;
+
+// Max number of indices ranges cached per recording thread
+const size_t INDICES_RANGES_CACHE_SIZE = 256;
+
+struct CCachedIndicesRanges {
+  uint64_t dataVersion = 0;
+  CIndicesRanges ranges;
+};
+
+// Key: indices buffer, offset, type, count, basevertex, restart index, strip
+// index
+typedef std::tuple<GLuint, uint64_t, GLenum, GLuint, GLuint, GLuint, GLuint> TIndicesRangesKey;
+
+std::map<TIndicesRangesKey, CCachedIndicesRanges>& IndicesRangesCache() {
+  thread_local std::map<TIndicesRangesKey, CCachedIndicesRanges> cache;
+  return cache;
+}
+
+// Returns position of the first bit equal to value at or after pos, or size
+// if there is none.
+uint64_t FindBit(const std::vector<uint64_t>& bitmap, uint64_t pos, bool value, uint64_t size) {
+  const uint64_t flip = value ? 0 : ~0ull;
+  uint64_t word = pos / 64;
+  uint64_t bits = (bitmap[word] ^ flip) & (~0ull << (pos % 64));
+  while (bits == 0) {
+    if (++word == bitmap.size()) {
+      return size;
+    }
+    bits = bitmap[word] ^ flip;
+  }
+  return std::min<uint64_t>(word * 64 + std::countr_zero(bits), size);
+}
+
+// Appends sorted, continuous ranges of indices used by a draw
+template <class T>
+void GetIndicesRanges(const T* indices,
+                      GLuint count,
+                      T basevertex,
+                      T restartIndex,
+                      T stripIndex,
+                      CIndicesRanges& ranges) {
+  // Branchless scan, so that compilers can vectorize it
+  T minIndex = std::numeric_limits<T>::max();
+  T maxIndex = 0;
+  GLuint validCount = 0;
+  for (GLuint i = 0; i < count; i++) {
+    const T index = static_cast<T>(indices[i] + basevertex);
+    const bool skip = (index == restartIndex) | (index == stripIndex);
+    minIndex = std::min(minIndex, skip ? std::numeric_limits<T>::max() : index);
+    maxIndex = std::max(maxIndex, skip ? T(0) : index);
+    validCount += skip ? 0 : 1;
+  }
+  if (validCount == 0) {
+    return;
+  }
+
+  const uint64_t span = static_cast<uint64_t>(maxIndex) - minIndex + 1;
+  if (span <= std::max(BITMAP_MIN_BITS, BITMAP_MAX_BITS_PER_INDEX * validCount)) {
+    thread_local std::vector<uint64_t> bitmap;
+    bitmap.assign((span + 63) / 64, 0);
+    for (GLuint i = 0; i < count; i++) {
+      const T index = static_cast<T>(indices[i] + basevertex);
+      if (index == restartIndex || index == stripIndex) {
+        continue;
+      }
+      const uint64_t bit = index - minIndex;
+      bitmap[bit / 64] |= 1ull << (bit % 64);
+    }
+
+    uint64_t begin = FindBit(bitmap, 0, true, span);
+    while (begin < span) {
+      const uint64_t end = FindBit(bitmap, begin, false, span);
+      ranges.emplace_back(static_cast<GLuint>(minIndex + begin),
+                          static_cast<GLuint>(minIndex + end - 1));
+      if (end >= span) {
+        break;
+      }
+      begin = FindBit(bitmap, end, true, span);
+    }
+  } else {
+    thread_local std::vector<T> sorted;
+    sorted.clear();
+    sorted.reserve(validCount);
+    for (GLuint i = 0; i < count; i++) {
+      const T index = static_cast<T>(indices[i] + basevertex);
+      if (index != restartIndex && index != stripIndex) {
+        sorted.push_back(index);
+      }
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    GLuint rangeBegin = sorted.front();
+    GLuint rangeEnd = sorted.front();
+    for (const T index : sorted) {
+      if (index > rangeEnd + static_cast<uint64_t>(1)) {
+        ranges.emplace_back(rangeBegin, rangeEnd);
+        rangeBegin = index;
+      }
+      rangeEnd = index;
+    }
+    ranges.emplace_back(rangeBegin, rangeEnd);
+  }
+}
+
+void GetIndicesRanges(const GLvoid* indices,
+                      GLenum type,
+                      GLuint count,
+                      GLuint basevertex,
+                      GLuint restartIndex,
+                      GLuint stripIndex,
+                      CIndicesRanges& ranges) {
+  switch (type) {
+  case GL_UNSIGNED_BYTE:
+    GetIndicesRanges((const GLubyte*)indices, count, (GLubyte)basevertex, (GLubyte)restartIndex,
+                     (GLubyte)stripIndex, ranges);
+    break;
+  case GL_UNSIGNED_SHORT:
+    GetIndicesRanges((const GLushort*)indices, count, (GLushort)basevertex,
+                     (GLushort)restartIndex, (GLushort)stripIndex, ranges);
+    break;
+  case GL_UNSIGNED_INT:
+    GetIndicesRanges((const GLuint*)indices, count, basevertex, restartIndex, stripIndex, ranges);
+    break;
+  }
 }
+} // namespace
 
 void gits::OpenGL::ClientArraysUpdate::DumpIndicesUpdate(GLuint buff,
                                                          GLenum type,
                                                          GLuint count,
                                                          const GLvoid* indices,
                                                          GLuint basevertex,
-                                                         std::set<GLuint>& sorted) {
+                                                         CIndicesRanges& ranges) {
   // Get pointer to indices data from client side or mapped buffer
-  const GLvoid* indicesPtr;
   std::shared_ptr<MapBuffer> buffMap;
-  if (buff != 0) {
-    buffMap.reset(new MapBuffer(GL_ELEMENT_ARRAY_BUFFER, buff));
-    indicesPtr = (GLvoid*)((uintptr_t)buffMap->Data() + (uintptr_t)indices);
-  } else {
-    indicesPtr = indices;
-  }
+  auto indicesPtr = [&]() -> const GLvoid* {
+    if (buff == 0) {
+      return indices;
+    }
+    if (!buffMap) {
+      buffMap.reset(new MapBuffer(GL_ELEMENT_ARRAY_BUFFER, buff));
+    }
+    return (GLvoid*)((uintptr_t)buffMap->Data() + (uintptr_t)indices);
+  };
 
   // Support for GL_PRIMITIVE_RESTART and STRIP INDEX options
   GLuint stripIndex = Configurator::Get().opengl.recorder.stripIndicesValues;
@@ -162,55 +319,50 @@ void gits::OpenGL::ClientArraysUpdate::DumpIndicesUpdate(GLuint buff,
     restartIndex = SD().GetCurrentContextStateData().restartIndexValue;
   }
 
-  // Read indices
   uint64_t indicesDataSize;
   switch (type) {
-  case GL_UNSIGNED_BYTE: {
+  case GL_UNSIGNED_BYTE:
     indicesDataSize = sizeof(GLubyte) * count;
-
-    auto indexPtr = (GLubyte*)indicesPtr;
-    for (unsigned i = 0; i < count; i++, indexPtr++) {
-      GLubyte index = *indexPtr + (GLubyte)basevertex;
-      if ((GLubyte)restartIndex == index || (GLubyte)stripIndex == index) {
-        continue;
-      }
-      sorted.insert((GLuint)index);
-    }
     break;
-  }
-  case GL_UNSIGNED_SHORT: {
+  case GL_UNSIGNED_SHORT:
     indicesDataSize = sizeof(GLushort) * count;
-
-    auto indexPtr = (GLushort*)indicesPtr;
-    for (unsigned i = 0; i < count; i++, indexPtr++) {
-      GLushort index = *indexPtr + (GLushort)basevertex;
-      if ((GLushort)restartIndex == index || (GLushort)stripIndex == index) {
-        continue;
-      }
-      sorted.insert((GLuint)index);
-    }
     break;
-  }
-  case GL_UNSIGNED_INT: {
+  case GL_UNSIGNED_INT:
     indicesDataSize = sizeof(GLuint) * count;
-
-    auto indexPtr = (GLuint*)indicesPtr;
-    for (unsigned i = 0; i < count; i++, indexPtr++) {
-      GLuint index = *indexPtr + basevertex;
-      if ((GLuint)restartIndex == index || (GLuint)stripIndex == index) {
-        continue;
-      }
-      sorted.insert((GLuint)index);
-    }
     break;
-  }
   default:
     throw std::runtime_error(EXCEPTION_MESSAGE);
   }
 
+  // Indices ranges of buffer objects are cached per indices location until the
+  // buffer is written, so the buffer is not mapped on a hit.  Client memory and
+  // persistently mapped buffers may be written at any time, so their ranges are
+  // always computed.
+  CBufferStateObj* buffState =
+      buff != 0 ? SD().GetCurrentSharedStateData().Buffers().Get(buff) : nullptr;
+  if (buffState == nullptr || (buffState->Flags() & GL_MAP_PERSISTENT_BIT)) {
+    GetIndicesRanges(indicesPtr(), type, count, basevertex, restartIndex, stripIndex, ranges);
+  } else {
+    auto& cache = IndicesRangesCache();
+    const TIndicesRangesKey key(buff, (uint64_t)indices, type, count, basevertex, restartIndex,
+                                stripIndex);
+    if (cache.size() >= INDICES_RANGES_CACHE_SIZE && cache.find(key) == cache.end()) {
+      cache.clear();
+    }
+    auto& cached = cache[key];
+    const uint64_t dataVersion = buffState->DataVersion();
+    if (cached.ranges.empty() || cached.dataVersion != dataVersion) {
+      cached.dataVersion = dataVersion;
+      cached.ranges.clear();
+      GetIndicesRanges(indicesPtr(), type, count, basevertex, restartIndex, stripIndex,
+                       cached.ranges);
+    }
+    ranges.insert(ranges.end(), cached.ranges.begin(), cached.ranges.end());
+  }
+
   // Dump indices data diff
   if (buff == 0) {
-    _update.Diff((uint64_t)indicesPtr, (uint64_t)indicesPtr, indicesDataSize);
+    _update.Diff((uint64_t)indices, (uint64_t)indices, indicesDataSize);
   }
 }
 
@@ -438,29 +590,11 @@ void gits::OpenGL::ClientArraysUpdate::DumpAttribsUpdate(GLuint frontindex,
 }
 
 // Dump attribs data memory updates optimized
-void gits::OpenGL::ClientArraysUpdate::DumpAttribsUpdateOptimized(std::set<GLuint> indices,
+void gits::OpenGL::ClientArraysUpdate::DumpAttribsUpdateOptimized(const CIndicesRanges& ranges,
                                                                   GLuint instances,
                                                                   GLuint baseinstance) {
-  // Get continuous indices ranges and dump attribs data diff for those ranges
-  GLuint rangeBegin = 0;
-  GLuint rangeEnd = 0;
-  for (auto index = indices.begin(); index != indices.end(); index++) {
-    if (index == indices.begin()) {
-      rangeBegin = *index;
-      rangeEnd = *index;
-    } else {
-      // Check range end - dump indices data
-      if (rangeEnd < *index - 1) {
-        DumpAttribsUpdate(rangeBegin, rangeEnd, instances, baseinstance);
-        rangeBegin = *index;
-      }
-
-      // Check indices end - dump attribs data
-      if (*index == *indices.rbegin()) {
-        DumpAttribsUpdate(rangeBegin, *index, instances, baseinstance);
-      }
-
-      rangeEnd = *index;
-    }
+  // Dump attribs data diff for continuous indices ranges
+  for (const auto& range : ranges) {
+    DumpAttribsUpdate(range.first, range.second, instances, baseinstance);
   }
 }
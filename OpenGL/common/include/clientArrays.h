@@ -18,6 +18,8 @@ namespace OpenGL {
 
 // Class responsible for storing and applying client arrays updates
 class ClientArraysUpdate : public CArgument {
+  // Sorted, disjoint and non-adjacent [first, last] indices ranges
+  typedef std::vector<std::pair<GLuint, GLuint>> CIndicesRanges;
   CDataUpdate _update;
   // Returns true if any attrib comes from client side
   bool CheckClientAttribs();
@@ -32,10 +34,12 @@ class ClientArraysUpdate : public CArgument {
                          GLuint count,
                          const GLvoid* indices,
                          GLuint basevertex,
-                         std::set<GLuint>& sorted);
+                         CIndicesRanges& ranges);
   // Dumps indices attribs data memory in continous indices ranges. It uses
   // DumpAttribsUpdate under the hood.
-  void DumpAttribsUpdateOptimized(std::set<GLuint> indices, GLuint instances, GLuint baseinstance);
+  void DumpAttribsUpdateOptimized(const CIndicesRanges& ranges,
+                                  GLuint instances,
+                                  GLuint baseinstance);
 
 public:
   ClientArraysUpdate() {}
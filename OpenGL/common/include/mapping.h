@@ -191,9 +191,8 @@ public:
       return Type(0);
     }
 
-    auto& the_map = get_map();
-    auto iter = the_map.find(key);
-    if (iter == the_map.end()) {
+    auto* value = get_map().find(key);
+    if (value == nullptr) {
       std::optional<Type> foundElsewhere = handleFBOExtMixing<MapObjectId, Type>(key);
       if (foundElsewhere) {
         return foundElsewhere.value();
@@ -203,7 +202,7 @@ public:
       return (Type)gl_name_cast<typename ptr_to_void<Type>::type>(1000000);
     }
 
-    return iter->second;
+    return *value;
   }
 
   static void GetMapping(const Type* keys, Type* values, size_t num) {
@@ -226,8 +225,7 @@ public:
         (identity<Traits::nezero>() && key == Type(0))) {
       return true;
     }
-    auto& the_map = get_map();
-    return the_map.find(key) != the_map.end();
+    return get_map().contains(key);
   }
 
   bool CheckMapping() {
@@ -278,8 +276,8 @@ public:
   }
 
 private:
-  typedef std::unordered_map<Type, Type> name_map_t;
-  typedef std::unordered_map<unsigned int, name_map_t> group_maps_t;
+  typedef DenseNameMap<Type> name_map_t;
+  typedef SharedGroupMaps<name_map_t> group_maps_t;
   typedef std::unordered_map<void*, name_map_t> context_maps_t;
   static name_map_t& get_map() {
     if (identity<Traits::native>()) {
@@ -461,7 +459,7 @@ public:
   virtual uint64_t Size() const override;
 
 private:
-  typedef std::unordered_map<GLint, LocationMap<GLint>> program_locations_map_t;
+  typedef DenseNameMap<GLint, LocationMap<GLint>> program_locations_map_t;
   static program_locations_map_t& getLocationsMap();
   static GLint& ProgramOverride() {
     static GLint program;
@@ -498,7 +496,7 @@ public:
 
 private:
   typedef std::unordered_map<GLint, LocationMap<GLint>> shader_locations_map_t;
-  typedef std::unordered_map<GLint, shader_locations_map_t> program_locations_map_t;
+  typedef DenseNameMap<GLint, shader_locations_map_t> program_locations_map_t;
   static program_locations_map_t& getShadersMap();
 };
 
@@ -544,8 +542,8 @@ public:
   virtual uint64_t Size() const override;
 
 private:
-  typedef std::unordered_map<GLint, GLint> indices_map_t;
-  typedef std::unordered_map<GLint, indices_map_t> program_indices_map_t;
+  typedef DenseNameMap<GLint> indices_map_t;
+  typedef DenseNameMap<GLint, indices_map_t> program_indices_map_t;
   static program_indices_map_t& getProgramsMap();
 };
 class CGLStorageBlockIndex : public gits::CArgument {
@@ -573,8 +571,8 @@ public:
   virtual uint64_t Size() const override;
 
 private:
-  typedef std::unordered_map<GLuint, GLuint> indices_map_t;
-  typedef std::unordered_map<GLint, indices_map_t> program_indices_map_t;
+  typedef DenseNameMap<GLuint> indices_map_t;
+  typedef DenseNameMap<GLint, indices_map_t> program_indices_map_t;
   static program_indices_map_t& getProgramsMap();
 };
 } // namespace OpenGL
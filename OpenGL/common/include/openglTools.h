@@ -19,6 +19,7 @@
 #include "timer.h"
 #include "tools.h"
 
+#include <algorithm>
 #include <deque>
 #include <filesystem>
 #include <map>
@@ -27,6 +28,7 @@
 #include <sstream>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -374,6 +376,83 @@ GLenum GetTargetOfTextureOrCrash(GLuint name);
 bool isTrackTextureBindingWAUsed();
 bool isSchedulefboEXTAsCoreWA();
 
+// GL object names, uniform locations and shared group ids are small integers
+// handed out densely by the driver, so they are stored in a vector indexed by
+// the key itself and a lookup is a single indexed load. Keys that are not
+// integral (native handles, GLsync) or that fall outside of the dense range
+// (e.g. bindless texture handles) are kept in a hash map instead.
+template <typename Key, typename Value = Key>
+class DenseNameMap {
+private:
+  static constexpr bool _denseKeys = std::is_integral_v<Key>;
+  static constexpr uint64_t MAX_DENSE_KEY = 1u << 20;
+
+  std::vector<std::optional<Value>> _dense;
+  std::unordered_map<Key, Value> _sparse;
+
+  static bool isDense(const Key& key) {
+    if constexpr (_denseKeys) {
+      return static_cast<uint64_t>(key) < MAX_DENSE_KEY;
+    } else {
+      return false;
+    }
+  }
+
+  static size_t denseIndex(const Key& key) {
+    if constexpr (_denseKeys) {
+      return static_cast<size_t>(key);
+    } else {
+      return 0;
+    }
+  }
+
+public:
+  Value* find(const Key& key) {
+    if (isDense(key)) {
+      auto idx = denseIndex(key);
+      if (idx < _dense.size() && _dense[idx]) {
+        return &*_dense[idx];
+      }
+      return nullptr;
+    }
+    auto it = _sparse.find(key);
+    return it != _sparse.end() ? &it->second : nullptr;
+  }
+
+  const Value* find(const Key& key) const {
+    return const_cast<DenseNameMap*>(this)->find(key);
+  }
+
+  bool contains(const Key& key) const {
+    return find(key) != nullptr;
+  }
+
+  Value& operator[](const Key& key) {
+    if (isDense(key)) {
+      auto idx = denseIndex(key);
+      if (idx >= _dense.size()) {
+        _dense.resize(std::max<size_t>(idx + 1, _dense.size() * 2));
+      }
+      if (!_dense[idx]) {
+        _dense[idx].emplace();
+      }
+      return *_dense[idx];
+    }
+    return _sparse[key];
+  }
+
+  void erase(const Key& key) {
+    if (isDense(key)) {
+      auto idx = denseIndex(key);
+      if (idx < _dense.size()) {
+        _dense[idx].reset();
+      }
+    } else {
+      _sparse.erase(key);
+    }
+  }
+};
+
 template <typename T>
 class LocationMap {
 private:
@@ -381,25 +460,44 @@ private:
     T originalBase;
     T currentBase;
   };
-  std::map<T, LocationData> _map;
+  DenseNameMap<T, LocationData> _map;
 
 public:
   LocationMap() : _map{} {};
   void insert(const T& begin, const T& end, const T& currentBase) {
     LocationData locData{begin, currentBase};
     for (auto i = begin; i < end; i++) {
-      _map.insert(std::make_pair(i, locData));
+      if (!_map.contains(i)) {
+        _map[i] = locData;
+      }
     }
   }
 
-  std::optional<LocationData> find(const T& key) {
-    auto it = _map.find(key);
-    if (it != _map.end()) {
-      return it->second;
+  std::optional<LocationData> find(const T& key) const {
+    auto data = _map.find(key);
+    if (data != nullptr) {
+      return *data;
     } else {
       return std::nullopt;
     }
   }
 };
+
+// Per shared group storage. Shared group ids are assigned incrementally by
+// CStateDynamic, so the group's data is reached by index. A deque keeps the
+// references handed out stable when a new group is added.
+template <typename T>
+class SharedGroupMaps {
+private:
+  std::deque<T> _groups;
+
+public:
+  T& operator[](unsigned groupId) {
+    if (groupId >= _groups.size()) {
+      _groups.resize(groupId + 1);
+    }
+    return _groups[groupId];
+  }
+};
 } // namespace OpenGL
 } // namespace gits
@@ -128,6 +128,10 @@ public:
   friend class CStateDynamic;
 
   bool coherentBufferMapping;
+  // Buffers currently mapped with coherent (or persistent) access
+  std::set<GLuint> coherentMappedBuffers;
+  // Buffers that back, or once backed, a buffer texture
+  std::unordered_set<GLuint> textureBuffers;
   std::unordered_set<GLint> coherentBufferUpdatedSet;
   GLuint coherentBufferFrameNumber;
 
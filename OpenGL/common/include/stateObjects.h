@@ -246,6 +246,9 @@ public:
   CTextureStateData& Data() {
     return _data;
   }
+  const CTextureStateData& Data() const {
+    return _data;
+  }
   bool operator<(const CTextureStateObj& cmp) const {
     // there is a number of textures with id 0 equal to number of different
     // targets
@@ -737,6 +740,7 @@ struct CBindingStateData {
     std::unordered_map<GLenum, GLint> boundBuffers;
     GLuint glslProgram;
     GLuint glslPipeline;
+    GLuint vertexArray;
     Tracked();
   } track;
 };
@@ -772,6 +776,12 @@ public:
   void GLSLPipeline(GLuint pipeline) {
     _data.track.glslPipeline = pipeline;
   }
+  GLuint VertexArray() {
+    return _data.track.vertexArray;
+  }
+  void VertexArray(GLuint array) {
+    _data.track.vertexArray = array;
+  }
 };
 
 struct CIndexedBindingRangeStateData {
@@ -815,6 +825,8 @@ struct CBufferStateData {
     bool immutable;
     GLbitfield flags;
     bool coherentMapping;
+    // changes whenever buffer data may have been written
+    uint64_t dataVersion;
     Tracked(GLuint tname, GLenum ttarget = 0)
         : name(tname),
           target(ttarget),
@@ -823,7 +835,8 @@ struct CBufferStateData {
           initializedData(true),
           immutable(false),
           flags(0),
-          coherentMapping(false) {}
+          coherentMapping(false),
+          dataVersion(0) {}
   } track;
 
   struct Restored {
@@ -900,6 +913,12 @@ public:
   bool Immutable() const {
     return _data.track.immutable;
   }
+  // Data versions are unique across buffers, so a version cached for a deleted
+  // buffer never matches a new one with the same name.
+  uint64_t DataVersion() const;
+  void DataWritten();
+  // For writes done by the GPU, which are not tracked per buffer.
+  static void AllDataWritten();
   std::vector<GLubyte>& Buffer() {
     return _data.restore.buffer;
   }
@@ -967,9 +986,12 @@ public:
 struct CVertexArraysStateData {
   struct Tracked {
     typedef std::set<GLuint> CAttribsSet;
+    typedef std::map<GLuint, GLuint> CVertexBuffersMap;
 
     GLint name;
     CAttribsSet attribs;
+    // buffers bound to the vertex buffer binding points, by binding index
+    CVertexBuffersMap vertexBuffers;
     Tracked(GLint tname) : name(tname) {}
   } track;
   struct Restored {
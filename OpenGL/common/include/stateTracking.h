@@ -44,6 +44,7 @@ void stateObjRemoveFBOEXTAttachent(GLenum target, GLenum attachment);
 void OptionalBufferDataTrack(
     GLint buffer, GLintptr offset, GLsizeiptr size, const GLvoid* data, bool recording);
 void attributeIndexTrack(GLuint index);
+void vertexBufferTrack(GLuint vaobj, GLuint bindingindex, GLuint buffer);
 std::vector<uint8_t> GetBufferData(GLenum target, GLintptr offset, GLsizeiptr size);
 std::vector<uint8_t> GetNamedBufferData(GLuint buffer, GLintptr offset, GLsizeiptr size);
 
@@ -190,11 +191,31 @@ inline void glClientActiveTexture_SD(GLenum texture, GLboolean recording = 0) {
       texture;
 }
 
+// Keeps the set of coherently mapped buffers in sync with the buffer mapping
+// state, so that coherent buffer updates don't have to query buffer bindings.
+// Coherence belongs to a mapping, so it is cleared on unmap; a later
+// non-coherent mapping of the buffer must not be treated as coherent.
+inline void updateCoherentMappedBuffers(GLuint buffer, CBufferStateObj& bufferState) {
+  auto& coherentMappedBuffers = SD().GetCurrentSharedStateData().coherentMappedBuffers;
+  if (!bufferState.Data().restore.mapped) {
+    bufferState.Data().track.coherentMapping = false;
+  }
+  if (bufferState.Data().restore.mapped && bufferState.Data().track.coherentMapping) {
+    coherentMappedBuffers.insert(buffer);
+  } else {
+    coherentMappedBuffers.erase(buffer);
+  }
+}
+
 inline void glDeleteBuffers_SD(GLsizei n, const GLuint buffers[], GLboolean recording = 0) {
   if (SD().GetCurrentContext() == 0) {
     return;
   }
 
+  for (GLsizei i = 0; i < n; ++i) {
+    SD().GetCurrentSharedStateData().coherentMappedBuffers.erase(buffers[i]);
+  }
+
   // Remove deleted buffers from bindings
   auto& boundBuffers = SD().GetCurrentContextStateData().Bindings().BoundBuffers();
   for (std::unordered_map<GLenum, GLint>::iterator it = boundBuffers.begin();
@@ -374,6 +395,8 @@ inline void glVertexAttribIPointer_SD(GLuint index,
   SD().GetCurrentContextStateData().ClientArrays().InterleavedArray().Enabled(false);
 
   attributeIndexTrack(index);
+  auto& bindings = SD().GetCurrentContextStateData().Bindings();
+  vertexBufferTrack(bindings.VertexArray(), index, bindings.BoundBuffer(GL_ARRAY_BUFFER));
 }
 
 inline void glVertexAttribPointer_SD(GLuint index,
@@ -388,6 +411,8 @@ inline void glVertexAttribPointer_SD(GLuint index,
   SD().GetCurrentContextStateData().ClientArrays().InterleavedArray().Enabled(false);
 
   attributeIndexTrack(index);
+  auto& bindings = SD().GetCurrentContextStateData().Bindings();
+  vertexBufferTrack(bindings.VertexArray(), index, bindings.BoundBuffer(GL_ARRAY_BUFFER));
 }
 
 inline void glVertexPointer_SD(
@@ -1311,6 +1336,7 @@ inline void glMapBufferOES_SD(GLvoid* return_value,
       } else {
         bufferState->InitBufferMapPlayOES(MapAccessEnumToBitField(access));
       }
+      updateCoherentMappedBuffers(buffer, *bufferState);
     } else {
       error = true;
     }
@@ -1337,6 +1363,7 @@ inline void glMapBufferARB_SD(GLvoid* return_value,
       } else {
         bufferState->InitBufferMapPlayARB(MapAccessEnumToBitField(access));
       }
+      updateCoherentMappedBuffers(buffer, *bufferState);
     } else {
       error = true;
     }
@@ -1363,6 +1390,7 @@ inline void glMapBuffer_SD(GLvoid* return_value,
       } else {
         bufferState->InitBufferMapPlay(MapAccessEnumToBitField(access));
       }
+      updateCoherentMappedBuffers(buffer, *bufferState);
     } else {
       error = true;
     }
@@ -1392,6 +1420,7 @@ inline void glMapBufferRange_SD(GLvoid* return_value,
       } else {
         bufferState->InitBufferMapPlay(access, false, GLint(length), GLint(offset));
       }
+      updateCoherentMappedBuffers(buffer, *bufferState);
     } else {
       error = true;
     }
@@ -1417,6 +1446,7 @@ inline void glMapNamedBuffer_SD(GLvoid* return_value,
       } else {
         bufferState->InitBufferMapPlayEXT(MapAccessEnumToBitField(access), true);
       }
+      updateCoherentMappedBuffers(buffer, *bufferState);
     } else {
       error = true;
     }
@@ -1445,6 +1475,7 @@ inline void glMapNamedBufferRange_SD(GLvoid* return_value,
       } else {
         bufferState->InitBufferMapPlayEXT(access, true, GLint(length), GLint(offset));
       }
+      updateCoherentMappedBuffers(buffer, *bufferState);
     } else {
       error = true;
     }
@@ -1855,6 +1886,56 @@ inline void glNamedBufferSubData_SD(GLuint buffer,
   }
 }
 
+inline void glCopyBufferSubData_SD(GLenum readTarget,
+                                   GLenum writeTarget,
+                                   GLintptr readOffset,
+                                   GLintptr writeOffset,
+                                   GLsizeiptr size,
+                                   GLboolean recording = 0) {
+  if (Configurator::IsRecorder()) {
+    auto* bufferState = SD().GetCurrentSharedStateData().Buffers().Get(boundBuff(writeTarget));
+    if (bufferState != nullptr) {
+      bufferState->DataWritten();
+    }
+  }
+}
+
+inline void glCopyNamedBufferSubData_SD(GLuint readBuffer,
+                                        GLuint writeBuffer,
+                                        GLintptr readOffset,
+                                        GLintptr writeOffset,
+                                        GLsizeiptr size,
+                                        GLboolean recording = 0) {
+  if (Configurator::IsRecorder()) {
+    auto* bufferState = SD().GetCurrentSharedStateData().Buffers().Get(writeBuffer);
+    if (bufferState != nullptr) {
+      bufferState->DataWritten();
+    }
+  }
+}
+
+inline void glNamedCopyBufferSubDataEXT_SD(GLuint readBuffer,
+                                           GLuint writeBuffer,
+                                           GLintptr readOffset,
+                                           GLintptr writeOffset,
+                                           GLsizeiptr size,
+                                           GLboolean recording = 0) {
+  glCopyNamedBufferSubData_SD(readBuffer, writeBuffer, readOffset, writeOffset, size, recording);
+}
+
+// Transform feedback and shader writes to buffers are not tracked per buffer.
+inline void glEndTransformFeedback_SD(GLboolean recording = 0) {
+  if (Configurator::IsRecorder()) {
+    CBufferStateObj::AllDataWritten();
+  }
+}
+
+inline void glMemoryBarrier_SD(GLbitfield barriers, GLboolean recording = 0) {
+  if (Configurator::IsRecorder() && (barriers & GL_ELEMENT_ARRAY_BARRIER_BIT)) {
+    CBufferStateObj::AllDataWritten();
+  }
+}
+
 inline void glColorPointerEXT_SD(GLint size,
                                  GLenum type,
                                  GLsizei stride,
@@ -2006,6 +2087,12 @@ inline void glDeleteVertexArrays_SD(GLsizei n,
                                     const GLuint* arrays,
                                     GLboolean recording = 0 /*= false*/) {
   if (Configurator::IsRecorder()) {
+    auto& bindings = SD().GetCurrentContextStateData().Bindings();
+    for (GLsizei i = 0; i < n; ++i) {
+      if (arrays[i] == bindings.VertexArray()) {
+        bindings.VertexArray(0);
+      }
+    }
     SD().GetCurrentContextStateData().VertexArrays().Remove(n, arrays);
   }
 }
@@ -2160,6 +2247,42 @@ inline void checkVertexArrayTrackingHelper(GLint vaobj) {
   }
 }
 
+inline void glBindVertexArray_SD(GLuint array, GLboolean recording = 0 /*= false*/) {
+  if (Configurator::IsRecorder()) {
+    SD().GetCurrentContextStateData().Bindings().VertexArray(array);
+  }
+}
+
+inline void glBindVertexBuffer_SD(GLuint bindingindex,
+                                  GLuint buffer,
+                                  GLintptr offset,
+                                  GLsizei stride,
+                                  GLboolean recording = 0 /*= false*/) {
+  vertexBufferTrack(SD().GetCurrentContextStateData().Bindings().VertexArray(), bindingindex,
+                    buffer);
+}
+
+inline void glVertexArrayVertexBuffer_SD(GLuint vaobj,
+                                         GLuint bindingindex,
+                                         GLuint buffer,
+                                         GLintptr offset,
+                                         GLsizei stride,
+                                         GLboolean recording = 0 /*= false*/) {
+  vertexBufferTrack(vaobj, bindingindex, buffer);
+}
+
+inline void glVertexArrayVertexAttribOffsetEXT_SD(GLuint vaobj,
+                                                  GLuint buffer,
+                                                  GLuint index,
+                                                  GLint size,
+                                                  GLenum type,
+                                                  GLboolean normalized,
+                                                  GLsizei stride,
+                                                  GLintptr offset,
+                                                  GLboolean recording = 0 /*= false*/) {
+  vertexBufferTrack(vaobj, index, buffer);
+}
+
 inline void glVertexAttribFormat_SD(GLuint attribindex,
                                     GLint size,
                                     GLenum type,
@@ -2567,6 +2690,8 @@ inline void glUnmapBuffer_SD(GLboolean return_value,
     CBufferStateObj* bufferState = SD().GetCurrentSharedStateData().Buffers().Get(buffer);
     if (bufferState != nullptr) {
       bufferState->RemoveMapping();
+      bufferState->DataWritten();
+      updateCoherentMappedBuffers(buffer, *bufferState);
     }
   }
 }
@@ -2578,6 +2703,8 @@ inline void glUnmapNamedBuffer_SD(GLboolean return_value,
     CBufferStateObj* bufferState = SD().GetCurrentSharedStateData().Buffers().Get(buffer);
     if (bufferState != nullptr) {
       bufferState->RemoveMapping();
+      bufferState->DataWritten();
+      updateCoherentMappedBuffers(buffer, *bufferState);
     }
   }
 }
@@ -3167,6 +3294,7 @@ inline void glTexBuffer_SD(GLenum target,
     }
     texStateObj->Data().track.texbuffer_internalformat = internalformat;
     texStateObj->Data().track.texbuffer_buffer = buffer;
+    SD().GetCurrentSharedStateData().textureBuffers.insert(buffer);
   }
 }
 
@@ -3187,6 +3315,7 @@ inline void glTextureBuffer_SD(GLuint texture,
     }
     texStateObj->Data().track.texbuffer_internalformat = internalformat;
     texStateObj->Data().track.texbuffer_buffer = buffer;
+    SD().GetCurrentSharedStateData().textureBuffers.insert(buffer);
   }
 }
 } // namespace OpenGL
@@ -110,7 +110,7 @@ void CGLUniformLocation::RemoveMappings(GLint program) {
 }
 
 CGLUniformLocation::program_locations_map_t& CGLUniformLocation::getLocationsMap() {
-  typedef std::unordered_map<unsigned int, program_locations_map_t> location_maps_map_t;
+  typedef SharedGroupMaps<program_locations_map_t> location_maps_map_t;
   INIT_NEW_STATIC_OBJ(uniformLocationMaps, location_maps_map_t)
   return uniformLocationMaps[SD().GetCurrentContextSharedGroupId()];
 }
@@ -175,7 +175,7 @@ void CGLUniformSubroutineLocation::AddMapping(
 
 CGLUniformSubroutineLocation::program_locations_map_t& CGLUniformSubroutineLocation::
     getShadersMap() {
-  typedef std::map<unsigned int, program_locations_map_t> location_maps_map_t;
+  typedef SharedGroupMaps<program_locations_map_t> location_maps_map_t;
   INIT_NEW_STATIC_OBJ(uniformLocationMaps, location_maps_map_t)
   return uniformLocationMaps[SD().GetCurrentContextSharedGroupId()];
 }
@@ -225,12 +225,12 @@ uint64_t CGLUniformBlockIndex::Size() const {
 
 GLint CGLUniformBlockIndex::operator*() const {
   auto& idx_map = getProgramsMap()[program_];
-  auto iter = idx_map.find(index_);
-  if (iter == idx_map.end()) {
+  auto* index = idx_map.find(index_);
+  if (index == nullptr) {
     LOG_WARNING << "Couldn't map uniform block index";
     return index_;
   }
-  return iter->second;
+  return *index;
 }
 
 void CGLUniformBlockIndex::AddMapping(GLint program, GLint index, GLint actual_index) {
@@ -238,7 +238,7 @@ void CGLUniformBlockIndex::AddMapping(GLint program, GLint index, GLint actual_i
 }
 
 CGLUniformBlockIndex::program_indices_map_t& CGLUniformBlockIndex::getProgramsMap() {
-  typedef std::map<unsigned int, program_indices_map_t> indices_maps_map_t;
+  typedef SharedGroupMaps<program_indices_map_t> indices_maps_map_t;
   INIT_NEW_STATIC_OBJ(uniformLocationMaps, indices_maps_map_t)
   return uniformLocationMaps[SD().GetCurrentContextSharedGroupId()];
 }
@@ -264,12 +264,12 @@ uint64_t CGLStorageBlockIndex::Size() const {
 
 GLuint CGLStorageBlockIndex::operator*() const {
   auto& idx_map = getProgramsMap()[program_];
-  auto iter = idx_map.find(index_);
-  if (iter == idx_map.end()) {
+  auto* index = idx_map.find(index_);
+  if (index == nullptr) {
     LOG_WARNING << "Couldn't map storage block index";
     return index_;
   }
-  return iter->second;
+  return *index;
 }
 
 void CGLStorageBlockIndex::AddMapping(GLint program, GLuint index, GLuint actual_index) {
@@ -277,7 +277,7 @@ void CGLStorageBlockIndex::AddMapping(GLint program, GLuint index, GLuint actual
 }
 
 CGLStorageBlockIndex::program_indices_map_t& CGLStorageBlockIndex::getProgramsMap() {
-  typedef std::map<unsigned int, program_indices_map_t> indices_maps_map_t;
+  typedef SharedGroupMaps<program_indices_map_t> indices_maps_map_t;
   INIT_NEW_STATIC_OBJ(storageLocationMaps, indices_maps_map_t)
   return storageLocationMaps[SD().GetCurrentContextSharedGroupId()];
 }
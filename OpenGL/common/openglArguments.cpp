@@ -850,7 +850,11 @@ std::unordered_map<GLuint, GLenum> gits::OpenGL::CCoherentBufferUpdate::GetCurre
     SD().GetCurrentSharedStateData().coherentBufferFrameNumber = CGits::Instance().CurrentFrame();
   }
   std::unordered_map<GLuint, GLenum> buffers;
-  GLint attribs = 0;
+  const auto& coherentMappedBuffers = SD().GetCurrentSharedStateData().coherentMappedBuffers;
+  if (coherentMappedBuffers.empty()) {
+    return buffers;
+  }
+
   auto insert_buffer = [&](GLint buffer, GLenum target) {
     if ((oncePerFrame == false) ||
         (SD().GetCurrentSharedStateData().coherentBufferUpdatedSet.find(buffer) ==
@@ -861,82 +865,58 @@ std::unordered_map<GLuint, GLenum> gits::OpenGL::CCoherentBufferUpdate::GetCurre
       }
     }
   };
-  auto add_buffer = [&](GLenum binding_target, GLenum target) {
-    GLint buf = 0;
-    drv.gl.glGetIntegerv(binding_target, &buf);
-    if (buf != 0) {
-      insert_buffer(buf, target);
-    }
-  };
 
   if (updateType == TCoherentBufferData::PER_DRAWCALL_UPDATE ||
       updateType == TCoherentBufferData::PER_FRAME_UPDATE) {
-    auto can_query_vertex_attribs = [&]() {
-      bool isVaoMandatory = curctx::IsEs2Plus() || (curctx::IsOgl() && SD().IsCurrentContextCore());
-      GLint vao = 0;
-      drv.gl.glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vao);
-      return !isVaoMandatory || vao != 0;
+    // Only coherently mapped buffers the draw can read need an update. They are
+    // matched against the bindings kept by state tracking, so no driver query is
+    // made per draw. Buffers are accessed through GL_ARRAY_BUFFER, which is
+    // restored afterwards.
+    std::set<GLuint> unmatched = coherentMappedBuffers;
+    auto match_buffer = [&](GLint buffer) {
+      if (buffer != 0 && unmatched.erase(buffer) != 0) {
+        insert_buffer(buffer, GL_ARRAY_BUFFER);
+      }
     };
 
-    if (can_query_vertex_attribs()) {
-      drv.gl.glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &attribs);
-
-      for (int i = 0; i < attribs; ++i) {
-        GLint enabled = GL_FALSE;
-        drv.gl.glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_ENABLED, &enabled);
-        if (enabled == GL_TRUE) {
-          GLint buf = 0;
-          drv.gl.glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &buf);
-          insert_buffer(buf, GL_ARRAY_BUFFER);
-        }
-      }
-      add_buffer(GL_ELEMENT_ARRAY_BUFFER_BINDING, GL_ELEMENT_ARRAY_BUFFER);
-      auto& indexedTargets =
-          SD().GetCurrentSharedStateData().IndexedBoundBuffers().TargetsInfo()[GL_UNIFORM_BUFFER];
-      for (const auto& uniformBuff : indexedTargets) {
-        if (uniformBuff.second.buffer != 0) {
-          insert_buffer(uniformBuff.second.buffer, GL_UNIFORM_BUFFER);
-        }
-      }
+    auto& contextState = SD().GetCurrentContextStateData();
+    for (const auto& binding : contextState.Bindings().BoundBuffers()) {
+      match_buffer(binding.second);
     }
-    GLint texUnit;
-    GLint maxTexUnits;
-    GLint tex_buffer_boundtex;
-    GLuint texbuffer_buffer = 0;
-    drv.gl.glGetIntegerv(GL_ACTIVE_TEXTURE, &texUnit);
-    drv.gl.glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &maxTexUnits);
-
-    for (int unit = GL_TEXTURE0; unit < GL_TEXTURE0 + maxTexUnits; unit++) {
-      drv.gl.glActiveTexture(unit);
-      drv.gl.glGetIntegerv(GL_TEXTURE_BINDING_BUFFER_EXT, &tex_buffer_boundtex);
-      CTextureStateObj* tex = SD().GetCurrentSharedStateData().Textures().Get(
-          CTextureStateObj(tex_buffer_boundtex, GL_TEXTURE_BUFFER));
-      if (tex != nullptr) {
-        texbuffer_buffer = tex->Data().track.texbuffer_buffer;
+    auto& indexedTargets = SD().GetCurrentSharedStateData().IndexedBoundBuffers().TargetsInfo();
+    for (const auto& target : indexedTargets) {
+      for (const auto& index : target.second) {
+        match_buffer(index.second.buffer);
       }
-      if (texbuffer_buffer > 0) {
-        insert_buffer(texbuffer_buffer, GL_TEXTURE_BUFFER_EXT);
+    }
+
+    // Vertex buffers of the bound vertex array object.
+    auto* vertexArray = contextState.VertexArrays().Get(contextState.Bindings().VertexArray());
+    if (vertexArray != nullptr) {
+      for (const auto& binding : vertexArray->Data().track.vertexBuffers) {
+        match_buffer(binding.second);
       }
-      texbuffer_buffer = 0;
     }
-    drv.gl.glActiveTexture(texUnit);
-
-    if ((curctx::IsOgl() && curctx::Version() >= 430) || curctx::IsEs31Plus()) {
-      GLint shaderStorageBuffer;
-      drv.gl.glGetIntegerv(GL_SHADER_STORAGE_BUFFER_BINDING, &shaderStorageBuffer);
-      insert_buffer(shaderStorageBuffer, GL_SHADER_STORAGE_BUFFER);
-
-      GLint maxShaderStorageBindings;
-      drv.gl.glGetIntegerv(GL_MAX_SHADER_STORAGE_BUFFER_BINDINGS, &maxShaderStorageBindings);
-      for (int i = 0; i < maxShaderStorageBindings; i++) {
-        drv.gl.glGetIntegeri_v(GL_SHADER_STORAGE_BUFFER_BINDING, i, &shaderStorageBuffer);
-        insert_buffer(shaderStorageBuffer, GL_SHADER_STORAGE_BUFFER);
+
+    // Buffer textures are not tracked per texture unit, so every buffer that
+    // backs one is taken.
+    const auto& textureBuffers = SD().GetCurrentSharedStateData().textureBuffers;
+    for (auto it = unmatched.begin(); it != unmatched.end();) {
+      if (textureBuffers.count(*it) != 0) {
+        insert_buffer(*it, GL_ARRAY_BUFFER);
+        it = unmatched.erase(it);
+      } else {
+        ++it;
       }
     }
   }
 
   if (curctx::IsOgl() && updateType == TCoherentBufferData::TEXTURE_UPDATE) {
-    add_buffer(GL_PIXEL_UNPACK_BUFFER_BINDING, GL_PIXEL_UNPACK_BUFFER);
+    GLint buf = 0;
+    drv.gl.glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &buf);
+    if (buf != 0 && coherentMappedBuffers.count(buf) != 0) {
+      insert_buffer(buf, GL_PIXEL_UNPACK_BUFFER);
+    }
   }
 
   buffers.erase(0);
@@ -946,17 +926,15 @@ std::unordered_map<GLuint, GLenum> gits::OpenGL::CCoherentBufferUpdate::GetCurre
 void gits::OpenGL::CCoherentBufferUpdate::Diff(TCoherentBufferData::UpdateType updateType,
                                                TCoherentBufferData::UpdateMode updateMode,
                                                bool oncePerFrame) {
+  auto buffers = GetCurrentBuffers(updateType, oncePerFrame);
+  if (buffers.empty()) {
+    return;
+  }
 
-  GLint tex_buffer_bound;
   GLint array_buffer_bound;
-  GLint shader_storage_buffer_bound = 0;
-  drv.gl.glGetIntegerv(GL_TEXTURE_BUFFER_BINDING, &tex_buffer_bound);
   drv.gl.glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &array_buffer_bound);
-  if ((curctx::IsOgl() && curctx::Version() >= 430) || curctx::IsEs31Plus()) {
-    drv.gl.glGetIntegerv(GL_SHADER_STORAGE_BUFFER_BINDING, &shader_storage_buffer_bound);
-  }
 
-  for (const auto& buff : GetCurrentBuffers(updateType, oncePerFrame)) {
+  for (const auto& buff : buffers) {
     GLuint buffer = buff.first;
     GLenum target = buff.second;
     GLint size = 0;
@@ -1104,11 +1082,7 @@ void gits::OpenGL::CCoherentBufferUpdate::Diff(TCoherentBufferData::UpdateType u
       }
     }
   }
-  drv.gl.glBindBuffer(GL_TEXTURE_BUFFER_EXT, tex_buffer_bound);
   drv.gl.glBindBuffer(GL_ARRAY_BUFFER, array_buffer_bound);
-  if ((curctx::IsOgl() && curctx::Version() >= 430) || curctx::IsEs31Plus()) {
-    drv.gl.glBindBuffer(GL_SHADER_STORAGE_BUFFER, shader_storage_buffer_bound);
-  }
 }
 
 void gits::OpenGL::CCoherentBufferUpdate::Apply() {
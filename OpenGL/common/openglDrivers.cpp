@@ -188,6 +188,44 @@ using namespace lua;
 
 static bool bypass_luascript;
 
+#define HOOK_ID_GL_FUNCTION(b, c, d, e)      HOOK_##c,
+#define HOOK_ID_GL_DRAW_FUNCTION(b, c, d, e) HOOK_ID_GL_FUNCTION(b, c, d, e)
+#define HOOK_ID_EGL_FUNCTION(b, c, d, e)     HOOK_ID_GL_FUNCTION(b, c, d, e)
+#define HOOK_ID_WGL_FUNCTION(b, c, d, e)     HOOK_ID_GL_FUNCTION(b, c, d, e)
+#define HOOK_ID_WGL_EXT_FUNCTION(b, c, d, e) HOOK_ID_GL_FUNCTION(b, c, d, e)
+#define HOOK_ID_GLX_FUNCTION(b, c, d, e)     HOOK_ID_GL_FUNCTION(b, c, d, e)
+
+#define HOOK_NAME_GL_FUNCTION(b, c, d, e)      #c,
+#define HOOK_NAME_GL_DRAW_FUNCTION(b, c, d, e) HOOK_NAME_GL_FUNCTION(b, c, d, e)
+#define HOOK_NAME_EGL_FUNCTION(b, c, d, e)     HOOK_NAME_GL_FUNCTION(b, c, d, e)
+#define HOOK_NAME_WGL_FUNCTION(b, c, d, e)     HOOK_NAME_GL_FUNCTION(b, c, d, e)
+#define HOOK_NAME_WGL_EXT_FUNCTION(b, c, d, e) HOOK_NAME_GL_FUNCTION(b, c, d, e)
+#define HOOK_NAME_GLX_FUNCTION(b, c, d, e)     HOOK_NAME_GL_FUNCTION(b, c, d, e)
+
+#ifdef GITS_PLATFORM_WINDOWS
+#define HOOK_WGL_FUNCTIONS(prefix) WGL_FUNCTIONS(prefix) WGL_EXT_FUNCTIONS(prefix)
+#else
+#define HOOK_WGL_FUNCTIONS(prefix)
+#endif
+
+#ifdef GITS_PLATFORM_X11
+#define HOOK_GLX_FUNCTIONS(prefix) GLX_FUNCTIONS(prefix)
+#else
+#define HOOK_GLX_FUNCTIONS(prefix)
+#endif
+
+// Indices of the API functions in the hook table.
+enum HookId : unsigned {
+  GL_FUNCTIONS(HOOK_ID_) DRAW_FUNCTIONS(HOOK_ID_) EGL_FUNCTIONS(HOOK_ID_)
+      HOOK_WGL_FUNCTIONS(HOOK_ID_) HOOK_GLX_FUNCTIONS(HOOK_ID_) HOOKS_COUNT
+};
+
+const char* const hookNames[] = {GL_FUNCTIONS(HOOK_NAME_) DRAW_FUNCTIONS(HOOK_NAME_)
+                                     EGL_FUNCTIONS(HOOK_NAME_) HOOK_WGL_FUNCTIONS(HOOK_NAME_)
+                                         HOOK_GLX_FUNCTIONS(HOOK_NAME_)};
+
+HookTable hooks(hookNames, HOOKS_COUNT);
+
 #define LUA_GL_FUNCTION(b, c, d, e)      LUA_FUNCTION(b, c, d, drv.gl)
 #define LUA_GL_DRAW_FUNCTION(b, c, d, e) LUA_FUNCTION(b, c, d, drv.gl)
 #define LUA_EGL_FUNCTION(b, c, d, e)     LUA_FUNCTION(b, c, d, drv.egl)
@@ -203,8 +241,6 @@ static NOINLINE lua_State* GetLuaState() {
 
 #define LUA_SCRIPTING_INSTRUMENTATION(b, c, d, e)
 
-#define LUA_FUNCTION_EXISTS(function) lua::FunctionExists(function, GetLuaState())
-
 // logging_`function` is a function that is called from
 // default_`function` when configured to do so. It assumes that
 // drv.gl.`function` is properly initialized and so stores the value
@@ -221,16 +257,13 @@ static NOINLINE lua_State* GetLuaState() {
     }                                                                                              \
     b gits_ret = (b)0;                                                                             \
     bool call_shd = true;                                                                          \
-    if (gits_cfg.common.shared.useEvents && !bypass_luascript) {                                   \
+    if (hooks.Exists(HOOK_##c) && !bypass_luascript) {                                            \
       const auto L = GetLuaState();                                                                \
-      const bool exists = !doTrace || lua::FunctionExists(#c, L);                                  \
-      if (exists) {                                                                                \
-        LUA_CALL_FUNCTION(L, #c, e, d)                                                             \
-        call_shd = false;                                                                          \
-        const int top_ = lua_gettop(L);                                                            \
-        gits_ret = lua::lua_to<b>(L, top_);                                                        \
-        lua_pop(L, top_);                                                                          \
-      }                                                                                            \
+      LUA_CALL_HOOK(L, hooks, HOOK_##c, #c, e, d)                                                  \
+      call_shd = false;                                                                            \
+      const int top_ = lua_gettop(L);                                                              \
+      gits_ret = lua::lua_to<b>(L, top_);                                                          \
+      lua_pop(L, top_);                                                                            \
     }                                                                                              \
     if (call_shd) {                                                                                \
       gits_ret = drv_name.shd_##c e;                                                               \
@@ -260,10 +293,9 @@ void CheckForRecursion(dl::SharedObject library) {
   }
 }
 
-NOINLINE bool UseTracing(const char* func) {
+NOINLINE bool UseTracing(unsigned hookId) {
   const auto& cfg = Configurator::Get();
-  return log::ShouldLog(LogLevel::TRACE) ||
-         (cfg.common.shared.useEvents && LUA_FUNCTION_EXISTS(func)) ||
+  return log::ShouldLog(LogLevel::TRACE) || hooks.Exists(hookId) ||
          (!cfg.common.player.traceSelectedFrames.empty());
 }
 
@@ -301,7 +333,7 @@ NOINLINE void LogFunctionNotFoundShutdown(const char* func) {
     if (drv_name.c == 0)                                                                           \
       LogFunctionNotFoundShutdown(#c);                                                             \
                                                                                                    \
-    if (UseTracing(#c))                                                                            \
+    if (UseTracing(HOOK_##c))                                                                      \
       drv_name.c = logging_##c;                                                                    \
                                                                                                    \
     return drv_name.c e;                                                                           \
@@ -416,6 +448,7 @@ void RegisterLuaDriverFunctions() {
   const auto L = CGits::Instance().GetLua();
   luaL_newlib(L.get(), exports);
   lua_setglobal(L.get(), "drv");
+  hooks.Resolve(L.get());
 }
 
 #undef DEFAULT_GL_FUNCTION
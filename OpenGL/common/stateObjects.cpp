@@ -18,6 +18,8 @@
 #include "stateDynamic.h"
 #include "tools.h"
 
+#include <atomic>
+
 namespace gits {
 namespace OpenGL {
 
@@ -248,7 +250,13 @@ void CGLSLPipelineStateObj::UseProgramStage(GLbitfield stages, GLuint program) {
 }
 
 //----------------------CBUFFERSTATEOBJ----------------------
+namespace {
+std::atomic<uint64_t> bufferDataVersionCounter{0};
+std::atomic<uint64_t> allBuffersDataVersion{0};
+} // namespace
+
 CBufferStateObj::CBufferStateObj(GLuint buffer, GLenum target) : _data(buffer, target) {
+  DataWritten();
   _data.restore.mapped = false;
   _data.restore.mapLength = -1;
   _data.restore.mapAccess = 0;
@@ -256,6 +264,18 @@ CBufferStateObj::CBufferStateObj(GLuint buffer, GLenum target) : _data(buffer, t
   _data.restore.named = false;
 }
 
+uint64_t CBufferStateObj::DataVersion() const {
+  return std::max<uint64_t>(_data.track.dataVersion, allBuffersDataVersion);
+}
+
+void CBufferStateObj::DataWritten() {
+  _data.track.dataVersion = ++bufferDataVersionCounter;
+}
+
+void CBufferStateObj::AllDataWritten() {
+  allBuffersDataVersion = ++bufferDataVersionCounter;
+}
+
 void CBufferStateObj::SetBufferMapPlay(GLbitfield access, bool named, GLint length, GLint offset) {
   _data.restore.mapAccess = access;
   _data.restore.mapLength = length;
@@ -498,7 +518,7 @@ void CBufferStateObj::CalculateMapChange(GLintptr& mapoffset,
   mapoffset = minPrePtr - mapOffset - &_data.restore.buffer.front();
 }
 
-CBindingStateData::Tracked::Tracked() : glslProgram(0), glslPipeline(0) {
+CBindingStateData::Tracked::Tracked() : glslProgram(0), glslPipeline(0), vertexArray(0) {
   boundBuffers[GL_ARRAY_BUFFER] = 0;
   boundBuffers[GL_ELEMENT_ARRAY_BUFFER] = 0;
   boundBuffers[GL_PIXEL_PACK_BUFFER] = 0;
@@ -145,15 +145,17 @@ void gits::OpenGL::OptionalBufferDataTrack(
   if (buffer == 0) {
     return;
   }
+  auto* bufferStateData = SD().GetCurrentSharedStateData().Buffers().Get(buffer);
+  if (bufferStateData == nullptr) {
+    return;
+  }
+  bufferStateData->DataWritten();
   //For OpenGL ES we need to track buffer data by default.
   //In case of optimizeBuffersz option we need to track buffer changes during recording for mapped memory changes detection performance.
   if ((!curctx::IsOgl() && ESBufferState() != TBuffersState::RESTORE &&
        !IsGlGetTexAndCompressedTexImagePresentOnGLES()) ||
       (recording && Configurator::Get().opengl.recorder.optimizeBufferSize)) {
-    auto* bufferStateData = SD().GetCurrentSharedStateData().Buffers().Get(buffer);
-    if (bufferStateData != nullptr) {
-      bufferStateData->TrackBufferData(offset, size, data);
-    }
+    bufferStateData->TrackBufferData(offset, size, data);
   }
 }
 
@@ -171,6 +173,18 @@ void gits::OpenGL::attributeIndexTrack(GLuint index) {
   }
 }
 
+// Vertex buffer bindings are kept so that coherent buffer updates can find the
+// buffers a draw reads without querying the driver.
+void gits::OpenGL::vertexBufferTrack(GLuint vaobj, GLuint bindingindex, GLuint buffer) {
+  if (Configurator::IsRecorder()) {
+    checkVertexArrayTrackingHelper(vaobj);
+    auto* vertexArray = SD().GetCurrentContextStateData().VertexArrays().Get(vaobj);
+    if (vertexArray != nullptr) {
+      vertexArray->Data().track.vertexBuffers[bindingindex] = buffer;
+    }
+  }
+}
+
 std::vector<uint8_t> gits::OpenGL::GetBufferData(GLenum target, GLintptr offset, GLsizeiptr size) {
   std::vector<uint8_t> tmpData(size);
   uint8_t* pSrc = (uint8_t*)drv.gl.glMapBufferRange(target, offset, size, GL_MAP_READ_BIT);
@@ -21,8 +21,9 @@
 namespace gits {
 namespace OpenGL {
 inline void coherentBufferUpdate_PS(CRecorder& recorder) {
-  if (SD().GetCurrentSharedStateData().coherentBufferMapping == true &&
-      SD().GetCurrentContext() != nullptr) {
+  if (SD().GetCurrentContext() != nullptr &&
+      SD().GetCurrentSharedStateData().coherentBufferMapping == true &&
+      !SD().GetCurrentSharedStateData().coherentMappedBuffers.empty()) {
     recorder.Schedule(new CgitsCoherentBufferMapping(
         CCoherentBufferUpdate::TCoherentBufferData::TEXTURE_UPDATE,
         CCoherentBufferUpdate::TCoherentBufferData::UPDATE_BOUND,
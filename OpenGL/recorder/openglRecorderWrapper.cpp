@@ -75,8 +75,9 @@ DrawCallWrapperPrePost::DrawCallWrapperPrePost(gits::CRecorder& rec) : _recorder
     gits::OpenGL::SD().EraseNonCurrentData();
   }
   _recorder.DrawBegin();
-  if (gits::OpenGL::SD().GetCurrentSharedStateData().coherentBufferMapping == true &&
-      (gits::OpenGL::SD().GetCurrentContext() != nullptr)) {
+  if (gits::OpenGL::SD().GetCurrentContext() != nullptr &&
+      gits::OpenGL::SD().GetCurrentSharedStateData().coherentBufferMapping == true &&
+      !gits::OpenGL::SD().GetCurrentSharedStateData().coherentMappedBuffers.empty()) {
     _recorder.Schedule(new gits::OpenGL::CgitsCoherentBufferMapping(
         gits::OpenGL::CCoherentBufferUpdate::TCoherentBufferData::PER_DRAWCALL_UPDATE,
         gits::OpenGL::CCoherentBufferUpdate::TCoherentBufferData::UPDATE_BOUND,
@@ -32,6 +32,8 @@ dispatch_table = get_dispatch_table(command)
 % endif
 void ${command.name}Runner::Run() {
   auto& manager = PlayerManager::Get();
+  CommandProfileScope profile(static_cast<unsigned>(command.GetId()), "${command.name}",
+                              m_DecodeTicks);
 <%
   input_handle_params = []
   for param in command.params:
@@ -57,9 +59,12 @@ void ${command.name}Runner::Run() {
   }
 % endif
 
+  profile.Mark(CommandStage::Remap);
+
   for (Layer* layer : manager.GetPreLayers()) {
     layer->Pre(command);
   }
+  profile.Mark(CommandStage::PreLayers);
 
   if (manager.ExecuteCommands() && !command.m_Skip) {
     ${'command.m_Return.Value = ' if command.return_type != 'void' else ''}manager.${dispatch_table}(${f'command.m_{command.params[0].name}.Value' if dispatch_table != 'GetGlobalDispatchTable' else ''}).${command.name}(
@@ -95,10 +100,12 @@ void ${command.name}Runner::Run() {
     % endif
     % endfor
   }
+  profile.Mark(CommandStage::Driver);
 
   for (Layer* layer : manager.GetPostLayers()) {
     layer->Post(command);
   }
+  profile.Mark(CommandStage::PostLayers);
 }
 % if define:
 #endif
@@ -14,6 +14,7 @@ ${header}
 #include "commandsCustom.h"
 #include "commandCodersAuto.h"
 #include "commandCodersCustom.h"
+#include "commandProfiler.h"
 
 namespace gits {
 namespace vulkan {
@@ -29,11 +30,15 @@ public:
 
 protected:
   void DecodeCommand() override {
+    const bool profiled = ActiveCommandProfiler() != nullptr;
+    const uint64_t begin = profiled ? ReadProfilerTicks() : 0;
     Decode(m_Data, command);
+    m_DecodeTicks = profiled ? ReadProfilerTicks() - begin : 0;
   }
 
 private:
   ${command.name}Command command;
+  uint64_t m_DecodeTicks{};
 };
 % if define:
 #endif
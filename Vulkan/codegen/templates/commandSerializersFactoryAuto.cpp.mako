@@ -25,6 +25,9 @@ stream::CommandSerializer* CreateCommandSerializer(Command* command) {
           *static_cast<RestoreContentManifestCommand*>(command));
     case CommandId::ID_META_RESTORE_CONTENT_DATA:
       return new RestoreContentDataSerializer(*static_cast<RestoreContentDataCommand*>(command));
+    case CommandId::ID_META_RESTORE_CONTENT_CACHED_DATA:
+      return new RestoreContentCachedDataSerializer(
+          *static_cast<RestoreContentCachedDataCommand*>(command));
     % for command in commands:
     <% define = get_define(command.platform) %>\
     % if define:
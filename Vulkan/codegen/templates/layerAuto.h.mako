@@ -11,6 +11,7 @@ ${header}
 
 #include "commandsAuto.h"
 #include "commandsCustom.h"
+#include "commandProfiler.h"
 
 #include <string>
 
@@ -26,45 +27,67 @@ public:
     return m_Name;
   }
 
-  virtual void Pre(StateRestoreBeginCommand& command) {}
-  virtual void Post(StateRestoreBeginCommand& command) {}
+  // A layer that wants per-command stage timings returns its profiler here;
+  // the player installs the first one it finds.
+  virtual CommandProfiler* GetCommandProfiler() {
+    return nullptr;
+  }
+
+  // Raised by every default (not overridden) Pre/Post implementation. Lets
+  // LayerDispatch drop a layer from a command's dispatch list after its first
+  // call, so layers are only invoked for the commands they implement.
+  static bool& DefaultHookCalled() {
+    static thread_local bool called = false;
+    return called;
+  }
+
+  virtual void Pre(StateRestoreBeginCommand& command) { MarkDefaultHook(); }
+  virtual void Post(StateRestoreBeginCommand& command) { MarkDefaultHook(); }
 
-  virtual void Pre(StateRestoreEndCommand& command) {}
-  virtual void Post(StateRestoreEndCommand& command) {}
+  virtual void Pre(StateRestoreEndCommand& command) { MarkDefaultHook(); }
+  virtual void Post(StateRestoreEndCommand& command) { MarkDefaultHook(); }
 
-  virtual void Pre(FrameEndCommand& command) {}
-  virtual void Post(FrameEndCommand& command) {}
+  virtual void Pre(FrameEndCommand& command) { MarkDefaultHook(); }
+  virtual void Post(FrameEndCommand& command) { MarkDefaultHook(); }
 
-  virtual void Pre(MarkerUInt64Command& command) {}
-  virtual void Post(MarkerUInt64Command& command) {}
+  virtual void Pre(MarkerUInt64Command& command) { MarkDefaultHook(); }
+  virtual void Post(MarkerUInt64Command& command) { MarkDefaultHook(); }
 
-  virtual void Pre(CreateWindowMetaCommand& command) {}
-  virtual void Post(CreateWindowMetaCommand& command) {}
+  virtual void Pre(CreateWindowMetaCommand& command) { MarkDefaultHook(); }
+  virtual void Post(CreateWindowMetaCommand& command) { MarkDefaultHook(); }
 
-  virtual void Pre(MappedDataMetaCommand& command) {}
-  virtual void Post(MappedDataMetaCommand& command) {}
+  virtual void Pre(MappedDataMetaCommand& command) { MarkDefaultHook(); }
+  virtual void Post(MappedDataMetaCommand& command) { MarkDefaultHook(); }
   
-  virtual void Pre(UpdateWindowMetaCommand& command) {}
-  virtual void Post(UpdateWindowMetaCommand& command) {}
+  virtual void Pre(UpdateWindowMetaCommand& command) { MarkDefaultHook(); }
+  virtual void Post(UpdateWindowMetaCommand& command) { MarkDefaultHook(); }
 
-  virtual void Pre(RestoreContentManifestCommand& command) {}
-  virtual void Post(RestoreContentManifestCommand& command) {}
+  virtual void Pre(RestoreContentManifestCommand& command) { MarkDefaultHook(); }
+  virtual void Post(RestoreContentManifestCommand& command) { MarkDefaultHook(); }
 
-  virtual void Pre(RestoreContentDataCommand& command) {}
-  virtual void Post(RestoreContentDataCommand& command) {}
+  virtual void Pre(RestoreContentDataCommand& command) { MarkDefaultHook(); }
+  virtual void Post(RestoreContentDataCommand& command) { MarkDefaultHook(); }
+
+  virtual void Pre(RestoreContentCachedDataCommand& command) { MarkDefaultHook(); }
+  virtual void Post(RestoreContentCachedDataCommand& command) { MarkDefaultHook(); }
 
   %for command in commands:
   <% define = get_define(command.platform) %>\
   % if define:
   #ifdef ${define}
   % endif
-  virtual void Pre(${command.name}Command& command) {}
-  virtual void Post(${command.name}Command& command) {}
+  virtual void Pre(${command.name}Command& command) { MarkDefaultHook(); }
+  virtual void Post(${command.name}Command& command) { MarkDefaultHook(); }
   % if define:
   #endif
   % endif
 
   %endfor
+protected:
+  static void MarkDefaultHook() {
+    DefaultHookCalled() = true;
+  }
+
 private:
   std::string m_Name;
 };
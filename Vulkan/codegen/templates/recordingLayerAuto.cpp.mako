@@ -23,7 +23,8 @@ namespace vulkan {
 void RecordingLayer::Post(${command.name}Command& command) {
   if (m_Range.InRange()) {
     m_Recorder.Record(${command.name}Serializer(command));
-  } else {
+  }
+  if (!m_Range.InRange() || m_Range.HasLaterRange()) {
     TrackCmdBuffer(command);
   }
 }
@@ -56,8 +56,8 @@ public:
 
 private:
   // Encode a vkCmd* command into the owning command buffer's recorded-commands
-  // log so it can be re-emitted verbatim during state restore.  Called when
-  // !m_Range.InRange() and the command buffer is still in recording state.
+  // log so it can be re-emitted verbatim during state restore.  Called outside
+  // the range, and inside it too when a later range will need another restore.
   template <typename TCommand>
   void TrackCmdBuffer(const TCommand& cmd) {
     if (!m_StateTracking) {
@@ -67,11 +67,9 @@ private:
     if (!state || !state->IsRecording) {
       return;
     }
+    // Encoded straight into the command buffer's arena: no per-command allocation.
     uint32_t sz = GetSize(cmd);
-    std::vector<char> buf(sz);
-    Encode(cmd, buf.data());
-    state->RecordedCommandIds.push_back(static_cast<CommandId>(cmd.GetId()));
-    state->RecordedCommands.push_back(std::move(buf));
+    Encode(cmd, state->RecordedCommands.Append(static_cast<CommandId>(cmd.GetId()), sz));
   }
 
   SubcaptureRecorder& m_Recorder;
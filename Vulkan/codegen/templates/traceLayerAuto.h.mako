@@ -63,6 +63,9 @@ public:
   void Pre(RestoreContentDataCommand& command) override;
   void Post(RestoreContentDataCommand& command) override;
 
+  void Pre(RestoreContentCachedDataCommand& command) override;
+  void Post(RestoreContentCachedDataCommand& command) override;
+
 protected:
   CommandPrinterState statePre_;
   CommandPrinterState statePost_;
@@ -35,6 +35,8 @@ stream::CommandRunner* VulkanCommandFactory::CreateCommand(unsigned id) {
     return new RestoreContentManifestRunner();
   case CommandId::ID_META_RESTORE_CONTENT_DATA:
     return new RestoreContentDataRunner();
+  case CommandId::ID_META_RESTORE_CONTENT_CACHED_DATA:
+    return new RestoreContentCachedDataRunner();
   % for command in commands:
   <% define = get_define(command.platform) %>\
   % if define:
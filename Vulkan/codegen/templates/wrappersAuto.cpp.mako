@@ -10,6 +10,7 @@ ${header}
 #include "wrappersAuto.h"
 #include "commandsAuto.h"
 #include "layerAuto.h"
+#include "layerDispatch.h"
 #include "captureManager.h"
 #include "handleArgumentUpdaters.h"
 
@@ -20,7 +21,19 @@ namespace vulkan {
 
 namespace {
 
-std::mutex g_Mutex;
+// Create/allocate and destroy/free wrappers are serialized per created or
+// destroyed handle type.  A driver may hand a destroyed handle value back to any
+// parent, and HandleMapService is keyed globally per type, so both halves of a
+// create/destroy pair must take the same mutex to keep UpdateOutputHandle and
+// RemoveHandle ordered.  Calls on unrelated handle types do not contend.
+// Commands that implicitly free the children of a pool also take the child
+// type mutex, always after the pool type one; no wrapper takes them the other
+// way round.
+template <typename THandle>
+std::mutex& GetHandleTypeMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
 
 } // namespace
 
@@ -44,11 +57,20 @@ define = get_define(command.platform)
 is_destroy_or_free = command.name.startswith('vkDestroy') or command.name.startswith('vkFree')
 is_create_or_allocate = command.name.startswith('vkCreate') or command.name.startswith('vkAllocate')
 destroy_target_name = None
-if is_destroy_or_free:
+lock_handle_type = None
+if is_destroy_or_free or is_create_or_allocate:
 	for p in reversed(command.params):
 		if p.is_handle:
-			destroy_target_name = p.name
+			if is_destroy_or_free:
+				destroy_target_name = p.name
+			lock_handle_type = p.base_type
 			break
+# Pool commands that free all the children allocated from the pool.
+implicit_free_child_type = {
+	'vkDestroyCommandPool': 'VkCommandBuffer',
+	'vkDestroyDescriptorPool': 'VkDescriptorSet',
+	'vkResetDescriptorPool': 'VkDescriptorSet',
+}.get(command.name)
 %>\
 ${command.return_type} ${command.name}Wrapper(
   % for param in command.params:
@@ -69,7 +91,10 @@ ${command.return_type} ${command.name}Wrapper(
 	  );
 
 	% if is_create_or_allocate or is_destroy_or_free:
-	std::lock_guard<std::mutex> lock(g_Mutex);
+	std::lock_guard<std::mutex> lock(GetHandleTypeMutex<${lock_handle_type or 'void'}>());
+	% endif
+	% if implicit_free_child_type:
+	std::lock_guard<std::mutex> childLock(GetHandleTypeMutex<${implicit_free_child_type}>());
 	% endif
 
 	% for param in command.params:
@@ -93,9 +118,8 @@ ${command.return_type} ${command.name}Wrapper(
 	% endif
 	% endfor
 
-	for (Layer* layer : manager.GetPreLayers()) {
-	  layer->Pre(command);
-	}
+	static LayerDispatch layerDispatch;
+	layerDispatch.Pre(manager.GetPreLayers(), command);
 
 	command.m_Key = manager.CreateCommandKey();
 	if (!command.m_Skip) {
@@ -147,9 +171,7 @@ ${command.return_type} ${command.name}Wrapper(
 	command.m_Return.Value = result;
 	% endif
 
-    for (Layer* layer : manager.GetPostLayers()) {
-	  layer->Post(command);
-	}
+	layerDispatch.Post(manager.GetPostLayers(), command);
 
 	% if command.name.startswith('vkDestroy') or command.name.startswith('vkFree'):
 <%
@@ -228,5 +228,33 @@ void Decode(char* src, RestoreContentDataCommand& command) {
   Decode(src, offset, command.m_Regions);
 }
 
+uint32_t GetSize(const RestoreContentCachedDataCommand& command) {
+  return GetSize(command.m_Key) + GetSize(command.m_ThreadId) + GetSize(command.m_DeviceKey) +
+         GetSize(command.m_Payload) + GetSize(command.m_Cached) + GetSize(command.m_Value) +
+         GetSize(command.m_Regions);
+}
+
+void Encode(const RestoreContentCachedDataCommand& command, char* dest) {
+  uint32_t offset = 0;
+  Encode(dest, offset, command.m_Key);
+  Encode(dest, offset, command.m_ThreadId);
+  Encode(dest, offset, command.m_DeviceKey);
+  Encode(dest, offset, command.m_Payload);
+  Encode(dest, offset, command.m_Cached);
+  Encode(dest, offset, command.m_Value);
+  Encode(dest, offset, command.m_Regions);
+}
+
+void Decode(char* src, RestoreContentCachedDataCommand& command) {
+  uint32_t offset = 0;
+  Decode(src, offset, command.m_Key);
+  Decode(src, offset, command.m_ThreadId);
+  Decode(src, offset, command.m_DeviceKey);
+  Decode(src, offset, command.m_Payload);
+  Decode(src, offset, command.m_Cached);
+  Decode(src, offset, command.m_Value);
+  Decode(src, offset, command.m_Regions);
+}
+
 } // namespace vulkan
 } // namespace gits
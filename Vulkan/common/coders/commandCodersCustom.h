@@ -37,5 +37,9 @@ uint32_t GetSize(const RestoreContentDataCommand& command);
 void Encode(const RestoreContentDataCommand& command, char* dest);
 void Decode(char* src, RestoreContentDataCommand& command);
 
+uint32_t GetSize(const RestoreContentCachedDataCommand& command);
+void Encode(const RestoreContentCachedDataCommand& command, char* dest);
+void Decode(char* src, RestoreContentCachedDataCommand& command);
+
 } // namespace vulkan
 } // namespace gits
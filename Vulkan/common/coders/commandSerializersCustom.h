@@ -117,5 +117,18 @@ public:
   }
 };
 
+class RestoreContentCachedDataSerializer : public stream::CommandSerializer {
+public:
+  RestoreContentCachedDataSerializer(RestoreContentCachedDataCommand& command) {
+    m_DataSize = GetSize(command);
+    m_Data.reset(new char[m_DataSize]);
+    Encode(command, m_Data.get());
+  }
+
+  uint32_t Id() const override {
+    return static_cast<uint32_t>(CommandId::ID_META_RESTORE_CONTENT_CACHED_DATA);
+  }
+};
+
 } // namespace vulkan
 } // namespace gits
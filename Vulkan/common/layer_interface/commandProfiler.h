@@ -0,0 +1,102 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace gits {
+namespace vulkan {
+
+// Stages a replayed command goes through.  Decode runs on the stream reader's
+// decompression threads, everything else on the replay thread.
+enum class CommandStage : unsigned {
+  Decode,
+  Remap, // handle remapping ahead of the Pre layers
+  PreLayers,
+  Driver,
+  PostLayers,
+  Count
+};
+
+constexpr unsigned kCommandStageCount = static_cast<unsigned>(CommandStage::Count);
+
+// Raw timestamp in profiler ticks: the TSC where available, nanoseconds otherwise.
+inline uint64_t ReadProfilerTicks() {
+#if defined(_M_X64) || defined(__x86_64__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+// Receives the per-stage ticks of every generated command runner while it is
+// installed.  A plugin layer provides one through Layer::GetCommandProfiler();
+// it is only called from the replay thread.
+class CommandProfiler {
+public:
+  virtual ~CommandProfiler() = default;
+  virtual void OnCommand(unsigned commandId,
+                         const char* commandName,
+                         const uint64_t (&ticks)[kCommandStageCount]) = 0;
+};
+
+inline CommandProfiler*& ActiveCommandProfiler() {
+  static CommandProfiler* profiler = nullptr;
+  return profiler;
+}
+
+// Stamps the stage boundaries of one command run.  Costs one predictable
+// branch per stage when no profiler is installed.
+class CommandProfileScope {
+public:
+  CommandProfileScope(unsigned commandId, const char* commandName, uint64_t decodeTicks)
+      : m_Profiler(ActiveCommandProfiler()), m_CommandId(commandId), m_CommandName(commandName) {
+    if (m_Profiler) {
+      m_Ticks[static_cast<unsigned>(CommandStage::Decode)] = decodeTicks;
+      m_Last = ReadProfilerTicks();
+    }
+  }
+  ~CommandProfileScope() {
+    if (m_Profiler) {
+      m_Profiler->OnCommand(m_CommandId, m_CommandName, m_Ticks);
+    }
+  }
+  CommandProfileScope(const CommandProfileScope&) = delete;
+  CommandProfileScope& operator=(const CommandProfileScope&) = delete;
+
+  // Closes `stage`: everything since the previous mark is attributed to it.
+  void Mark(CommandStage stage) {
+    if (m_Profiler) {
+      const uint64_t now = ReadProfilerTicks();
+      m_Ticks[static_cast<unsigned>(stage)] = now - m_Last;
+      m_Last = now;
+    }
+  }
+
+private:
+  CommandProfiler* m_Profiler{};
+  unsigned m_CommandId{};
+  const char* m_CommandName{};
+  uint64_t m_Last{};
+  uint64_t m_Ticks[kCommandStageCount]{};
+};
+
+} // namespace vulkan
+} // namespace gits
@@ -12,6 +12,9 @@
 #include "commandIdsAuto.h"
 #include "arguments.h"
 
+#include <deque>
+#include <unordered_map>
+
 namespace gits {
 namespace vulkan {
 
@@ -123,6 +126,18 @@ public:
 // order (buffer entries first, then image entries within a single manifest).
 // Each RestoreContentData region carries one resource's bytes keyed by that
 // index (Region.Offset reused as the resource index, not a byte offset).
+//
+// Payloads are content-addressed: a resource whose bytes are one repeated
+// 32-bit word is sent as a fill (no bytes), and a resource whose bytes equal an
+// earlier payload of the same manifest is sent as a reference to that payload's
+// hash.  These forms, and raw payloads that enter the cache, use the separate
+// RestoreContentCachedData token, so RestoreContentData keeps its original
+// layout and older streams replay unchanged; it stands in for one manifest
+// entry just like a RestoreContentData token.  The recorder only emits a
+// reference while the player is guaranteed to still hold the bytes: both sides
+// feed the same sequence of cached raw payloads through a
+// RestoreContentCacheIndex, whose bounded FIFO eviction is therefore identical
+// on both ends.
 // ---------------------------------------------------------------------------
 class RestoreContentManifestCommand : public Command {
 public:
@@ -167,5 +182,65 @@ public:
   MemoryRegions m_Regions{};
 };
 
+class RestoreContentCachedDataCommand : public Command {
+public:
+  enum class Payload : uint32_t {
+    Raw = 0,       // region carries the bytes
+    Fill = 1,      // region carries no bytes; m_Value holds the repeated 32-bit word
+    Reference = 2, // region carries no bytes; m_Value is the hash of a cached payload
+  };
+
+  RestoreContentCachedDataCommand(uint32_t threadId)
+      : Command{CommandId::ID_META_RESTORE_CONTENT_CACHED_DATA, threadId} {}
+  RestoreContentCachedDataCommand() : Command(CommandId::ID_META_RESTORE_CONTENT_CACHED_DATA) {}
+
+public:
+  uint64_t m_DeviceKey{0};
+  uint32_t m_Payload{static_cast<uint32_t>(Payload::Raw)};
+  // Raw only: the bytes enter the cache under m_Value, their hash.
+  uint32_t m_Cached{0};
+  uint64_t m_Value{0};
+  // As in RestoreContentDataCommand; Region.Size is 0 for fills and references.
+  MemoryRegions m_Regions{};
+};
+
+// Bookkeeping shared by the recorder and the player for RestoreContentData
+// references, scoped to one manifest.  Only the hashes and sizes live here;
+// the player keeps the bytes alongside and drops them when told to evict.
+class RestoreContentCacheIndex {
+public:
+  static constexpr uint64_t kMaxBytes = 64ull * 1024 * 1024;
+  static constexpr uint64_t kMaxEntryBytes = 8ull * 1024 * 1024;
+
+  bool Contains(uint64_t hash, uint64_t size) const {
+    auto it = m_Sizes.find(hash);
+    return it != m_Sizes.end() && it->second == size;
+  }
+
+  // Returns false (and records nothing) for payloads that are not cached.
+  template <typename OnEvict>
+  bool Insert(uint64_t hash, uint64_t size, OnEvict&& onEvict) {
+    if (size == 0 || size > kMaxEntryBytes || m_Sizes.count(hash) != 0) {
+      return false;
+    }
+    m_Order.push_back(hash);
+    m_Sizes[hash] = size;
+    m_Bytes += size;
+    while (m_Bytes > kMaxBytes) {
+      const uint64_t oldest = m_Order.front();
+      m_Order.pop_front();
+      m_Bytes -= m_Sizes[oldest];
+      m_Sizes.erase(oldest);
+      onEvict(oldest);
+    }
+    return true;
+  }
+
+private:
+  std::deque<uint64_t> m_Order;
+  std::unordered_map<uint64_t, uint64_t> m_Sizes;
+  uint64_t m_Bytes{0};
+};
+
 } // namespace vulkan
 } // namespace gits
@@ -10,36 +10,140 @@
 
 #include "dispatchTableAuto.h"
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <mutex>
-#include <shared_mutex>
 #include <unordered_map>
 
 namespace gits {
 namespace vulkan {
 
+// Dispatch tables keyed by the loader dispatch pointer stored in the first
+// word of every dispatchable handle.  A table is created once per VkInstance /
+// VkDevice and never destroyed, while it is looked up on every intercepted or
+// replayed call.  Published tables are therefore kept in a small open-addressed
+// array that readers probe without taking any lock; the owning map (and its
+// mutex) is touched only when a table is created or on a cache miss.
+template <typename Table>
+class DispatchTableMap {
+public:
+  DispatchTableMap() = default;
+  DispatchTableMap(const DispatchTableMap&) = delete;
+  DispatchTableMap& operator=(const DispatchTableMap&) = delete;
+
+  // Lock-free lookup of a published table.  Returns nullptr for an unknown key.
+  Table* Find(void* dispatchKey) const {
+    auto slot = HashSlot(dispatchKey);
+    for (std::size_t probe = 0; probe < kCapacity; ++probe) {
+      const auto& entry = m_Slots[(slot + probe) & (kCapacity - 1)];
+      void* key = entry.Key.load(std::memory_order_acquire);
+      if (key == dispatchKey) {
+        return entry.Value.load(std::memory_order_acquire);
+      }
+      if (key == nullptr) {
+        break;
+      }
+    }
+    if (!m_Overflow.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_Tables.find(dispatchKey);
+    return it != m_Tables.end() && it->second.Published ? it->second.Storage.get() : nullptr;
+  }
+
+  // Returns the table for dispatchKey, creating (and publishing) an empty one
+  // on a miss.
+  Table& Get(void* dispatchKey) {
+    if (auto* table = Find(dispatchKey)) {
+      return *table;
+    }
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto& entry = GetEntryLocked(dispatchKey);
+    PublishLocked(dispatchKey, entry);
+    return *entry.Storage;
+  }
+
+  // Returns the table for dispatchKey without making it visible to Find.  Used
+  // while the table is being filled, before Publish is called.
+  Table& Create(void* dispatchKey) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return *GetEntryLocked(dispatchKey).Storage;
+  }
+
+  void Publish(void* dispatchKey) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    PublishLocked(dispatchKey, GetEntryLocked(dispatchKey));
+  }
+
+private:
+  static constexpr std::size_t kCapacity = 64;
+
+  struct Slot {
+    std::atomic<void*> Key{nullptr};
+    std::atomic<Table*> Value{nullptr};
+  };
+
+  struct Entry {
+    std::unique_ptr<Table> Storage;
+    bool Published{false};
+  };
+
+  static std::size_t HashSlot(void* dispatchKey) {
+    auto value = reinterpret_cast<std::uintptr_t>(dispatchKey);
+    return static_cast<std::size_t>((value >> 4) * 0x9E3779B97F4A7C15ull >> 58) &
+           (kCapacity - 1);
+  }
+
+  Entry& GetEntryLocked(void* dispatchKey) {
+    auto& entry = m_Tables[dispatchKey];
+    if (!entry.Storage) {
+      entry.Storage = std::make_unique<Table>();
+    }
+    return entry;
+  }
+
+  void PublishLocked(void* dispatchKey, Entry& entry) {
+    if (entry.Published) {
+      return;
+    }
+    entry.Published = true;
+    auto slot = HashSlot(dispatchKey);
+    for (std::size_t probe = 0; probe < kCapacity; ++probe) {
+      auto& candidate = m_Slots[(slot + probe) & (kCapacity - 1)];
+      if (candidate.Key.load(std::memory_order_relaxed) == nullptr) {
+        // Value must be visible before readers can match the key.
+        candidate.Value.store(entry.Storage.get(), std::memory_order_release);
+        candidate.Key.store(dispatchKey, std::memory_order_release);
+        return;
+      }
+    }
+    m_Overflow.store(true, std::memory_order_release);
+  }
+
+  std::array<Slot, kCapacity> m_Slots{};
+  std::atomic<bool> m_Overflow{false};
+  mutable std::mutex m_Mutex;
+  std::unordered_map<void*, Entry> m_Tables;
+};
+
 // Thread-safe wrapper around the instance and device dispatch tables.
 // Shared between CaptureManager and layers that need dispatch access.
 class DispatchTablesHolder {
 public:
-  DispatchTablesHolder(
-      std::unordered_map<void*, VkInstanceLevelDispatchTable>& instanceDispatchTables,
-      std::unordered_map<void*, VkDeviceLevelDispatchTable>& deviceDispatchTables,
-      std::shared_mutex& mutex)
+  DispatchTablesHolder(DispatchTableMap<VkInstanceLevelDispatchTable>& instanceDispatchTables,
+                       DispatchTableMap<VkDeviceLevelDispatchTable>& deviceDispatchTables)
       : m_InstanceDispatchTables(instanceDispatchTables),
-        m_DeviceDispatchTables(deviceDispatchTables),
-        m_Mutex(mutex) {}
+        m_DeviceDispatchTables(deviceDispatchTables) {}
 
   // Pass dispatchable instance level handle:
   // VkInstance, VkPhysicalDevice, VkSurfaceKHR, etc.
   template <typename Handle>
   VkInstanceLevelDispatchTable* GetInstanceDispatchTable(Handle handle) {
     void* dispatchKey = *reinterpret_cast<void**>(handle);
-    std::shared_lock lock(m_Mutex);
-    auto it = m_InstanceDispatchTables.find(dispatchKey);
-    if (it == m_InstanceDispatchTables.end()) {
-      return nullptr;
-    }
-    return &it->second;
+    return m_InstanceDispatchTables.Find(dispatchKey);
   }
 
   // Pass dispatchable device level handle:
@@ -47,18 +151,12 @@ public:
   template <typename Handle>
   VkDeviceLevelDispatchTable* GetDeviceDispatchTable(Handle handle) {
     void* dispatchKey = *reinterpret_cast<void**>(handle);
-    std::shared_lock lock(m_Mutex);
-    auto it = m_DeviceDispatchTables.find(dispatchKey);
-    if (it == m_DeviceDispatchTables.end()) {
-      return nullptr;
-    }
-    return &it->second;
+    return m_DeviceDispatchTables.Find(dispatchKey);
   }
 
 private:
-  std::unordered_map<void*, VkInstanceLevelDispatchTable>& m_InstanceDispatchTables;
-  std::unordered_map<void*, VkDeviceLevelDispatchTable>& m_DeviceDispatchTables;
-  std::shared_mutex& m_Mutex;
+  DispatchTableMap<VkInstanceLevelDispatchTable>& m_InstanceDispatchTables;
+  DispatchTableMap<VkDeviceLevelDispatchTable>& m_DeviceDispatchTables;
 };
 
 } // namespace vulkan
@@ -0,0 +1,69 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#pragma once
+
+#include "layerAuto.h"
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace gits {
+namespace vulkan {
+
+// Per-command dispatch list over a fixed, registration-ordered layer vector.
+// A layer whose Pre/Post for the command is the Layer default is detected on
+// its first call (see Layer::DefaultHookCalled) and never called again for
+// that command, so each command only pays for the layers that implement it.
+// The layer vectors must not be reordered after the first dispatch. Layers
+// beyond the first 64 are always called.
+class LayerDispatch {
+public:
+  template <typename Command>
+  void Pre(const std::vector<Layer*>& layers, Command& command) {
+    Dispatch(layers, m_SkippedPre, [&command](Layer* layer) { layer->Pre(command); });
+  }
+
+  template <typename Command>
+  void Post(const std::vector<Layer*>& layers, Command& command) {
+    Dispatch(layers, m_SkippedPost, [&command](Layer* layer) { layer->Post(command); });
+  }
+
+private:
+  static constexpr size_t kMaskBits = 64;
+
+  template <typename Call>
+  static void Dispatch(const std::vector<Layer*>& layers,
+                       std::atomic<uint64_t>& skipped,
+                       Call&& call) {
+    const size_t count = layers.size();
+    const uint64_t all = count >= kMaskBits ? ~uint64_t{0} : (uint64_t{1} << count) - 1;
+    uint64_t active = all & ~skipped.load(std::memory_order_relaxed);
+    while (active) {
+      const size_t idx = std::countr_zero(active);
+      active &= active - 1;
+      bool& defaultHook = Layer::DefaultHookCalled();
+      defaultHook = false;
+      call(layers[idx]);
+      if (defaultHook) {
+        skipped.fetch_or(uint64_t{1} << idx, std::memory_order_relaxed);
+      }
+    }
+    for (size_t idx = kMaskBits; idx < count; ++idx) {
+      call(layers[idx]);
+    }
+  }
+
+  std::atomic<uint64_t> m_SkippedPre{0};
+  std::atomic<uint64_t> m_SkippedPost{0};
+};
+
+} // namespace vulkan
+} // namespace gits
@@ -13,27 +13,35 @@
 namespace gits {
 namespace vulkan {
 
-void HandleMapService::SetKeyLocked(std::size_t typeIndex, uint64_t handle, GITSKey key) {
-  auto& bucket = m_ByType[typeIndex];
-  bucket.HandleToKey[handle] = key;
+HandleMapService::~HandleMapService() {
+  for (auto& page : m_KeyPages) {
+    delete page.load(std::memory_order_relaxed);
+  }
+}
+
+void HandleMapService::SetKeyImpl(std::size_t typeIndex, uint64_t handle, GITSKey key) {
+  auto& shard = GetShard(typeIndex, handle);
+  std::unique_lock<std::shared_mutex> lock(shard.Mutex);
+  shard.HandleToKey[handle] = key;
   // Maintain audit trail so GetKey / GetKeyLenient can classify misses as
   // use-after-destroy vs never-registered.
-  bucket.EverRegistered.insert(handle);
-  bucket.RemovedHandles.erase(handle);
+  shard.EverRegistered.insert(handle);
+  shard.RemovedHandles.erase(handle);
 }
 
-GITSKey HandleMapService::GetKeyLocked(std::size_t typeIndex, uint64_t handle) {
-  auto& bucket = m_ByType[typeIndex];
-  auto it = bucket.HandleToKey.find(handle);
-  if (it == bucket.HandleToKey.end()) {
+GITSKey HandleMapService::GetKeyImpl(std::size_t typeIndex, uint64_t handle) {
+  auto& shard = GetShard(typeIndex, handle);
+  std::shared_lock<std::shared_mutex> lock(shard.Mutex);
+  auto it = shard.HandleToKey.find(handle);
+  if (it == shard.HandleToKey.end()) {
     // GetKey is used at sites that are supposed to hold a locally-guaranteed
     // invariant (output-handle path, HasKey-then-GetKey guarded lookups, ...).
     // A miss here is therefore a real bug; classify it before asserting so
     // the crash log says what kind.  Codegen-generated CollectHandleKeys must
     // call GetKeyLenient instead (see header).
-    const bool wasRegistered = bucket.EverRegistered.count(handle) != 0;
-    auto removedIt = bucket.RemovedHandles.find(handle);
-    if (removedIt != bucket.RemovedHandles.end()) {
+    const bool wasRegistered = shard.EverRegistered.count(handle) != 0;
+    auto removedIt = shard.RemovedHandles.find(handle);
+    if (removedIt != shard.RemovedHandles.end()) {
       LOG_ERROR << "HandleMapService::GetKey: handle=0x" << std::hex << handle << std::dec
                 << " missing -- previously REMOVED (last key=" << removedIt->second
                 << "). Use-after-destroy at a strict GetKey site.";
@@ -47,15 +55,25 @@ GITSKey HandleMapService::GetKeyLocked(std::size_t typeIndex, uint64_t handle) {
                    "was not intercepted (untracked extension path or garbage value).";
     }
   }
-  GITS_ASSERT(it != bucket.HandleToKey.end());
+  GITS_ASSERT(it != shard.HandleToKey.end());
   return it->second;
 }
 
-GITSKey HandleMapService::GetKeyLenientLocked(std::size_t typeIndex, uint64_t handle) {
-  auto& bucket = m_ByType[typeIndex];
-  auto it = bucket.HandleToKey.find(handle);
-  if (it != bucket.HandleToKey.end()) {
-    return it->second;
+GITSKey HandleMapService::TryGetKeyImpl(std::size_t typeIndex, uint64_t handle) {
+  auto& shard = GetShard(typeIndex, handle);
+  std::shared_lock<std::shared_mutex> lock(shard.Mutex);
+  auto it = shard.HandleToKey.find(handle);
+  return it != shard.HandleToKey.end() ? it->second : 0;
+}
+
+GITSKey HandleMapService::GetKeyLenientImpl(std::size_t typeIndex, uint64_t handle) {
+  auto& shard = GetShard(typeIndex, handle);
+  {
+    std::shared_lock<std::shared_mutex> lock(shard.Mutex);
+    auto it = shard.HandleToKey.find(handle);
+    if (it != shard.HandleToKey.end()) {
+      return it->second;
+    }
   }
 
   // Miss: warn once per unique handle and return 0.  Treating the slot as
@@ -63,15 +81,22 @@ GITSKey HandleMapService::GetKeyLenientLocked(std::size_t typeIndex, uint64_t ha
   // renderPass on a graphics pipeline library link pipeline).  If the slot is
   // actually load-bearing the downstream API call will fail in both original
   // capture and replay, with the warning logged here pointing the way.
-  if (bucket.LenientWarned.insert(handle).second) {
-    auto removedIt = bucket.RemovedHandles.find(handle);
-    if (removedIt != bucket.RemovedHandles.end()) {
+  std::unique_lock<std::shared_mutex> lock(shard.Mutex);
+  // The handle may have been registered between dropping the shared lock and
+  // taking the exclusive one.
+  auto it = shard.HandleToKey.find(handle);
+  if (it != shard.HandleToKey.end()) {
+    return it->second;
+  }
+  if (shard.LenientWarned.insert(handle).second) {
+    auto removedIt = shard.RemovedHandles.find(handle);
+    if (removedIt != shard.RemovedHandles.end()) {
       LOG_WARNING << "HandleMapService::GetKeyLenient: handle=0x" << std::hex << handle << std::dec
                   << " was previously destroyed (last key=" << removedIt->second
                   << "). Recording as VK_NULL_HANDLE. Expected for fields the driver "
                      "ignores (e.g. renderPass on GPL link pipelines); investigate if "
                      "the field is supposed to be consumed.";
-    } else if (bucket.EverRegistered.count(handle) != 0) {
+    } else if (shard.EverRegistered.count(handle) != 0) {
       LOG_WARNING << "HandleMapService::GetKeyLenient: handle=0x" << std::hex << handle << std::dec
                   << " was registered earlier but is no longer mapped (no "
                      "RemoveHandle on record). Recording as VK_NULL_HANDLE.";
@@ -85,41 +110,42 @@ GITSKey HandleMapService::GetKeyLenientLocked(std::size_t typeIndex, uint64_t ha
   return 0;
 }
 
-void HandleMapService::RemoveHandleLocked(std::size_t typeIndex, uint64_t handle) {
-  auto& bucket = m_ByType[typeIndex];
-  auto it = bucket.HandleToKey.find(handle);
-  if (it == bucket.HandleToKey.end()) {
-    return;
+void HandleMapService::RemoveHandleImpl(std::size_t typeIndex, uint64_t handle) {
+  GITSKey removedKey = 0;
+  {
+    auto& shard = GetShard(typeIndex, handle);
+    std::unique_lock<std::shared_mutex> lock(shard.Mutex);
+    auto it = shard.HandleToKey.find(handle);
+    if (it == shard.HandleToKey.end()) {
+      return;
+    }
+    removedKey = it->second;
+    // Remember the handle (and the key it had) so a later GetKey / GetKeyLenient
+    // miss can report a precise use-after-destroy.  No per-call log spam.
+    shard.RemovedHandles[handle] = removedKey;
+    shard.HandleToKey.erase(it);
   }
-  const GITSKey removedKey = it->second;
-  // Remember the handle (and the key it had) so a later GetKey / GetKeyLenient
-  // miss can report a precise use-after-destroy.  No per-call log spam.
-  bucket.RemovedHandles[handle] = removedKey;
   // Remove the reverse mapping only if it still points at this handle.
   // SetHandle / SetKey are populated independently and the player side may
   // register a key->handle entry that should not be wiped just because the
   // capture side dropped the forward mapping for an unrelated handle that
   // happens to share the same key value.
-  auto reverseIt = m_KeyToHandle.find(removedKey);
-  if (reverseIt != m_KeyToHandle.end() && reverseIt->second == handle) {
-    m_KeyToHandle.erase(reverseIt);
-  }
-  bucket.HandleToKey.erase(it);
+  EraseHandleIfMatches(removedKey, handle);
 }
 
 GITSKey HandleMapService::GetKeyLenient(uint64_t handle) {
   if (!handle) {
     return 0;
   }
-  std::lock_guard<std::mutex> lock(m_Mutex);
   // The concrete object type is unknown here, so scan every bucket.  Only rare
   // debug-label/tag paths take this route (see header).
-  for (auto& bucket : m_ByType) {
-    auto it = bucket.HandleToKey.find(handle);
-    if (it != bucket.HandleToKey.end()) {
-      return it->second;
+  for (std::size_t typeIndex = 0; typeIndex < kHandleTypeCount; ++typeIndex) {
+    GITSKey key = TryGetKeyImpl(typeIndex, handle);
+    if (key) {
+      return key;
     }
   }
+  std::lock_guard<std::mutex> lock(m_TypeErasedMutex);
   if (m_TypeErasedLenientWarned.insert(handle).second) {
     LOG_WARNING << "HandleMapService::GetKeyLenient: type-erased handle=0x" << std::hex << handle
                 << std::dec
@@ -129,22 +155,88 @@ GITSKey HandleMapService::GetKeyLenient(uint64_t handle) {
   return 0;
 }
 
+HandleMapService::KeyPage& HandleMapService::GetOrCreatePage(GITSKey key) {
+  auto& slot = m_KeyPages[key >> kPageBits];
+  KeyPage* page = slot.load(std::memory_order_acquire);
+  if (page) {
+    return *page;
+  }
+  auto* newPage = new KeyPage();
+  if (slot.compare_exchange_strong(page, newPage, std::memory_order_acq_rel)) {
+    return *newPage;
+  }
+  // Another thread installed the page first.
+  delete newPage;
+  return *page;
+}
+
+bool HandleMapService::LookupHandle(GITSKey key, uint64_t& out) {
+  if ((key >> kPageBits) < kMaxPages) {
+    const KeyPage* page = FindPage(key);
+    if (!page) {
+      return false;
+    }
+    const auto idx = key & (kPageSize - 1);
+    const auto bit = uint64_t{1} << (idx % 64);
+    if (!(page->Mapped[idx / 64].load(std::memory_order_acquire) & bit)) {
+      return false;
+    }
+    out = page->Handles[idx].load(std::memory_order_relaxed);
+    return true;
+  }
+  std::lock_guard<std::mutex> lock(m_SparseMutex);
+  auto it = m_SparseKeyToHandle.find(key);
+  if (it == m_SparseKeyToHandle.end()) {
+    return false;
+  }
+  out = it->second;
+  return true;
+}
+
+void HandleMapService::EraseHandleIfMatches(GITSKey key, uint64_t handle) {
+  if ((key >> kPageBits) < kMaxPages) {
+    KeyPage* page = FindPage(key);
+    if (!page) {
+      return;
+    }
+    const auto idx = key & (kPageSize - 1);
+    const auto bit = uint64_t{1} << (idx % 64);
+    if ((page->Mapped[idx / 64].load(std::memory_order_acquire) & bit) &&
+        page->Handles[idx].load(std::memory_order_relaxed) == handle) {
+      page->Mapped[idx / 64].fetch_and(~bit, std::memory_order_acq_rel);
+    }
+    return;
+  }
+  std::lock_guard<std::mutex> lock(m_SparseMutex);
+  auto it = m_SparseKeyToHandle.find(key);
+  if (it != m_SparseKeyToHandle.end() && it->second == handle) {
+    m_SparseKeyToHandle.erase(it);
+  }
+}
+
 void HandleMapService::SetHandle(GITSKey key, uint64_t handle) {
-  std::lock_guard<std::mutex> lock(m_Mutex);
-  m_KeyToHandle[key] = handle;
+  if ((key >> kPageBits) < kMaxPages) {
+    auto& page = GetOrCreatePage(key);
+    const auto idx = key & (kPageSize - 1);
+    page.Handles[idx].store(handle, std::memory_order_relaxed);
+    page.Mapped[idx / 64].fetch_or(uint64_t{1} << (idx % 64), std::memory_order_release);
+    return;
+  }
+  std::lock_guard<std::mutex> lock(m_SparseMutex);
+  m_SparseKeyToHandle[key] = handle;
 }
 
 uint64_t HandleMapService::GetHandle(GITSKey key) {
-  std::lock_guard<std::mutex> lock(m_Mutex);
-  auto it = m_KeyToHandle.find(key);
-  GITS_ASSERT(it != m_KeyToHandle.end());
-  return it->second;
+  uint64_t handle = 0;
+  const bool found = LookupHandle(key, handle);
+  GITS_ASSERT(found);
+  return handle;
 }
 
 uint64_t HandleMapService::TryGetHandle(GITSKey key) {
-  std::lock_guard<std::mutex> lock(m_Mutex);
-  auto it = m_KeyToHandle.find(key);
-  return it != m_KeyToHandle.end() ? it->second : 0;
+  uint64_t handle = 0;
+  LookupHandle(key, handle);
+  return handle;
 }
 
 } // namespace vulkan
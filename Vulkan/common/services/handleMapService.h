@@ -13,10 +13,12 @@
 #include "tools.h"
 
 #include <array>
+#include <atomic>
 #include <cstdint>
 #include <unordered_map>
 #include <unordered_set>
 #include <mutex>
+#include <shared_mutex>
 
 namespace gits {
 namespace vulkan {
@@ -33,8 +35,18 @@ namespace vulkan {
 // constant per handle type (HandleTypeIndex<T>()), so there is no per-call type
 // dispatch and lookups stay O(1).
 //
-// The player direction (key -> handle) stays a single map because GITSKeys are
-// globally unique by construction.
+// Every bucket is further split into kShardCount shards selected by a hash of
+// the handle value, each guarded by its own shared_mutex.  Lookups (the vast
+// majority of calls: every handle argument of every intercepted command) only
+// take a shared lock, and creates/destroys on different types or shards do not
+// contend with each other.
+//
+// The player direction (key -> handle) is a single table because GITSKeys are
+// globally unique by construction.  Keys are handed out by a monotonic counter
+// during recording, so the table is a paged array indexed by the key and a
+// lookup is one indexed load without any lock.  Keys outside of the paged range
+// (e.g. the subcapture synthetic keys counting down from UINT64_MAX) fall back
+// to a mutex-guarded hash map.
 class HandleMapService : public gits::noncopyable {
 public:
   static HandleMapService& Get() {
@@ -46,14 +58,12 @@ public:
 
   template <typename T>
   void SetKey(T handle, GITSKey key) {
-    std::lock_guard<std::mutex> lock(m_Mutex);
-    SetKeyLocked(HandleTypeIndex<T>(), reinterpret_cast<uint64_t>(handle), key);
+    SetKeyImpl(HandleTypeIndex<T>(), reinterpret_cast<uint64_t>(handle), key);
   }
 
   template <typename T>
   GITSKey GetKey(T handle) {
-    std::lock_guard<std::mutex> lock(m_Mutex);
-    return GetKeyLocked(HandleTypeIndex<T>(), reinterpret_cast<uint64_t>(handle));
+    return GetKeyImpl(HandleTypeIndex<T>(), reinterpret_cast<uint64_t>(handle));
   }
 
   // Lenient variant used by codegen-generated CollectHandleKeys /
@@ -74,8 +84,7 @@ public:
     if (!handle) {
       return 0;
     }
-    std::lock_guard<std::mutex> lock(m_Mutex);
-    return GetKeyLenientLocked(HandleTypeIndex<T>(), reinterpret_cast<uint64_t>(handle));
+    return GetKeyLenientImpl(HandleTypeIndex<T>(), reinterpret_cast<uint64_t>(handle));
   }
 
   // Overload for objecttype-tagged uint64 handles (e.g.
@@ -88,19 +97,14 @@ public:
 
   template <typename T>
   bool HasKey(T handle) {
-    std::lock_guard<std::mutex> lock(m_Mutex);
-    const auto& bucket = m_ByType[HandleTypeIndex<T>()];
-    return bucket.HandleToKey.find(reinterpret_cast<uint64_t>(handle)) != bucket.HandleToKey.end();
+    return TryGetKeyImpl(HandleTypeIndex<T>(), reinterpret_cast<uint64_t>(handle)) != 0;
   }
 
   // Returns the key for handle, or 0 if the handle is not mapped.
   // Use instead of GetKey when the handle may not be registered.
   template <typename T>
   GITSKey TryGetKey(T handle) {
-    std::lock_guard<std::mutex> lock(m_Mutex);
-    const auto& bucket = m_ByType[HandleTypeIndex<T>()];
-    auto it = bucket.HandleToKey.find(reinterpret_cast<uint64_t>(handle));
-    return it != bucket.HandleToKey.end() ? it->second : 0;
+    return TryGetKeyImpl(HandleTypeIndex<T>(), reinterpret_cast<uint64_t>(handle));
   }
 
   // Erase a handle's mapping.  Must be invoked from every vkDestroy* / vkFree*
@@ -117,8 +121,7 @@ public:
     if (!handle) {
       return;
     }
-    std::lock_guard<std::mutex> lock(m_Mutex);
-    RemoveHandleLocked(HandleTypeIndex<T>(), reinterpret_cast<uint64_t>(handle));
+    RemoveHandleImpl(HandleTypeIndex<T>(), reinterpret_cast<uint64_t>(handle));
   }
 
   // ---- Player direction: key -> handle (GITSKeys are globally unique). ----
@@ -132,12 +135,13 @@ public:
 
 private:
   HandleMapService() = default;
-  ~HandleMapService() = default;
+  ~HandleMapService();
 
   // Per-object-type handle->key store plus the audit trail used to classify
   // GetKey / GetKeyLenient misses (use-after-destroy vs never-registered).
   // Cost is bounded by the number of distinct Vulkan objects created per type.
-  struct HandleBucket {
+  struct HandleShard {
+    std::shared_mutex Mutex;
     std::unordered_map<uint64_t, GITSKey> HandleToKey;
     std::unordered_set<uint64_t> EverRegistered;
     // Handles removed via RemoveHandle, mapped to the key they had at removal.
@@ -147,16 +151,53 @@ private:
     std::unordered_set<uint64_t> LenientWarned;
   };
 
-  void SetKeyLocked(std::size_t typeIndex, uint64_t handle, GITSKey key);
-  GITSKey GetKeyLocked(std::size_t typeIndex, uint64_t handle);
-  GITSKey GetKeyLenientLocked(std::size_t typeIndex, uint64_t handle);
-  void RemoveHandleLocked(std::size_t typeIndex, uint64_t handle);
+  static constexpr std::size_t kShardCount = 16;
+  struct HandleBucket {
+    std::array<HandleShard, kShardCount> Shards;
+  };
+
+  HandleShard& GetShard(std::size_t typeIndex, uint64_t handle) {
+    // Handles are usually pointers or driver-side indices with low-entropy low
+    // bits; a multiplicative hash spreads them over the shards.
+    const auto shard = (handle * 0x9E3779B97F4A7C15ull) >> 60;
+    static_assert(kShardCount == 16, "shard selection assumes 16 shards");
+    return m_ByType[typeIndex].Shards[shard];
+  }
+
+  void SetKeyImpl(std::size_t typeIndex, uint64_t handle, GITSKey key);
+  GITSKey GetKeyImpl(std::size_t typeIndex, uint64_t handle);
+  GITSKey TryGetKeyImpl(std::size_t typeIndex, uint64_t handle);
+  GITSKey GetKeyLenientImpl(std::size_t typeIndex, uint64_t handle);
+  void RemoveHandleImpl(std::size_t typeIndex, uint64_t handle);
+
+  // Player-side key->handle table.  A page holds kPageSize consecutive keys and
+  // is allocated on first SetHandle into its range.  The mapped bits keep
+  // "mapped to 0" distinguishable from "not mapped".
+  static constexpr std::size_t kPageBits = 12;
+  static constexpr std::size_t kPageSize = std::size_t{1} << kPageBits;
+  static constexpr std::size_t kMaxPages = std::size_t{1} << 14;
+  struct KeyPage {
+    std::array<std::atomic<uint64_t>, kPageSize> Handles{};
+    std::array<std::atomic<uint64_t>, kPageSize / 64> Mapped{};
+  };
+
+  KeyPage* FindPage(GITSKey key) const {
+    return m_KeyPages[key >> kPageBits].load(std::memory_order_acquire);
+  }
+  KeyPage& GetOrCreatePage(GITSKey key);
+  // Returns true and stores the handle in out when key is mapped.
+  bool LookupHandle(GITSKey key, uint64_t& out);
+  void EraseHandleIfMatches(GITSKey key, uint64_t handle);
 
-  std::mutex m_Mutex;
   std::array<HandleBucket, kHandleTypeCount> m_ByType;
-  std::unordered_map<GITSKey, uint64_t> m_KeyToHandle;
+
+  std::array<std::atomic<KeyPage*>, kMaxPages> m_KeyPages{};
+  std::mutex m_SparseMutex;
+  std::unordered_map<GITSKey, uint64_t> m_SparseKeyToHandle;
+
   // Dedup set for the type-erased GetKeyLenient(uint64_t) overload, which has no
   // per-type bucket to record its one-shot warnings in.
+  std::mutex m_TypeErasedMutex;
   std::unordered_set<uint64_t> m_TypeErasedLenientWarned;
 };
 
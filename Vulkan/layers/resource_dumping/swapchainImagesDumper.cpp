@@ -10,15 +10,48 @@
 #include "dispatchTableAuto.h"
 #include "configurator.h"
 #include "log.h"
+#include "tools.h"
 
+// A private copy of stb_image_write, so that the PNG settings below do not
+// change the ones used by other image writers in the process.
+#define STB_IMAGE_WRITE_STATIC
+#define STB_IMAGE_WRITE_IMPLEMENTATION
 #include <stb_image_write.h>
 #include <algorithm>
 #include <cstring>
 #include <cerrno>
+#include <filesystem>
 
 namespace gits {
 namespace vulkan {
 
+namespace {
+
+// Copies pixelCount 32-bit pixels, swapping the R and B channels if requested
+// and forcing opaque alpha, in a single pass over whole pixels that compilers
+// vectorize. src may be uncached mapped memory: it is read once, sequentially.
+void ConvertToOpaqueRGBA(const uint8_t* src, uint8_t* dst, size_t pixelCount, bool swapRB) {
+  constexpr uint32_t opaqueAlpha = 0xFF000000u;
+  if (swapRB) {
+    for (size_t i = 0; i < pixelCount; ++i) {
+      uint32_t pixel;
+      std::memcpy(&pixel, src + i * sizeof(pixel), sizeof(pixel));
+      pixel = (pixel & 0x0000FF00u) | ((pixel & 0x000000FFu) << 16) |
+              ((pixel & 0x00FF0000u) >> 16) | opaqueAlpha;
+      std::memcpy(dst + i * sizeof(pixel), &pixel, sizeof(pixel));
+    }
+  } else {
+    for (size_t i = 0; i < pixelCount; ++i) {
+      uint32_t pixel;
+      std::memcpy(&pixel, src + i * sizeof(pixel), sizeof(pixel));
+      pixel |= opaqueAlpha;
+      std::memcpy(dst + i * sizeof(pixel), &pixel, sizeof(pixel));
+    }
+  }
+}
+
+} // namespace
+
 SwapchainImagesDumper::SwapchainImagesDumper(VkDevice device,
                                              const VkSwapchainCreateInfoKHR& swapchainCreateInfo,
                                              const VkPhysicalDeviceMemoryProperties& memProperties,
@@ -37,6 +70,19 @@ SwapchainImagesDumper::SwapchainImagesDumper(VkDevice device,
               << static_cast<int>(m_Format)
               << ". Only 4-component RGBA/BGRA formats are supported for screenshot dumping.";
   }
+
+  if (Configurator::Get().common.shared.screenshots.fastPngEncoding) {
+    // Set once, before any worker thread encodes.  stb_image_write never
+    // searches less than at level 5; a fixed Paeth filter avoids filtering
+    // every row five times to pick the best filter.
+    static std::once_flag fastPngEncodingSet;
+    std::call_once(fastPngEncodingSet, [] {
+      constexpr int fastCompressionLevel = 5;
+      constexpr int paethFilter = 4;
+      stbi_write_png_compression_level = fastCompressionLevel;
+      stbi_write_force_png_filter = paethFilter;
+    });
+  }
 }
 
 void SwapchainImagesDumper::AllocateBuffers(const std::vector<uint32_t>& queueFamilyIndices) {
@@ -345,6 +391,10 @@ void SwapchainImagesDumper::DumpStagedFrame(StagedFrame& stagedFrame, const std:
       m_DispatchTable.vkMapMemory(m_Device, stagedFrame.StagingMemory, 0, VK_WHOLE_SIZE, 0, &data);
   GITS_ASSERT(result == VK_SUCCESS);
 
+  bool isBGR = (m_Format == VK_FORMAT_B8G8R8A8_UNORM || m_Format == VK_FORMAT_B8G8R8A8_SRGB ||
+                m_Format == VK_FORMAT_B8G8R8A8_SNORM);
+  const size_t pixelCount = static_cast<size_t>(m_Width) * m_Height;
+
   std::vector<uint8_t> localCopy;
   uint8_t* pixels = nullptr;
 
@@ -352,35 +402,25 @@ void SwapchainImagesDumper::DumpStagedFrame(StagedFrame& stagedFrame, const std:
     pixels = static_cast<uint8_t*>(data);
   } else {
     // Make a local copy of GPU data to improve performance
-    const size_t imageSize = m_Width * m_Height * BYTES_PER_PIXEL;
-    localCopy.resize(imageSize);
-    std::memcpy(localCopy.data(), data, imageSize);
+    localCopy.resize(pixelCount * BYTES_PER_PIXEL);
     pixels = localCopy.data();
   }
+  ConvertToOpaqueRGBA(static_cast<const uint8_t*>(data), pixels, pixelCount, isBGR);
 
-  bool isBGR = (m_Format == VK_FORMAT_B8G8R8A8_UNORM || m_Format == VK_FORMAT_B8G8R8A8_SRGB ||
-                m_Format == VK_FORMAT_B8G8R8A8_SNORM);
-
-  if (isBGR) {
-    for (uint32_t i = 0; i < m_Width * m_Height; ++i) {
-      std::swap(pixels[i * BYTES_PER_PIXEL + 0], pixels[i * BYTES_PER_PIXEL + 2]);
-    }
-  }
-
-  // Force opaque alpha
-  for (uint32_t i = 0; i < m_Width * m_Height; ++i) {
-    pixels[i * BYTES_PER_PIXEL + 3] = 0xFF;
+  const bool isPng = Configurator::Get().common.shared.screenshots.format == ImageFormat::PNG;
+  const std::string filename = dumpName + (isPng ? ".png" : ".jpg");
+  const uint64_t hash = ComputeHash(pixels, pixelCount * BYTES_PER_PIXEL, THashType::XX);
+  if (LinkToLastFrame(hash, filename)) {
+    m_DispatchTable.vkUnmapMemory(m_Device, stagedFrame.StagingMemory);
+    return;
   }
 
   int saved = 0;
-  std::string filename;
-  if (Configurator::Get().common.shared.screenshots.format == ImageFormat::PNG) {
-    filename = dumpName + ".png";
+  if (isPng) {
     // Note: stb image does not embed SRGB chunk, but it should work fine in most image viewers
     saved = stbi_write_png(filename.c_str(), static_cast<int>(m_Width), static_cast<int>(m_Height),
                            BYTES_PER_PIXEL, pixels, static_cast<int>(m_Width * BYTES_PER_PIXEL));
   } else {
-    filename = dumpName + ".jpg";
     constexpr int jpegQuality = 95;
     saved = stbi_write_jpg(filename.c_str(), static_cast<int>(m_Width), static_cast<int>(m_Height),
                            BYTES_PER_PIXEL, pixels, jpegQuality);
@@ -389,10 +429,34 @@ void SwapchainImagesDumper::DumpStagedFrame(StagedFrame& stagedFrame, const std:
   if (!saved) {
     LOG_ERROR << "ScreenshotLayer: failed to write file: " << filename << " errno=" << errno << " ("
               << std::strerror(errno) << ")";
+  } else {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_LastFrameHash = hash;
+    m_LastFrameFile = filename;
   }
   m_DispatchTable.vkUnmapMemory(m_Device, stagedFrame.StagingMemory);
 }
 
+bool SwapchainImagesDumper::LinkToLastFrame(uint64_t hash, const std::string& filename) {
+  std::string lastFrameFile;
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_LastFrameFile.empty() || m_LastFrameHash != hash || m_LastFrameFile == filename) {
+      return false;
+    }
+    lastFrameFile = m_LastFrameFile;
+  }
+
+  std::error_code ec;
+  std::filesystem::remove(filename, ec);
+  std::filesystem::create_hard_link(lastFrameFile, filename, ec);
+  if (ec) {
+    std::filesystem::copy_file(lastFrameFile, filename,
+                               std::filesystem::copy_options::overwrite_existing, ec);
+  }
+  return !ec;
+}
+
 void SwapchainImagesDumper::WorkerThread() {
   while (true) {
     StagedFrame* submittedFrame = nullptr;
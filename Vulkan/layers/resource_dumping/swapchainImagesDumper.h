@@ -79,6 +79,9 @@ private:
                                        VkMemoryPropertyFlags requiredFlags) const;
   void CreateStagingBuffer(StagedFrame& stagedFrame);
   void DumpStagedFrame(StagedFrame& stagedFrame, const std::string& dumpedImageName);
+  // Writes the file as a link to (or a copy of) the last written screenshot if
+  // that one had the same contents. Returns false if the frame must be encoded.
+  bool LinkToLastFrame(uint64_t hash, const std::string& filename);
   void WorkerThread();
 
 private:
@@ -100,6 +103,11 @@ private:
   std::condition_variable m_FrameCopySubmittedCV;
   std::condition_variable m_StagedFrameFreeCV;
   bool m_Shutdown{};
+
+  // Contents hash and file name of the last written screenshot; guarded by
+  // m_Mutex.
+  uint64_t m_LastFrameHash{};
+  std::string m_LastFrameFile;
 };
 
 } // namespace vulkan
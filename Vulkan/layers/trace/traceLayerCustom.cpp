@@ -188,5 +188,29 @@ void TraceLayer::Post(RestoreContentDataCommand& command) {
   }
 }
 
+void TraceLayer::Pre(RestoreContentCachedDataCommand& command) {
+  if (printPre_) {
+    CommandPrinter p(streamPre_, statePre_, command, "RestoreContentCachedDataCommand");
+    p.addArgument(command.m_DeviceKey);
+    p.addArgument(command.m_Payload);
+    p.addArgument(command.m_Cached);
+    p.addArgument(command.m_Value);
+    p.addArgument(command.m_Regions);
+    p.print(flush_);
+  }
+}
+
+void TraceLayer::Post(RestoreContentCachedDataCommand& command) {
+  if (printPost_) {
+    CommandPrinter p(streamPost_, statePost_, command, "RestoreContentCachedDataCommand");
+    p.addArgument(command.m_DeviceKey);
+    p.addArgument(command.m_Payload);
+    p.addArgument(command.m_Cached);
+    p.addArgument(command.m_Value);
+    p.addArgument(command.m_Regions);
+    p.print(flush_);
+  }
+}
+
 } // namespace vulkan
 } // namespace gits
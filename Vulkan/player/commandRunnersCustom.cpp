@@ -162,5 +162,21 @@ void RestoreContentDataRunner::Run() {
   }
 }
 
+void RestoreContentCachedDataRunner::Run() {
+  auto& manager = PlayerManager::Get();
+
+  for (Layer* layer : manager.GetPreLayers()) {
+    layer->Pre(m_Command);
+  }
+
+  if (manager.ExecuteCommands() && !m_Command.m_Skip) {
+    manager.GetRestoreContentService().OnCachedData(m_Command);
+  }
+
+  for (Layer* layer : manager.GetPostLayers()) {
+    layer->Post(m_Command);
+  }
+}
+
 } // namespace vulkan
 } // namespace gits
@@ -117,5 +117,18 @@ private:
   RestoreContentDataCommand m_Command;
 };
 
+class RestoreContentCachedDataRunner : public stream::CommandRunner {
+public:
+  void Run() override;
+
+protected:
+  void DecodeCommand() override {
+    Decode(m_Data, m_Command);
+  }
+
+private:
+  RestoreContentCachedDataCommand m_Command;
+};
+
 } // namespace vulkan
 } // namespace gits
@@ -0,0 +1,204 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#include "pipelineCompilationService.h"
+#include "configurator.h"
+#include "log.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace gits {
+namespace vulkan {
+
+PipelineCompilationService::PipelineCompilationService() {
+  const auto& cfg = Configurator::Get().vulkan.player;
+  m_CachePath = cfg.overrideVKPipelineCache;
+  m_Parallel = cfg.forceMultithreadedPipelineCompilation;
+}
+
+PipelineCompilationService::~PipelineCompilationService() {
+  Shutdown();
+}
+
+void PipelineCompilationService::CreateSharedCache(VkDevice device,
+                                                   VkDeviceLevelDispatchTable& dispatchTable) {
+  if (!IsSharedCacheEnabled()) {
+    return;
+  }
+
+  std::vector<char> initialData;
+  {
+    std::ifstream file(m_CachePath, std::ios::binary);
+    if (file) {
+      initialData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+  }
+
+  // The driver validates the header and ignores data produced by another
+  // device or driver version, so a stale file only costs a cold cache.
+  VkPipelineCacheCreateInfo createInfo{};
+  createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  createInfo.initialDataSize = initialData.size();
+  createInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+  VkPipelineCache cache = VK_NULL_HANDLE;
+  VkResult result = dispatchTable.vkCreatePipelineCache(device, &createInfo, nullptr, &cache);
+  if (result != VK_SUCCESS || cache == VK_NULL_HANDLE) {
+    LOG_WARNING << "PipelineCompilationService: vkCreatePipelineCache failed (" << result
+                << "); pipelines are created with the stream's caches.";
+    return;
+  }
+  LOG_INFO << "PipelineCompilationService: Shared pipeline cache created with "
+           << initialData.size() << " bytes loaded from " << m_CachePath.string();
+
+  std::lock_guard<std::mutex> lock(m_CacheMutex);
+  m_Caches[device] = {cache, &dispatchTable};
+}
+
+void PipelineCompilationService::DestroySharedCache(VkDevice device) {
+  SharedCache cache;
+  {
+    std::lock_guard<std::mutex> lock(m_CacheMutex);
+    auto it = m_Caches.find(device);
+    if (it == m_Caches.end()) {
+      return;
+    }
+    cache = it->second;
+    m_Caches.erase(it);
+  }
+  StoreCacheData(device, cache);
+  cache.DispatchTable->vkDestroyPipelineCache(device, cache.Cache, nullptr);
+}
+
+VkPipelineCache PipelineCompilationService::GetSharedCache(VkDevice device,
+                                                           VkPipelineCache fallback) {
+  std::lock_guard<std::mutex> lock(m_CacheMutex);
+  auto it = m_Caches.find(device);
+  return it != m_Caches.end() ? it->second.Cache : fallback;
+}
+
+void PipelineCompilationService::StoreCacheData(VkDevice device, const SharedCache& cache) {
+  size_t dataSize = 0;
+  auto& dispatchTable = *cache.DispatchTable;
+  if (dispatchTable.vkGetPipelineCacheData(device, cache.Cache, &dataSize, nullptr) !=
+          VK_SUCCESS ||
+      dataSize == 0) {
+    return;
+  }
+  std::vector<char> data(dataSize);
+  VkResult result =
+      dispatchTable.vkGetPipelineCacheData(device, cache.Cache, &dataSize, data.data());
+  if (result != VK_SUCCESS && result != VK_INCOMPLETE) {
+    return;
+  }
+
+  std::ofstream file(m_CachePath, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    LOG_WARNING << "PipelineCompilationService: Cannot write pipeline cache to "
+                << m_CachePath.string();
+    return;
+  }
+  file.write(data.data(), static_cast<std::streamsize>(dataSize));
+  LOG_INFO << "PipelineCompilationService: Stored " << dataSize << " bytes of pipeline cache in "
+           << m_CachePath.string();
+}
+
+void PipelineCompilationService::RunParallel(uint32_t count,
+                                             const std::function<void(uint32_t)>& task) {
+  if (count == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> batchLock(m_BatchMutex);
+  std::unique_lock<std::mutex> lock(m_PoolMutex);
+  if (m_Workers.empty() && !m_Shutdown) {
+    StartWorkers();
+  }
+
+  Batch batch;
+  batch.Task = &task;
+  batch.Count = count;
+  m_Batch = &batch;
+  m_BatchReadyCV.notify_all();
+
+  ProcessBatch(lock, batch);
+
+  // The batch lives on this stack frame, so wait for the workers to let go of
+  // it as well as for the remaining items.
+  m_BatchDoneCV.wait(lock, [&] { return batch.Done == batch.Count && m_ActiveWorkers == 0; });
+  m_Batch = nullptr;
+}
+
+void PipelineCompilationService::ProcessBatch(std::unique_lock<std::mutex>& lock, Batch& batch) {
+  while (batch.Next < batch.Count) {
+    uint32_t index = batch.Next++;
+    lock.unlock();
+    (*batch.Task)(index);
+    lock.lock();
+    ++batch.Done;
+  }
+}
+
+void PipelineCompilationService::StartWorkers() {
+  // The replay thread compiles as well, so leave one hardware thread for it.
+  unsigned int hwThreads = std::thread::hardware_concurrency();
+  unsigned int workerCount = (hwThreads > 1) ? (hwThreads - 1) : 1;
+
+  m_Workers.reserve(workerCount);
+  for (unsigned int i = 0; i < workerCount; ++i) {
+    m_Workers.emplace_back(&PipelineCompilationService::WorkerThread, this);
+  }
+  LOG_INFO << "PipelineCompilationService: Compiling pipelines on " << workerCount + 1
+           << " threads";
+}
+
+void PipelineCompilationService::WorkerThread() {
+  std::unique_lock<std::mutex> lock(m_PoolMutex);
+  while (true) {
+    m_BatchReadyCV.wait(
+        lock, [this] { return m_Shutdown || (m_Batch && m_Batch->Next < m_Batch->Count); });
+    if (m_Shutdown) {
+      return;
+    }
+    Batch& batch = *m_Batch;
+    ++m_ActiveWorkers;
+    ProcessBatch(lock, batch);
+    --m_ActiveWorkers;
+    m_BatchDoneCV.notify_all();
+  }
+}
+
+void PipelineCompilationService::Shutdown() {
+  std::unordered_map<VkDevice, SharedCache> caches;
+  {
+    std::lock_guard<std::mutex> lock(m_CacheMutex);
+    caches.swap(m_Caches);
+  }
+  for (const auto& [device, cache] : caches) {
+    StoreCacheData(device, cache);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_PoolMutex);
+    if (m_Shutdown) {
+      return;
+    }
+    m_Shutdown = true;
+  }
+  m_BatchReadyCV.notify_all();
+  for (auto& worker : m_Workers) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+} // namespace vulkan
+} // namespace gits
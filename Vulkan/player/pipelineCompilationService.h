@@ -0,0 +1,106 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#pragma once
+
+#include "vulkanHeader2.h"
+#include "dispatchTableAuto.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace gits {
+namespace vulkan {
+
+// Speeds up pipeline creation during replay.
+//
+// Shared cache (Vulkan.Player.OverrideVKPipelineCache): one VkPipelineCache per
+// device is created from the file contents when the device is created, is
+// substituted for the pipelineCache argument of every vkCreate*Pipelines call
+// and is written back to the file when the device is destroyed (or at player
+// shutdown), so later runs start with the compiled pipelines.
+//
+// Parallel compilation (Vulkan.Player.ForceMultithreadedPipelineCompilation):
+// a vkCreate*Pipelines batch is split into one driver call per create info and
+// the calls are spread over a persistent worker pool; the calling thread takes
+// part and returns once the whole batch is compiled, so the output handles are
+// available to the post layers exactly as with a single driver call.
+class PipelineCompilationService {
+public:
+  PipelineCompilationService();
+  ~PipelineCompilationService();
+  PipelineCompilationService(const PipelineCompilationService&) = delete;
+  PipelineCompilationService& operator=(const PipelineCompilationService&) = delete;
+
+  bool IsSharedCacheEnabled() const {
+    return !m_CachePath.empty();
+  }
+  bool IsParallelCompilationEnabled() const {
+    return m_Parallel;
+  }
+
+  void CreateSharedCache(VkDevice device, VkDeviceLevelDispatchTable& dispatchTable);
+  void DestroySharedCache(VkDevice device);
+  // Returns the shared cache of the device, or fallback if there is none.
+  VkPipelineCache GetSharedCache(VkDevice device, VkPipelineCache fallback);
+
+  // Calls task(i) for every i in [0, count) on the worker pool and the calling
+  // thread; returns when all calls have finished.  Batches from several replay
+  // threads run one after another.
+  void RunParallel(uint32_t count, const std::function<void(uint32_t)>& task);
+
+  // Stores the caches of devices that were never destroyed and stops the
+  // workers.  Must be called while the device dispatch tables are still valid.
+  void Shutdown();
+
+private:
+  struct SharedCache {
+    VkPipelineCache Cache{VK_NULL_HANDLE};
+    VkDeviceLevelDispatchTable* DispatchTable{nullptr};
+  };
+
+  struct Batch {
+    const std::function<void(uint32_t)>* Task{nullptr};
+    uint32_t Count{0};
+    uint32_t Next{0};
+    uint32_t Done{0};
+  };
+
+  void StoreCacheData(VkDevice device, const SharedCache& cache);
+  void StartWorkers();
+  void WorkerThread();
+  // Runs batch items until none are left.  Called with m_PoolMutex held;
+  // releases it while a task runs.
+  void ProcessBatch(std::unique_lock<std::mutex>& lock, Batch& batch);
+
+private:
+  std::filesystem::path m_CachePath;
+  bool m_Parallel{false};
+
+  std::mutex m_CacheMutex;
+  std::unordered_map<VkDevice, SharedCache> m_Caches;
+
+  std::vector<std::thread> m_Workers;
+  // Held for a whole batch; the pool runs a single batch at a time.
+  std::mutex m_BatchMutex;
+  std::mutex m_PoolMutex;
+  std::condition_variable m_BatchReadyCV;
+  std::condition_variable m_BatchDoneCV;
+  Batch* m_Batch{nullptr};
+  uint32_t m_ActiveWorkers{0};
+  bool m_Shutdown{false};
+};
+
+} // namespace vulkan
+} // namespace gits
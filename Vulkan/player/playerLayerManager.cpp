@@ -97,11 +97,22 @@ void PlayerLayerManager::LoadLayers(PlayerManager& playerManager, PluginService&
   std::unique_ptr<Layer> subcaptureLayer;
   std::unique_ptr<Layer> analyzerLayer;
   std::unique_ptr<Layer> recordingLayer;
-  if (subcaptureAnalysis) {
+  if (subcaptureAnalysis && cfg.common.player.subcapture.vulkan.singlePass) {
+    // Single pass: analyze the range while spilling it, then record the pruned restore
+    // and the spilled range once it ends.
+    subcaptureLayer = std::make_unique<SubcaptureLayer>(
+        playerManager, cfg.common.player.subcapture.frames, SubcapturePass::SinglePass);
+    auto* sc = static_cast<SubcaptureLayer*>(subcaptureLayer.get());
+    analyzerLayer = std::make_unique<AnalyzerLayer>(*sc->GetAnalyzerService(),
+                                                    *sc->GetAnalyzerRaytracingService());
+    recordingLayer = std::make_unique<RecordingLayer>(sc->GetRecorder(), sc->GetRange(),
+                                                      &sc->GetStateTrackingService());
+    LOG_INFO << "Vulkan subcapture: single-pass analysis and recording";
+  } else if (subcaptureAnalysis) {
     // Analysis pass: track state and collect in-range object usage, then dump
     // the analysis file.  No output stream is produced; the user must run again.
     subcaptureLayer = std::make_unique<SubcaptureLayer>(
-        playerManager, cfg.common.player.subcapture.frames, /*analysisMode=*/true);
+        playerManager, cfg.common.player.subcapture.frames, SubcapturePass::Analysis);
     auto* sc = static_cast<SubcaptureLayer*>(subcaptureLayer.get());
     analyzerLayer = std::make_unique<AnalyzerLayer>(*sc->GetAnalyzerService(),
                                                     *sc->GetAnalyzerRaytracingService());
@@ -181,6 +192,9 @@ void PlayerLayerManager::LoadLayers(PlayerManager& playerManager, PluginService&
     if (layer) {
       m_PreLayers.push_back(layer);
       m_PostLayers.push_back(layer);
+      if (ActiveCommandProfiler() == nullptr) {
+        ActiveCommandProfiler() = layer->GetCommandProfiler();
+      }
     }
   }
 
@@ -193,6 +207,7 @@ void PlayerLayerManager::Shutdown() {
   // about to be destroyed (plugin layers in these vectors are owned elsewhere).
   m_PreLayers.clear();
   m_PostLayers.clear();
+  ActiveCommandProfiler() = nullptr;
   // Destroy the owned layers and layer groups now, while the caller guarantees
   // the device dispatch tables and driver library are still alive.  Destroying
   // the ResourceDumpingLayerGroup tears down the ScreenshotsLayer, whose
@@ -39,6 +39,9 @@ PlayerManager::~PlayerManager() {
     // closed library and dangling dispatch table, dropping that screenshot
     // entirely for a single-frame stream.
     m_LayerManager.Shutdown();
+    // Stores the shared pipeline caches of devices the stream never destroyed;
+    // needs the device dispatch tables, so it must also run before the close.
+    m_PipelineCompilationService.Shutdown();
     m_PluginService.reset();
     dl::close_library(m_Lib);
     m_Lib = nullptr;
@@ -50,8 +53,8 @@ PlayerManager::~PlayerManager() {
 PlayerManager::PlayerManager() : m_SwapchainImageSyncService(*this) {
   LoadGlobalFunctions();
 
-  m_DispatchTablesHolder = std::make_unique<DispatchTablesHolder>(
-      m_InstanceDispatchTable, m_DeviceDispatchTable, m_DispatchTablesMutex);
+  m_DispatchTablesHolder =
+      std::make_unique<DispatchTablesHolder>(m_InstanceDispatchTable, m_DeviceDispatchTable);
 
   m_PluginService = std::make_unique<PluginService>();
   m_PluginService->SetVkDriverRewindPresentCountPtr(
@@ -73,19 +76,19 @@ void PlayerManager::LoadGlobalFunctions() {
 
 void PlayerManager::LoadInstanceFunctions(VkInstance instance) {
   void* dispatchKey = *reinterpret_cast<void**>(instance);
-  std::unique_lock lock(m_DispatchTablesMutex);
-  auto& dispatchTable = m_InstanceDispatchTable[dispatchKey];
+  auto& dispatchTable = m_InstanceDispatchTable.Create(dispatchKey);
   LoadInstanceLevelFunctions(m_GetInstanceProcAddr, instance, dispatchTable);
+  m_InstanceDispatchTable.Publish(dispatchKey);
 }
 
 void PlayerManager::LoadDeviceFunctions(void* dispatchKey, VkDevice device) {
-  std::unique_lock lock(m_DispatchTablesMutex);
-  auto& instanceTable = m_InstanceDispatchTable[dispatchKey];
+  auto& instanceTable = m_InstanceDispatchTable.Get(dispatchKey);
   PFN_vkGetDeviceProcAddr getDeviceProcAddr = reinterpret_cast<PFN_vkGetDeviceProcAddr>(
       instanceTable.vkGetInstanceProcAddr(instanceTable.instance, "vkGetDeviceProcAddr"));
   void* deviceDispatchKey = *reinterpret_cast<void**>(device);
-  auto& dispatchTable = m_DeviceDispatchTable[deviceDispatchKey];
+  auto& dispatchTable = m_DeviceDispatchTable.Create(deviceDispatchKey);
   LoadDeviceLevelFunctions(getDeviceProcAddr, device, dispatchTable);
+  m_DeviceDispatchTable.Publish(deviceDispatchKey);
   if (m_PluginService) {
     m_PluginService->SetVulkanDeviceDispatchTable(&dispatchTable);
     m_PluginService->SetVulkanInstanceDispatchTable(&instanceTable);
@@ -15,12 +15,13 @@
 #include "dispatchTablesHolder.h"
 #include "layerAuto.h"
 #include "mapTrackingService.h"
+#include "pipelineCompilationService.h"
 #include "playerLayerManager.h"
 #include "restoreContentService.h"
+#include "submissionTrackingService.h"
 #include "windowService.h"
 
 #include <memory>
-#include <shared_mutex>
 #include "swapchainImageSyncService.h"
 #include <unordered_map>
 
@@ -65,13 +66,13 @@ public:
   template <typename Handle>
   VkInstanceLevelDispatchTable& GetInstanceDispatchTable(Handle handle) {
     void* dispatchKey = *reinterpret_cast<void**>(handle);
-    return m_InstanceDispatchTable[dispatchKey];
+    return m_InstanceDispatchTable.Get(dispatchKey);
   }
 
   template <typename Handle>
   VkDeviceLevelDispatchTable& GetDeviceDispatchTable(Handle handle) {
     void* dispatchKey = *reinterpret_cast<void**>(handle);
-    return m_DeviceDispatchTable[dispatchKey];
+    return m_DeviceDispatchTable.Get(dispatchKey);
   }
 
   WindowService& GetWindowService() {
@@ -94,10 +95,18 @@ public:
     return m_FencePendingSignalService;
   }
 
+  SubmissionTrackingService& GetSubmissionTrackingService() {
+    return m_SubmissionTrackingService;
+  }
+
   RestoreContentService& GetRestoreContentService() {
     return m_RestoreContentService;
   }
 
+  PipelineCompilationService& GetPipelineCompilationService() {
+    return m_PipelineCompilationService;
+  }
+
 private:
   PlayerManager();
 
@@ -109,9 +118,8 @@ private:
   dl::SharedObject m_Lib{nullptr};
   PFN_vkGetInstanceProcAddr m_GetInstanceProcAddr{nullptr};
   VkGlobalLevelDispatchTable m_GlobalDispatchTable{};
-  std::shared_mutex m_DispatchTablesMutex;
-  std::unordered_map<void*, VkInstanceLevelDispatchTable> m_InstanceDispatchTable{};
-  std::unordered_map<void*, VkDeviceLevelDispatchTable> m_DeviceDispatchTable{};
+  DispatchTableMap<VkInstanceLevelDispatchTable> m_InstanceDispatchTable;
+  DispatchTableMap<VkDeviceLevelDispatchTable> m_DeviceDispatchTable;
   std::unique_ptr<DispatchTablesHolder> m_DispatchTablesHolder;
 
   WindowService m_WindowService;
@@ -119,7 +127,9 @@ private:
   DescriptorUpdateTemplateService m_DescriptorUpdateTemplateService;
   SwapchainImageSyncService m_SwapchainImageSyncService;
   FencePendingSignalService m_FencePendingSignalService;
+  SubmissionTrackingService m_SubmissionTrackingService{*this};
   RestoreContentService m_RestoreContentService{*this};
+  PipelineCompilationService m_PipelineCompilationService;
 };
 
 } // namespace vulkan
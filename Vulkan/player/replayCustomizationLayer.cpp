@@ -9,6 +9,7 @@
 #include "replayCustomizationLayer.h"
 #include "playerManager.h"
 #include "swapchainImageSyncService.h"
+#include "handleArgumentUpdaters.h"
 #include "configurator.h"
 #include "suppressNames.h"
 #include "log.h"
@@ -34,16 +35,27 @@ void ReplayCustomizationLayer::Post(vkCreateInstanceCommand& command) {
 void ReplayCustomizationLayer::Post(vkCreateDeviceCommand& command) {
   void* dispatchKey = *reinterpret_cast<void**>(command.m_physicalDevice.Value);
   m_Manager.LoadDeviceFunctions(dispatchKey, *command.m_pDevice.Value);
+  m_Manager.GetPipelineCompilationService().CreateSharedCache(
+      *command.m_pDevice.Value, m_Manager.GetDeviceDispatchTable(*command.m_pDevice.Value));
+}
+
+void ReplayCustomizationLayer::Pre(vkDestroyDeviceCommand& command) {
+  m_Manager.GetPipelineCompilationService().DestroySharedCache(command.m_device.Value);
+  m_Manager.GetSubmissionTrackingService().DestroyDevice(command.m_device.Value);
 }
 
 void ReplayCustomizationLayer::Post(vkGetDeviceQueueCommand& command) {
   m_Manager.GetSwapchainImageSyncService().TrackQueue(command.m_device.Value,
                                                       *command.m_pQueue.Value);
+  m_Manager.GetSubmissionTrackingService().TrackQueue(command.m_device.Value,
+                                                      *command.m_pQueue.Value);
 }
 
 void ReplayCustomizationLayer::Post(vkGetDeviceQueue2Command& command) {
   m_Manager.GetSwapchainImageSyncService().TrackQueue(command.m_device.Value,
                                                       *command.m_pQueue.Value);
+  m_Manager.GetSubmissionTrackingService().TrackQueue(command.m_device.Value,
+                                                      *command.m_pQueue.Value);
 }
 
 #ifdef VK_USE_PLATFORM_WIN32_KHR
@@ -232,10 +244,24 @@ void ReplayCustomizationLayer::Pre(vkGetEventStatusCommand& command) {
 }
 
 void ReplayCustomizationLayer::Post(vkGetEventStatusCommand& command) {
+  if (command.m_Return.Value == VK_EVENT_SET || command.m_Return.Value == tl_recorderReturnValue) {
+    return;
+  }
+  auto& dispatchTable = m_Manager.GetDeviceDispatchTable(command.m_device.Value);
+  // The event is set by a replayed submission: block on its completion rather
+  // than polling.  The wait is bounded, as the submission may itself wait on host
+  // work the stream issues only later; poll for the event then.
+  using WaitResult = SubmissionTrackingService::WaitResult;
+  if (m_Manager.GetSubmissionTrackingService().WaitForEvent(
+          command.m_device.Value, command.m_event.Value) == WaitResult::Completed) {
+    command.m_Return.Value =
+        dispatchTable.vkGetEventStatus(command.m_device.Value, command.m_event.Value);
+  }
+  // Otherwise it is set from the host (possibly by another replay thread) or
+  // by a submission that was not tracked, so poll for it.
   while (command.m_Return.Value != VK_EVENT_SET &&
          command.m_Return.Value != tl_recorderReturnValue) {
     std::this_thread::sleep_for(std::chrono::milliseconds(5));
-    auto& dispatchTable = m_Manager.GetDeviceDispatchTable(command.m_device.Value);
     command.m_Return.Value =
         dispatchTable.vkGetEventStatus(command.m_device.Value, command.m_event.Value);
   }
@@ -302,10 +328,48 @@ void ReplayCustomizationLayer::Pre(vkGetQueryPoolResultsCommand& command) {
 }
 
 void ReplayCustomizationLayer::Post(vkGetQueryPoolResultsCommand& command) {
-  if (command.m_Return.Value != VK_SUCCESS && command.m_Return.Value != tl_recorderReturnValue) {
-    auto& dispatchTable = m_Manager.GetDeviceDispatchTable(command.m_device.Value);
+  if (command.m_Return.Value == VK_SUCCESS || command.m_Return.Value == tl_recorderReturnValue) {
+    return;
+  }
+  auto& dispatchTable = m_Manager.GetDeviceDispatchTable(command.m_device.Value);
+  VkQueryResultFlags flags = command.m_flags.Value;
+  auto readResults = [&](VkQueryResultFlags readFlags) {
+    command.m_Return.Value = dispatchTable.vkGetQueryPoolResults(
+        command.m_device.Value, command.m_queryPool.Value, command.m_firstQuery.Value,
+        command.m_queryCount.Value, command.m_dataSize.Value, command.m_pData.Value,
+        command.m_stride.Value, readFlags);
+  };
+  // Wait for the submissions that wrote the requested queries.  Each wait is
+  // bounded, as they may wait on host work the stream issues only later, so poll
+  // the results as recorded in between.  Once they have completed, re-read with
+  // VK_QUERY_RESULT_WAIT_BIT only if every query in the range was written since
+  // its last reset; waiting on a query that is never written would never return,
+  // so otherwise re-read as recorded.  Without any known submission fall back to
+  // idling the device.
+  using WaitResult = SubmissionTrackingService::WaitResult;
+  auto& tracking = m_Manager.GetSubmissionTrackingService();
+  bool rangeWritten = false;
+  auto waitForWriters = [&]() {
+    return tracking.WaitForQueryPool(command.m_device.Value, command.m_queryPool.Value,
+                                     command.m_firstQuery.Value, command.m_queryCount.Value,
+                                     rangeWritten);
+  };
+  WaitResult result = waitForWriters();
+  while (result == WaitResult::Pending) {
+    readResults(flags);
+    if (command.m_Return.Value == VK_SUCCESS || command.m_Return.Value == tl_recorderReturnValue) {
+      return;
+    }
+    result = waitForWriters();
+  }
+  if (result == WaitResult::Completed) {
+    if (rangeWritten) {
+      flags = (flags | VK_QUERY_RESULT_WAIT_BIT) & ~VK_QUERY_RESULT_PARTIAL_BIT;
+    }
+  } else {
     dispatchTable.vkDeviceWaitIdle(command.m_device.Value);
   }
+  readResults(flags);
 }
 
 // vkWaitForFences
@@ -590,11 +654,94 @@ void ReplayCustomizationLayer::Pre(vkCmdPushDescriptorSetWithTemplateKHRCommand&
       command.m_descriptorUpdateTemplate.Value, command.m_pData);
 }
 
+// Pipelines of one vkCreate*Pipelines call may derive from each other through
+// basePipelineIndex, which only works while they are created by one driver call.
+template <typename CreateInfo>
+static bool HasIndexedBasePipeline(const CreateInfo* createInfos, uint32_t count) {
+  for (uint32_t i = 0; i < count; ++i) {
+    if ((createInfos[i].flags & VK_PIPELINE_CREATE_DERIVATIVE_BIT) &&
+        createInfos[i].basePipelineHandle == VK_NULL_HANDLE &&
+        createInfos[i].basePipelineIndex >= 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Redirects the call to the shared pipeline cache and, with parallel pipeline
+// compilation enabled, replaces the driver call by one call per create info on
+// the compilation workers.  create(createInfo, pipeline) issues a single-element
+// driver call.  The runner does not register the output handles of a skipped
+// command, so it is done here before the post layers run - on success only, as
+// the runner does; on failure the pipelines that were created are destroyed.
+template <typename Command, typename Create>
+static void CompilePipelines(PlayerManager& manager, Command& command, Create&& create) {
+  auto& service = manager.GetPipelineCompilationService();
+  command.m_pipelineCache.Value =
+      service.GetSharedCache(command.m_device.Value, command.m_pipelineCache.Value);
+
+  const uint32_t count = command.m_createInfoCount.Value;
+  const auto* createInfos = command.m_pCreateInfos.Value;
+  if (!manager.ExecuteCommands() || !service.IsParallelCompilationEnabled() || count < 2 ||
+      HasIndexedBasePipeline(createInfos, count)) {
+    return;
+  }
+
+  VkPipeline* pipelines = command.m_pPipelines.Value;
+  std::vector<VkResult> results(count, VK_SUCCESS);
+  service.RunParallel(count, [&](uint32_t i) {
+    results[i] = create(createInfos[i], pipelines[i]);
+  });
+
+  // The success codes of these commands are all non-negative: an error of any
+  // call fails the batch, otherwise the first non-VK_SUCCESS code is returned.
+  command.m_Return.Value = VK_SUCCESS;
+  for (VkResult result : results) {
+    if (result < 0) {
+      command.m_Return.Value = result;
+      break;
+    }
+    if (command.m_Return.Value == VK_SUCCESS) {
+      command.m_Return.Value = result;
+    }
+  }
+  command.m_Skip = true;
+  if (command.m_Return.Value >= 0) {
+    UpdateOutputHandle(manager, command.m_pPipelines);
+    return;
+  }
+  auto& dispatchTable = manager.GetDeviceDispatchTable(command.m_device.Value);
+  for (uint32_t i = 0; i < count; ++i) {
+    if (pipelines[i] != VK_NULL_HANDLE) {
+      dispatchTable.vkDestroyPipeline(command.m_device.Value, pipelines[i],
+                                      command.m_pAllocator.Value);
+      pipelines[i] = VK_NULL_HANDLE;
+    }
+  }
+}
+
 void ReplayCustomizationLayer::Pre(vkCreateGraphicsPipelinesCommand& command) {
   for (uint32_t i = 0; i < command.m_createInfoCount.Value; ++i) {
     command.m_pCreateInfos.Value[i].flags &=
         ~VK_PIPELINE_CREATE_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT;
   }
+  CompilePipelines(m_Manager, command,
+                   [&](const VkGraphicsPipelineCreateInfo& createInfo, VkPipeline& pipeline) {
+                     return m_Manager.GetDeviceDispatchTable(command.m_device.Value)
+                         .vkCreateGraphicsPipelines(command.m_device.Value,
+                                                    command.m_pipelineCache.Value, 1, &createInfo,
+                                                    command.m_pAllocator.Value, &pipeline);
+                   });
+}
+
+void ReplayCustomizationLayer::Pre(vkCreateComputePipelinesCommand& command) {
+  CompilePipelines(m_Manager, command,
+                   [&](const VkComputePipelineCreateInfo& createInfo, VkPipeline& pipeline) {
+                     return m_Manager.GetDeviceDispatchTable(command.m_device.Value)
+                         .vkCreateComputePipelines(command.m_device.Value,
+                                                   command.m_pipelineCache.Value, 1, &createInfo,
+                                                   command.m_pAllocator.Value, &pipeline);
+                   });
 }
 
 void ReplayCustomizationLayer::Pre(vkAcquireNextImageKHRCommand& command) {
@@ -628,18 +775,41 @@ void ReplayCustomizationLayer::Post(vkCreateFenceCommand& command) {
 void ReplayCustomizationLayer::Post(vkQueueSubmitCommand& command) {
   if (command.m_Return.Value == VK_SUCCESS) {
     m_Manager.GetFencePendingSignalService().MarkPending(command.m_fence.Value);
+    std::vector<VkCommandBuffer> commandBuffers;
+    for (uint32_t i = 0; i < command.m_submitCount.Value; ++i) {
+      const auto& submit = command.m_pSubmits.Value[i];
+      commandBuffers.insert(commandBuffers.end(), submit.pCommandBuffers,
+                            submit.pCommandBuffers + submit.commandBufferCount);
+    }
+    m_Manager.GetSubmissionTrackingService().OnSubmit(command.m_queue.Value, commandBuffers);
   }
 }
 
 void ReplayCustomizationLayer::Post(vkQueueSubmit2Command& command) {
   if (command.m_Return.Value == VK_SUCCESS) {
     m_Manager.GetFencePendingSignalService().MarkPending(command.m_fence.Value);
+    std::vector<VkCommandBuffer> commandBuffers;
+    for (uint32_t i = 0; i < command.m_submitCount.Value; ++i) {
+      const auto& submit = command.m_pSubmits.Value[i];
+      for (uint32_t j = 0; j < submit.commandBufferInfoCount; ++j) {
+        commandBuffers.push_back(submit.pCommandBufferInfos[j].commandBuffer);
+      }
+    }
+    m_Manager.GetSubmissionTrackingService().OnSubmit(command.m_queue.Value, commandBuffers);
   }
 }
 
 void ReplayCustomizationLayer::Post(vkQueueSubmit2KHRCommand& command) {
   if (command.m_Return.Value == VK_SUCCESS) {
     m_Manager.GetFencePendingSignalService().MarkPending(command.m_fence.Value);
+    std::vector<VkCommandBuffer> commandBuffers;
+    for (uint32_t i = 0; i < command.m_submitCount.Value; ++i) {
+      const auto& submit = command.m_pSubmits.Value[i];
+      for (uint32_t j = 0; j < submit.commandBufferInfoCount; ++j) {
+        commandBuffers.push_back(submit.pCommandBufferInfos[j].commandBuffer);
+      }
+    }
+    m_Manager.GetSubmissionTrackingService().OnSubmit(command.m_queue.Value, commandBuffers);
   }
 }
 
@@ -682,6 +852,128 @@ void ReplayCustomizationLayer::Post(vkDestroyFenceCommand& command) {
 
 void ReplayCustomizationLayer::Pre(vkCreateRayTracingPipelinesKHRCommand& command) {
   m_RayTracingService.OnPreCreateRayTracingPipelines(command);
+  // A deferred operation completes the whole batch on the application's terms,
+  // so only the cache is substituted for it.
+  if (command.m_deferredOperation.Value != VK_NULL_HANDLE) {
+    auto& service = m_Manager.GetPipelineCompilationService();
+    command.m_pipelineCache.Value =
+        service.GetSharedCache(command.m_device.Value, command.m_pipelineCache.Value);
+    return;
+  }
+  CompilePipelines(
+      m_Manager, command,
+      [&](const VkRayTracingPipelineCreateInfoKHR& createInfo, VkPipeline& pipeline) {
+        return m_Manager.GetDeviceDispatchTable(command.m_device.Value)
+            .vkCreateRayTracingPipelinesKHR(command.m_device.Value, VK_NULL_HANDLE,
+                                            command.m_pipelineCache.Value, 1, &createInfo,
+                                            command.m_pAllocator.Value, &pipeline);
+      });
+}
+
+// Submission tracking for the vkGetEventStatus / vkGetQueryPoolResults catch-up.
+
+void ReplayCustomizationLayer::Post(vkBeginCommandBufferCommand& command) {
+  m_Manager.GetSubmissionTrackingService().ResetCommandBuffer(command.m_commandBuffer.Value);
+}
+
+void ReplayCustomizationLayer::Post(vkResetCommandBufferCommand& command) {
+  m_Manager.GetSubmissionTrackingService().ResetCommandBuffer(command.m_commandBuffer.Value);
+}
+
+void ReplayCustomizationLayer::Pre(vkFreeCommandBuffersCommand& command) {
+  m_Manager.GetSubmissionTrackingService().FreeCommandBuffers(command.m_commandBufferCount.Value,
+                                                              command.m_pCommandBuffers.Value);
+}
+
+void ReplayCustomizationLayer::Post(vkCmdSetEventCommand& command) {
+  m_Manager.GetSubmissionTrackingService().RecordSetEvent(command.m_commandBuffer.Value,
+                                                          command.m_event.Value);
+}
+
+void ReplayCustomizationLayer::Post(vkCmdSetEvent2Command& command) {
+  m_Manager.GetSubmissionTrackingService().RecordSetEvent(command.m_commandBuffer.Value,
+                                                          command.m_event.Value);
+}
+
+void ReplayCustomizationLayer::Post(vkCmdSetEvent2KHRCommand& command) {
+  m_Manager.GetSubmissionTrackingService().RecordSetEvent(command.m_commandBuffer.Value,
+                                                          command.m_event.Value);
+}
+
+void ReplayCustomizationLayer::Post(vkCmdResetEventCommand& command) {
+  m_Manager.GetSubmissionTrackingService().RecordResetEvent(command.m_commandBuffer.Value,
+                                                            command.m_event.Value);
+}
+
+void ReplayCustomizationLayer::Post(vkCmdResetEvent2Command& command) {
+  m_Manager.GetSubmissionTrackingService().RecordResetEvent(command.m_commandBuffer.Value,
+                                                            command.m_event.Value);
+}
+
+void ReplayCustomizationLayer::Post(vkCmdResetEvent2KHRCommand& command) {
+  m_Manager.GetSubmissionTrackingService().RecordResetEvent(command.m_commandBuffer.Value,
+                                                            command.m_event.Value);
+}
+
+void ReplayCustomizationLayer::Post(vkCmdEndQueryCommand& command) {
+  m_Manager.GetSubmissionTrackingService().RecordQueryWrite(
+      command.m_commandBuffer.Value, command.m_queryPool.Value, command.m_query.Value, 1);
+}
+
+void ReplayCustomizationLayer::Post(vkCmdEndQueryIndexedEXTCommand& command) {
+  m_Manager.GetSubmissionTrackingService().RecordQueryWrite(
+      command.m_commandBuffer.Value, command.m_queryPool.Value, command.m_query.Value, 1);
+}
+
+void ReplayCustomizationLayer::Post(vkCmdWriteTimestampCommand& command) {
+  m_Manager.GetSubmissionTrackingService().RecordQueryWrite(
+      command.m_commandBuffer.Value, command.m_queryPool.Value, command.m_query.Value, 1);
+}
+
+void ReplayCustomizationLayer::Post(vkCmdWriteTimestamp2Command& command) {
+  m_Manager.GetSubmissionTrackingService().RecordQueryWrite(
+      command.m_commandBuffer.Value, command.m_queryPool.Value, command.m_query.Value, 1);
+}
+
+void ReplayCustomizationLayer::Post(vkCmdWriteTimestamp2KHRCommand& command) {
+  m_Manager.GetSubmissionTrackingService().RecordQueryWrite(
+      command.m_commandBuffer.Value, command.m_queryPool.Value, command.m_query.Value, 1);
+}
+
+void ReplayCustomizationLayer::Post(vkCmdWriteAccelerationStructuresPropertiesKHRCommand& command) {
+  m_Manager.GetSubmissionTrackingService().RecordQueryWrite(
+      command.m_commandBuffer.Value, command.m_queryPool.Value, command.m_firstQuery.Value,
+      command.m_accelerationStructureCount.Value);
+}
+
+void ReplayCustomizationLayer::Post(vkCmdResetQueryPoolCommand& command) {
+  m_Manager.GetSubmissionTrackingService().RecordQueryReset(
+      command.m_commandBuffer.Value, command.m_queryPool.Value, command.m_firstQuery.Value,
+      command.m_queryCount.Value);
+}
+
+void ReplayCustomizationLayer::Post(vkResetQueryPoolCommand& command) {
+  m_Manager.GetSubmissionTrackingService().ResetQueries(
+      command.m_queryPool.Value, command.m_firstQuery.Value, command.m_queryCount.Value);
+}
+
+void ReplayCustomizationLayer::Post(vkResetQueryPoolEXTCommand& command) {
+  m_Manager.GetSubmissionTrackingService().ResetQueries(
+      command.m_queryPool.Value, command.m_firstQuery.Value, command.m_queryCount.Value);
+}
+
+void ReplayCustomizationLayer::Post(vkCmdExecuteCommandsCommand& command) {
+  m_Manager.GetSubmissionTrackingService().RecordExecuteCommands(
+      command.m_commandBuffer.Value, command.m_commandBufferCount.Value,
+      command.m_pCommandBuffers.Value);
+}
+
+void ReplayCustomizationLayer::Pre(vkDestroyEventCommand& command) {
+  m_Manager.GetSubmissionTrackingService().ForgetEvent(command.m_event.Value);
+}
+
+void ReplayCustomizationLayer::Pre(vkDestroyQueryPoolCommand& command) {
+  m_Manager.GetSubmissionTrackingService().ForgetQueryPool(command.m_queryPool.Value);
 }
 
 } // namespace vulkan
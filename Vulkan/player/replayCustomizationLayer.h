@@ -89,7 +89,9 @@ public:
   void Pre(vkCmdPushDescriptorSetWithTemplateCommand& command) override;
   void Pre(vkCmdPushDescriptorSetWithTemplateKHRCommand& command) override;
 
+  void Pre(vkDestroyDeviceCommand& command) override;
   void Pre(vkCreateGraphicsPipelinesCommand& command) override;
+  void Pre(vkCreateComputePipelinesCommand& command) override;
   void Pre(vkAcquireNextImageKHRCommand& command) override;
   void Pre(vkAcquireNextImage2KHRCommand& command) override;
   // Per-fence "pending signal" tracking, delegated to FencePendingSignalService.
@@ -112,6 +114,30 @@ public:
   void Post(vkDestroyFenceCommand& command) override;
   void Pre(vkCreateRayTracingPipelinesKHRCommand& command) override;
 
+  // Feed SubmissionTrackingService, which lets the event and query catch-up
+  // above wait on the submission that sets the event / writes the query.
+  void Post(vkBeginCommandBufferCommand& command) override;
+  void Post(vkResetCommandBufferCommand& command) override;
+  void Pre(vkFreeCommandBuffersCommand& command) override;
+  void Post(vkCmdSetEventCommand& command) override;
+  void Post(vkCmdSetEvent2Command& command) override;
+  void Post(vkCmdSetEvent2KHRCommand& command) override;
+  void Post(vkCmdResetEventCommand& command) override;
+  void Post(vkCmdResetEvent2Command& command) override;
+  void Post(vkCmdResetEvent2KHRCommand& command) override;
+  void Post(vkCmdEndQueryCommand& command) override;
+  void Post(vkCmdEndQueryIndexedEXTCommand& command) override;
+  void Post(vkCmdWriteTimestampCommand& command) override;
+  void Post(vkCmdWriteTimestamp2Command& command) override;
+  void Post(vkCmdWriteTimestamp2KHRCommand& command) override;
+  void Post(vkCmdWriteAccelerationStructuresPropertiesKHRCommand& command) override;
+  void Post(vkCmdResetQueryPoolCommand& command) override;
+  void Post(vkResetQueryPoolCommand& command) override;
+  void Post(vkResetQueryPoolEXTCommand& command) override;
+  void Post(vkCmdExecuteCommandsCommand& command) override;
+  void Pre(vkDestroyEventCommand& command) override;
+  void Pre(vkDestroyQueryPoolCommand& command) override;
+
 private:
   PlayerManager& m_Manager;
   RayTracingReplayService m_RayTracingService;
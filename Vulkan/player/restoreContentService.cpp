@@ -580,7 +580,20 @@ std::vector<std::pair<uint64_t, VkImageLayout>> RestoreContentService::DrainAppl
 }
 
 void RestoreContentService::OnData(const RestoreContentDataCommand& command) {
-  auto it = m_Sessions.find(command.m_DeviceKey);
+  OnPayload(command.m_DeviceKey, command.m_Regions, Payload::Raw, false, 0);
+}
+
+void RestoreContentService::OnCachedData(const RestoreContentCachedDataCommand& command) {
+  OnPayload(command.m_DeviceKey, command.m_Regions, static_cast<Payload>(command.m_Payload),
+            command.m_Cached != 0, command.m_Value);
+}
+
+void RestoreContentService::OnPayload(uint64_t deviceKey,
+                                      const MemoryRegions& regions,
+                                      Payload payload,
+                                      bool cached,
+                                      uint64_t value) {
+  auto it = m_Sessions.find(deviceKey);
   if (it == m_Sessions.end() || !it->second) {
     return;
   }
@@ -588,9 +601,18 @@ void RestoreContentService::OnData(const RestoreContentDataCommand& command) {
 
   // An invalid session (staging setup failed) still counts data tokens so it is
   // torn down once the recorder's per-resource tokens have all been consumed.
-  for (const auto& region : command.m_Regions.Regions) {
+  for (const auto& region : regions.Regions) {
     ++session.Processed;
 
+    // The recorder caches every raw payload it marks, so the cache is updated
+    // before anything below skips the region to stay in lockstep with it.
+    if (payload == Payload::Raw && cached &&
+        session.CacheIndex.Insert(value, region.Size, [&](uint64_t evicted) {
+          session.CachedPayloads.erase(evicted);
+        })) {
+      session.CachedPayloads[value].assign(region.Data, region.Data + region.Size);
+    }
+
     if (!session.Valid) {
       continue;
     }
@@ -598,12 +620,27 @@ void RestoreContentService::OnData(const RestoreContentDataCommand& command) {
     const size_t resourceIndex = static_cast<size_t>(region.Offset);
     if (resourceIndex >= session.Resources.size()) {
       LOG_WARNING << "RestoreContentService: OnData: resource index " << resourceIndex
-                  << " out of range for device key=" << command.m_DeviceKey;
+                  << " out of range for device key=" << deviceKey;
       continue;
     }
     ResourceDesc& r = session.Resources[resourceIndex];
     const size_t batchIdx = r.BatchIdx;
 
+    const char* srcData = region.Data;
+    uint64_t srcSize = region.Size;
+    if (payload == Payload::Reference) {
+      auto cachedPayload = session.CachedPayloads.find(value);
+      if (cachedPayload == session.CachedPayloads.end()) {
+        LOG_WARNING << "RestoreContentService: OnData: unresolved content reference for "
+                       "resource index "
+                    << resourceIndex;
+        srcSize = 0;
+      } else {
+        srcData = cachedPayload->second.data();
+        srcSize = cachedPayload->second.size();
+      }
+    }
+
     // Advance batches even for empty (failed-readback) resources so earlier
     // batches flush at the right time and CurrentBatch is always set.
     if (batchIdx != session.CurrentBatch) {
@@ -614,7 +651,7 @@ void RestoreContentService::OnData(const RestoreContentDataCommand& command) {
       session.CurrentBatch = batchIdx;
     }
 
-    if (region.Size == 0) {
+    if (payload != Payload::Fill && srcSize == 0) {
       continue; // readback failed at record time: nothing to upload
     }
 
@@ -627,14 +664,24 @@ void RestoreContentService::OnData(const RestoreContentDataCommand& command) {
     if (r.BaseOffset + r.Size > session.StagingSize) {
       continue;
     }
-    VkDeviceSize copySize = std::min<VkDeviceSize>(region.Size, r.Size);
-    std::memcpy(static_cast<char*>(slot.Mapped) + r.BaseOffset, region.Data,
-                static_cast<size_t>(copySize));
+    char* dst = static_cast<char*>(slot.Mapped) + r.BaseOffset;
+    if (payload == Payload::Fill) {
+      const uint32_t word = static_cast<uint32_t>(value);
+      const size_t words = static_cast<size_t>(r.Size / sizeof(word));
+      for (size_t w = 0; w < words; ++w) {
+        std::memcpy(dst + w * sizeof(word), &word, sizeof(word));
+      }
+      srcSize = words * sizeof(word);
+      srcData = dst;
+    }
+    VkDeviceSize copySize = std::min<VkDeviceSize>(srcSize, r.Size);
+    if (srcData != dst) {
+      std::memcpy(dst, srcData, static_cast<size_t>(copySize));
+    }
     // The copy commands always transfer the manifest size, so a short token
     // would otherwise upload whatever an earlier batch left in the slot.
     if (copySize < r.Size) {
-      std::memset(static_cast<char*>(slot.Mapped) + r.BaseOffset + copySize, 0,
-                  static_cast<size_t>(r.Size - copySize));
+      std::memset(dst + copySize, 0, static_cast<size_t>(r.Size - copySize));
     }
     r.Received = true;
   }
@@ -40,9 +40,10 @@ class PlayerManager;
 //     resource larger than those bounds grows the slot to fit it, and is left
 //     unrestored only if even that one slot cannot be allocated.
 //   * As Data tokens arrive it copies the bytes into the current batch's
-//     staging slot; when a batch fills it records copy commands and submits
-//     them, cycling through a small ring of staging slots so GPU upload of one
-//     batch overlaps the host fill of the next.
+//     staging slot (expanding fills and resolving references to earlier
+//     payloads from a small per-manifest cache); when a batch fills it records
+//     copy commands and submits them, cycling through a small ring of staging
+//     slots so GPU upload of one batch overlaps the host fill of the next.
 //   * Once it has consumed one data token per manifest entry it flushes the
 //     final batch, waits for all in-flight work, and destroys every staging
 //     object.  No separate end token is needed.
@@ -60,6 +61,7 @@ public:
 
   void Manifest(const RestoreContentManifestCommand& command);
   void OnData(const RestoreContentDataCommand& command);
+  void OnCachedData(const RestoreContentCachedDataCommand& command);
 
   // Images an upload was actually submitted for, paired with the layout its final barrier
   // leaves them in. The barriers are recorded here rather than replayed from the stream, so
@@ -69,6 +71,8 @@ public:
   std::vector<std::pair<uint64_t, VkImageLayout>> DrainAppliedImageLayouts();
 
 private:
+  using Payload = RestoreContentCachedDataCommand::Payload;
+
   struct ResourceDesc {
     bool IsImage{false};
     uint64_t DstKey{0};
@@ -120,8 +124,20 @@ private:
     // Resources.size() the final batch is flushed and the staging torn down.
     size_t Processed{0};
     bool Valid{false};
+    // Bytes of the raw payloads the recorder may later reference, keyed by
+    // hash; evicted in lockstep with the recorder's RestoreContentCacheIndex.
+    RestoreContentCacheIndex CacheIndex;
+    std::unordered_map<uint64_t, std::vector<char>> CachedPayloads;
   };
 
+  // Shared by both data tokens: a plain RestoreContentData token is an uncached
+  // raw payload.
+  void OnPayload(uint64_t deviceKey,
+                 const MemoryRegions& regions,
+                 Payload payload,
+                 bool cached,
+                 uint64_t value);
+
   // Wait for (and recycle) the slot that will hold batchIdx, so its previous
   // in-flight submission has finished before we overwrite its staging bytes.
   void BeginBatch(Session& session, size_t batchIdx);
@@ -0,0 +1,340 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#include "submissionTrackingService.h"
+#include "playerManager.h"
+#include "log.h"
+
+#include <algorithm>
+
+namespace gits {
+namespace vulkan {
+
+namespace {
+
+template <typename T>
+void AddUnique(std::vector<T>& values, T value) {
+  if (std::find(values.begin(), values.end(), value) == values.end()) {
+    values.push_back(value);
+  }
+}
+
+} // namespace
+
+void SubmissionTrackingService::TrackQueue(VkDevice device, VkQueue queue) {
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_QueueDevices[queue] = device;
+}
+
+void SubmissionTrackingService::ResetCommandBuffer(VkCommandBuffer commandBuffer) {
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_CommandBuffers.erase(commandBuffer);
+}
+
+void SubmissionTrackingService::FreeCommandBuffers(uint32_t count,
+                                                   const VkCommandBuffer* commandBuffers) {
+  if (commandBuffers == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  for (uint32_t i = 0; i < count; ++i) {
+    m_CommandBuffers.erase(commandBuffers[i]);
+  }
+}
+
+void SubmissionTrackingService::RecordSetEvent(VkCommandBuffer commandBuffer, VkEvent event) {
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_CommandBuffers[commandBuffer].EventOps.push_back({event, false});
+}
+
+void SubmissionTrackingService::RecordResetEvent(VkCommandBuffer commandBuffer, VkEvent event) {
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_CommandBuffers[commandBuffer].EventOps.push_back({event, true});
+}
+
+void SubmissionTrackingService::RecordQueryWrite(VkCommandBuffer commandBuffer,
+                                                 VkQueryPool queryPool,
+                                                 uint32_t firstQuery,
+                                                 uint32_t queryCount) {
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_CommandBuffers[commandBuffer].QueryOps.push_back({queryPool, firstQuery, queryCount, false});
+}
+
+void SubmissionTrackingService::RecordQueryReset(VkCommandBuffer commandBuffer,
+                                                 VkQueryPool queryPool,
+                                                 uint32_t firstQuery,
+                                                 uint32_t queryCount) {
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_CommandBuffers[commandBuffer].QueryOps.push_back({queryPool, firstQuery, queryCount, true});
+}
+
+void SubmissionTrackingService::RecordExecuteCommands(
+    VkCommandBuffer commandBuffer, uint32_t count, const VkCommandBuffer* secondaryCommandBuffers) {
+  if (secondaryCommandBuffers == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  for (uint32_t i = 0; i < count; ++i) {
+    auto it = m_CommandBuffers.find(secondaryCommandBuffers[i]);
+    if (it == m_CommandBuffers.end()) {
+      continue;
+    }
+    // Copy first: inserting the primary may rehash and move the secondary.
+    CommandBufferWrites writes = it->second;
+    auto& primary = m_CommandBuffers[commandBuffer];
+    primary.EventOps.insert(primary.EventOps.end(), writes.EventOps.begin(),
+                            writes.EventOps.end());
+    primary.QueryOps.insert(primary.QueryOps.end(), writes.QueryOps.begin(),
+                            writes.QueryOps.end());
+  }
+}
+
+void SubmissionTrackingService::OnSubmit(VkQueue queue,
+                                         const std::vector<VkCommandBuffer>& commandBuffers) {
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  std::vector<const CommandBufferWrites*> writes;
+  for (VkCommandBuffer commandBuffer : commandBuffers) {
+    auto it = m_CommandBuffers.find(commandBuffer);
+    if (it != m_CommandBuffers.end()) {
+      writes.push_back(&it->second);
+    }
+  }
+  if (writes.empty()) {
+    return;
+  }
+  auto deviceIt = m_QueueDevices.find(queue);
+  if (deviceIt == m_QueueDevices.end()) {
+    return;
+  }
+
+  // No fence yet: most submits are never polled, and an empty submit queued later
+  // still waits for this one.
+  SubmissionPtr& submission = m_OpenSubmissions[queue];
+  if (!submission) {
+    submission = std::make_shared<Submission>();
+    submission->Device = deviceIt->second;
+    submission->Queue = queue;
+  }
+
+  for (const auto* commandBufferWrites : writes) {
+    for (const auto& op : commandBufferWrites->EventOps) {
+      if (op.Reset) {
+        m_EventSubmissions.erase(op.Event);
+      } else {
+        m_EventSubmissions[op.Event] = submission;
+      }
+    }
+    for (const auto& op : commandBufferWrites->QueryOps) {
+      auto& querySubmissions = m_QuerySubmissions[op.QueryPool];
+      if (querySubmissions.size() < op.FirstQuery + op.QueryCount) {
+        querySubmissions.resize(op.FirstQuery + op.QueryCount);
+      }
+      for (uint32_t i = op.FirstQuery; i < op.FirstQuery + op.QueryCount; ++i) {
+        querySubmissions[i] = op.Reset ? nullptr : submission;
+      }
+    }
+  }
+}
+
+void SubmissionTrackingService::ResetQueries(VkQueryPool queryPool,
+                                             uint32_t firstQuery,
+                                             uint32_t queryCount) {
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  auto it = m_QuerySubmissions.find(queryPool);
+  if (it == m_QuerySubmissions.end()) {
+    return;
+  }
+  auto& querySubmissions = it->second;
+  for (uint32_t i = firstQuery; i < firstQuery + queryCount && i < querySubmissions.size(); ++i) {
+    querySubmissions[i] = nullptr;
+  }
+}
+
+bool SubmissionTrackingService::EnsureFenceLocked(const SubmissionPtr& submission) {
+  if (submission->Fence != VK_NULL_HANDLE) {
+    return true;
+  }
+  VkFence fence = AcquireFenceLocked(submission->Device);
+  if (fence == VK_NULL_HANDLE) {
+    return false;
+  }
+  // An empty submit signals its fence once all work previously submitted to the
+  // queue has completed, which includes every submit tracked by this submission.
+  auto& dispatchTable = m_Manager.GetDeviceDispatchTable(submission->Device);
+  VkResult result = dispatchTable.vkQueueSubmit(submission->Queue, 0, nullptr, fence);
+  if (result != VK_SUCCESS) {
+    LOG_WARNING << "SubmissionTrackingService: Tracking submit failed (" << result << ")";
+    dispatchTable.vkDestroyFence(submission->Device, fence, nullptr);
+    return false;
+  }
+  submission->Fence = fence;
+  m_DeviceSubmissions[submission->Device].push_back(submission);
+  // Later submits to the queue are not covered by this fence.
+  auto it = m_OpenSubmissions.find(submission->Queue);
+  if (it != m_OpenSubmissions.end() && it->second == submission) {
+    m_OpenSubmissions.erase(it);
+  }
+  return true;
+}
+
+VkFence SubmissionTrackingService::AcquireFenceLocked(VkDevice device) {
+  auto& dispatchTable = m_Manager.GetDeviceDispatchTable(device);
+  auto& submissions = m_DeviceSubmissions[device];
+  for (auto it = submissions.begin(); it != submissions.end(); ++it) {
+    if (it->use_count() == 1 &&
+        dispatchTable.vkGetFenceStatus(device, (*it)->Fence) == VK_SUCCESS) {
+      VkFence fence = (*it)->Fence;
+      dispatchTable.vkResetFences(device, 1, &fence);
+      submissions.erase(it);
+      return fence;
+    }
+  }
+
+  VkFenceCreateInfo createInfo{};
+  createInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+  VkFence fence = VK_NULL_HANDLE;
+  if (dispatchTable.vkCreateFence(device, &createInfo, nullptr, &fence) != VK_SUCCESS) {
+    return VK_NULL_HANDLE;
+  }
+  return fence;
+}
+
+SubmissionTrackingService::WaitResult SubmissionTrackingService::WaitForEvent(VkDevice device,
+                                                                             VkEvent event) {
+  SubmissionPtr submission;
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_EventSubmissions.find(event);
+    if (it == m_EventSubmissions.end() || it->second->Device != device ||
+        !EnsureFenceLocked(it->second)) {
+      return WaitResult::Untracked;
+    }
+    submission = it->second;
+  }
+  return Wait(submission);
+}
+
+SubmissionTrackingService::WaitResult SubmissionTrackingService::WaitForQueryPool(
+    VkDevice device,
+    VkQueryPool queryPool,
+    uint32_t firstQuery,
+    uint32_t queryCount,
+    bool& outRangeWritten) {
+  outRangeWritten = false;
+  std::vector<SubmissionPtr> submissions;
+  bool rangeWritten = true;
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_QuerySubmissions.find(queryPool);
+    if (it == m_QuerySubmissions.end()) {
+      return WaitResult::Untracked;
+    }
+    const auto& querySubmissions = it->second;
+    for (uint32_t i = firstQuery; i < firstQuery + queryCount; ++i) {
+      if (i >= querySubmissions.size() || !querySubmissions[i]) {
+        rangeWritten = false;
+        continue;
+      }
+      if (querySubmissions[i]->Device != device) {
+        return WaitResult::Untracked;
+      }
+      AddUnique(submissions, querySubmissions[i]);
+    }
+    if (submissions.empty()) {
+      return WaitResult::Untracked;
+    }
+    for (const auto& submission : submissions) {
+      if (!EnsureFenceLocked(submission)) {
+        return WaitResult::Untracked;
+      }
+    }
+  }
+  for (const auto& submission : submissions) {
+    WaitResult result = Wait(submission);
+    if (result != WaitResult::Completed) {
+      return result;
+    }
+  }
+  outRangeWritten = rangeWritten;
+  return WaitResult::Completed;
+}
+
+SubmissionTrackingService::WaitResult SubmissionTrackingService::Wait(
+    const SubmissionPtr& submission) {
+  // The held reference keeps the fence from being reset and reused meanwhile.
+  auto& dispatchTable = m_Manager.GetDeviceDispatchTable(submission->Device);
+  switch (dispatchTable.vkWaitForFences(submission->Device, 1, &submission->Fence, VK_TRUE,
+                                        kWaitTimeout)) {
+  case VK_SUCCESS:
+    return WaitResult::Completed;
+  case VK_TIMEOUT:
+    return WaitResult::Pending;
+  default:
+    return WaitResult::Untracked;
+  }
+}
+
+void SubmissionTrackingService::ForgetEvent(VkEvent event) {
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_EventSubmissions.erase(event);
+}
+
+void SubmissionTrackingService::ForgetQueryPool(VkQueryPool queryPool) {
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_QuerySubmissions.erase(queryPool);
+}
+
+void SubmissionTrackingService::DestroyDevice(VkDevice device) {
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  for (auto it = m_EventSubmissions.begin(); it != m_EventSubmissions.end();) {
+    if (it->second->Device == device) {
+      it = m_EventSubmissions.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  // A query pool belongs to a single device, so one written query identifies it.
+  for (auto it = m_QuerySubmissions.begin(); it != m_QuerySubmissions.end();) {
+    auto written =
+        std::find_if(it->second.begin(), it->second.end(),
+                     [](const SubmissionPtr& submission) { return submission != nullptr; });
+    if (written != it->second.end() && (*written)->Device == device) {
+      it = m_QuerySubmissions.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  for (auto it = m_OpenSubmissions.begin(); it != m_OpenSubmissions.end();) {
+    if (it->second->Device == device) {
+      it = m_OpenSubmissions.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  for (auto it = m_QueueDevices.begin(); it != m_QueueDevices.end();) {
+    if (it->second == device) {
+      it = m_QueueDevices.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  auto it = m_DeviceSubmissions.find(device);
+  if (it == m_DeviceSubmissions.end()) {
+    return;
+  }
+  // All queue work has completed before the application destroys the device.
+  auto& dispatchTable = m_Manager.GetDeviceDispatchTable(device);
+  for (const auto& submission : it->second) {
+    dispatchTable.vkDestroyFence(device, submission->Fence, nullptr);
+  }
+  m_DeviceSubmissions.erase(it);
+}
+
+} // namespace vulkan
+} // namespace gits
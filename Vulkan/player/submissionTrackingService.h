@@ -0,0 +1,146 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#pragma once
+
+#include "vulkanHeader2.h"
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace gits {
+namespace vulkan {
+
+class PlayerManager;
+
+// Remembers, during replay, which queue submission last set each VkEvent (via
+// vkCmdSetEvent*) and last wrote each query of each VkQueryPool (end query,
+// timestamps, acceleration structure properties), so that a status poll that
+// finds the result not yet available can block on exactly that submission
+// instead of polling the event or idling the whole device.
+//
+// A submission is made waitable only when a poll needs it: an empty vkQueueSubmit
+// with a player-owned fence is then queued on the submission's queue, and the
+// fence signals once all work previously submitted to it has completed.  Every
+// tracked submit on a queue until then shares that one fence.  The application's
+// own fence is never used, as it may be reset or reused before the poll, and it
+// cannot be added to the real submit, which has already reached the driver when
+// the layer sees it.
+//
+// Because that fence also covers earlier work on the queue, which may wait on a
+// host vkSetEvent or semaphore signal the stream issues only later, every wait is
+// bounded (kWaitTimeout).  Callers poll on a timeout instead of blocking.
+// Thread-safe.
+class SubmissionTrackingService {
+public:
+  enum class WaitResult {
+    Untracked, // no submission is known
+    Completed, // the submission has completed
+    Pending,   // the submission did not complete within kWaitTimeout
+  };
+
+  static constexpr uint64_t kWaitTimeout = 5'000'000; // ns
+
+  explicit SubmissionTrackingService(PlayerManager& manager) : m_Manager(manager) {}
+
+  void TrackQueue(VkDevice device, VkQueue queue);
+
+  void ResetCommandBuffer(VkCommandBuffer commandBuffer);
+  void FreeCommandBuffers(uint32_t count, const VkCommandBuffer* commandBuffers);
+  void RecordSetEvent(VkCommandBuffer commandBuffer, VkEvent event);
+  void RecordResetEvent(VkCommandBuffer commandBuffer, VkEvent event);
+  // Queries [firstQuery, firstQuery + queryCount) of queryPool are written / reset
+  // when commandBuffer executes.
+  void RecordQueryWrite(VkCommandBuffer commandBuffer,
+                        VkQueryPool queryPool,
+                        uint32_t firstQuery,
+                        uint32_t queryCount);
+  void RecordQueryReset(VkCommandBuffer commandBuffer,
+                        VkQueryPool queryPool,
+                        uint32_t firstQuery,
+                        uint32_t queryCount);
+  void RecordExecuteCommands(VkCommandBuffer commandBuffer,
+                             uint32_t count,
+                             const VkCommandBuffer* secondaryCommandBuffers);
+
+  // Called after a successful submit of commandBuffers to queue.
+  void OnSubmit(VkQueue queue, const std::vector<VkCommandBuffer>& commandBuffers);
+
+  // vkResetQueryPool from the host.
+  void ResetQueries(VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount);
+
+  // Wait up to kWaitTimeout for the submission that last set event.  Untracked
+  // if no such submission is known, e.g. the event is set from the host.
+  WaitResult WaitForEvent(VkDevice device, VkEvent event);
+  // Wait up to kWaitTimeout for the submissions that wrote the queries.  Untracked
+  // if none is known, e.g. the pool was written before a subcapture cut.
+  // outRangeWritten tells whether every query in the range was written by a
+  // tracked submission since its last reset; only then can the range be read with
+  // VK_QUERY_RESULT_WAIT_BIT without waiting forever.
+  WaitResult WaitForQueryPool(VkDevice device,
+                              VkQueryPool queryPool,
+                              uint32_t firstQuery,
+                              uint32_t queryCount,
+                              bool& outRangeWritten);
+
+  void ForgetEvent(VkEvent event);
+  void ForgetQueryPool(VkQueryPool queryPool);
+  void DestroyDevice(VkDevice device);
+
+private:
+  struct QueryOp {
+    VkQueryPool QueryPool{VK_NULL_HANDLE};
+    uint32_t FirstQuery{};
+    uint32_t QueryCount{};
+    bool Reset{};
+  };
+
+  struct EventOp {
+    VkEvent Event{VK_NULL_HANDLE};
+    bool Reset{};
+  };
+
+  struct CommandBufferWrites {
+    // Both in recording order, so a reset after a set / write cancels it out.
+    std::vector<EventOp> EventOps;
+    std::vector<QueryOp> QueryOps;
+  };
+
+  // All tracked work submitted to Queue up to the point Fence is queued.  Fence is
+  // null until a poll needs to wait on it.
+  struct Submission {
+    VkDevice Device{VK_NULL_HANDLE};
+    VkQueue Queue{VK_NULL_HANDLE};
+    VkFence Fence{VK_NULL_HANDLE};
+  };
+  using SubmissionPtr = std::shared_ptr<Submission>;
+
+  // Queue the fence of submission if it has none yet.  Return false on failure.
+  bool EnsureFenceLocked(const SubmissionPtr& submission);
+  VkFence AcquireFenceLocked(VkDevice device);
+  WaitResult Wait(const SubmissionPtr& submission);
+
+private:
+  PlayerManager& m_Manager;
+  std::mutex m_Mutex;
+  std::unordered_map<VkQueue, VkDevice> m_QueueDevices;
+  std::unordered_map<VkCommandBuffer, CommandBufferWrites> m_CommandBuffers;
+  std::unordered_map<VkEvent, SubmissionPtr> m_EventSubmissions;
+  // Per query index; null for queries not written by a tracked submit since reset.
+  std::unordered_map<VkQueryPool, std::vector<SubmissionPtr>> m_QuerySubmissions;
+  // The submission each queue's next tracked submit joins, until it gets a fence.
+  std::unordered_map<VkQueue, SubmissionPtr> m_OpenSubmissions;
+  // Every fenced submission per device.  One only referenced from here whose
+  // fence has signalled gives its fence to the next submission that needs one.
+  std::unordered_map<VkDevice, std::vector<SubmissionPtr>> m_DeviceSubmissions;
+};
+
+} // namespace vulkan
+} // namespace gits
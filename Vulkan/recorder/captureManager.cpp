@@ -38,8 +38,8 @@ CaptureManager::CaptureManager() {
   m_MapTrackingService.reset(new MapTrackingService(*m_Recorder));
   m_WindowTrackingService.reset(new WindowTrackingService(*m_Recorder));
 
-  m_DispatchTablesHolder = std::make_unique<DispatchTablesHolder>(
-      m_InstanceDispatchTable, m_DeviceDispatchTable, m_DispatchTablesMutex);
+  m_DispatchTablesHolder =
+      std::make_unique<DispatchTablesHolder>(m_InstanceDispatchTable, m_DeviceDispatchTable);
 
   m_PluginService.LoadPlugins();
   m_LayerManager.LoadLayers(*this, *m_Recorder.get(), m_PluginService);
@@ -54,28 +54,28 @@ void CaptureManager::LoadGlobalFunctions(PFN_vkGetInstanceProcAddr getProcAddr)
 void CaptureManager::LoadInstanceFunctions(PFN_vkGetInstanceProcAddr getProcAddr,
                                            VkInstance instance) {
   void* dispatchKey = *reinterpret_cast<void**>(instance);
-  std::unique_lock lock(m_DispatchTablesMutex);
-  auto& dispatchTable = m_InstanceDispatchTable[dispatchKey];
+  auto& dispatchTable = m_InstanceDispatchTable.Create(dispatchKey);
   LoadInstanceLevelFunctions(getProcAddr, instance, dispatchTable);
+  m_InstanceDispatchTable.Publish(dispatchKey);
   m_PluginService.SetVulkanInstanceDispatchTable(&dispatchTable);
 }
 
 void CaptureManager::LoadDeviceFunctions(PFN_vkGetDeviceProcAddr getProcAddr, VkDevice device) {
   void* dispatchKey = *reinterpret_cast<void**>(device);
-  std::unique_lock lock(m_DispatchTablesMutex);
-  auto& dispatchTable = m_DeviceDispatchTable[dispatchKey];
+  auto& dispatchTable = m_DeviceDispatchTable.Create(dispatchKey);
   LoadDeviceLevelFunctions(getProcAddr, device, dispatchTable);
+  m_DeviceDispatchTable.Publish(dispatchKey);
   m_PluginService.SetVulkanDeviceDispatchTable(&dispatchTable);
 }
 
 void CaptureManager::LoadDeviceFunctions(void* dispatchKey, VkDevice device) {
-  std::unique_lock lock(m_DispatchTablesMutex);
-  auto& instanceTable = m_InstanceDispatchTable[dispatchKey];
+  auto& instanceTable = m_InstanceDispatchTable.Get(dispatchKey);
   PFN_vkGetDeviceProcAddr getDeviceProcAddr = reinterpret_cast<PFN_vkGetDeviceProcAddr>(
       instanceTable.vkGetInstanceProcAddr(instanceTable.instance, "vkGetDeviceProcAddr"));
   void* deviceDispatchKey = *reinterpret_cast<void**>(device);
-  auto& dispatchTable = m_DeviceDispatchTable[deviceDispatchKey];
+  auto& dispatchTable = m_DeviceDispatchTable.Create(deviceDispatchKey);
   LoadDeviceLevelFunctions(getDeviceProcAddr, device, dispatchTable);
+  m_DeviceDispatchTable.Publish(deviceDispatchKey);
   m_PluginService.SetVulkanDeviceDispatchTable(&dispatchTable);
   m_PluginService.SetVulkanInstanceDispatchTable(&instanceTable);
 }
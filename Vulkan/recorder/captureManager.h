@@ -21,7 +21,6 @@
 #include "orderingRecorder.h"
 
 #include <atomic>
-#include <shared_mutex>
 
 namespace gits {
 namespace vulkan {
@@ -35,10 +34,19 @@ public:
     return m_CommandUniqueKey.fetch_add(1, std::memory_order_relaxed) + 1;
   }
 
+  // Handle keys must follow creation order (subcapture restores parents before
+  // children by key), so they all come from the one shared counter; per-thread
+  // key blocks would interleave them.
   GITSKey CreateHandleKey() {
     return m_HandleUniqueKey.fetch_add(1, std::memory_order_relaxed) + 1;
   }
 
+  // Reserves rangeSize consecutive handle keys with a single atomic operation
+  // and returns the first one.
+  GITSKey CreateHandleKeyRange(uint32_t rangeSize) {
+    return m_HandleUniqueKey.fetch_add(rangeSize, std::memory_order_relaxed) + 1;
+  }
+
   VkGlobalLevelDispatchTable& GetGlobalDispatchTable() {
     return m_GlobalDispatchTable;
   }
@@ -46,15 +54,13 @@ public:
   template <typename Handle>
   VkInstanceLevelDispatchTable& GetInstanceDispatchTable(Handle handle) {
     void* dispatchKey = *reinterpret_cast<void**>(handle);
-    std::shared_lock lock(m_DispatchTablesMutex);
-    return m_InstanceDispatchTable[dispatchKey];
+    return m_InstanceDispatchTable.Get(dispatchKey);
   }
 
   template <typename Handle>
   VkDeviceLevelDispatchTable& GetDeviceDispatchTable(Handle handle) {
     void* dispatchKey = *reinterpret_cast<void**>(handle);
-    std::shared_lock lock(m_DispatchTablesMutex);
-    return m_DeviceDispatchTable[dispatchKey];
+    return m_DeviceDispatchTable.Get(dispatchKey);
   }
 
   DispatchTablesHolder& GetDispatchTablesHolder() {
@@ -108,12 +114,14 @@ private:
   std::unique_ptr<stream::OrderingRecorder> m_Recorder;
   //std::atomic<uint32_t> m_RecursionDepth{0};
   static thread_local uint32_t m_RecursionDepth;
-  std::atomic<GITSKey> m_CommandUniqueKey{0};
-  std::atomic<GITSKey> m_HandleUniqueKey{0};
-  VkGlobalLevelDispatchTable m_GlobalDispatchTable{};
-  std::shared_mutex m_DispatchTablesMutex;
-  std::unordered_map<void*, VkInstanceLevelDispatchTable> m_InstanceDispatchTable{};
-  std::unordered_map<void*, VkDeviceLevelDispatchTable> m_DeviceDispatchTable{};
+  // The counters are shared by all recording threads. Keeping each on its own
+  // cache line only stops them from invalidating each other and the read-mostly
+  // members around them; every key still costs an atomic on a contended line.
+  alignas(64) std::atomic<GITSKey> m_CommandUniqueKey{0};
+  alignas(64) std::atomic<GITSKey> m_HandleUniqueKey{0};
+  alignas(64) VkGlobalLevelDispatchTable m_GlobalDispatchTable{};
+  DispatchTableMap<VkInstanceLevelDispatchTable> m_InstanceDispatchTable;
+  DispatchTableMap<VkDeviceLevelDispatchTable> m_DeviceDispatchTable;
   std::unique_ptr<DispatchTablesHolder> m_DispatchTablesHolder;
 
   std::unique_ptr<MapTrackingService> m_MapTrackingService;
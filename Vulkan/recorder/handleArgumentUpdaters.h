@@ -94,11 +94,23 @@ void UpdateOutputHandle(CaptureManager& manager, HandleArrayOutputArgument<T>& a
     if (!arg.Value[i]) {
       continue;
     }
-    GITSKey existingKey = HandleMapService::Get().TryGetKey(arg.Value[i]);
-    if (existingKey) {
-      arg.Keys[i] = existingKey;
-    } else {
-      arg.Keys[i] = manager.CreateHandleKey();
+    arg.Keys[i] = HandleMapService::Get().TryGetKey(arg.Value[i]);
+  }
+  // Reserve keys for all newly created handles at once instead of one atomic
+  // increment per array element.
+  uint32_t newHandles = 0;
+  for (uint32_t i = 0; i < arg.Size; ++i) {
+    if (arg.Value[i] && !arg.Keys[i]) {
+      ++newHandles;
+    }
+  }
+  if (newHandles == 0) {
+    return;
+  }
+  GITSKey nextKey = manager.CreateHandleKeyRange(newHandles);
+  for (uint32_t i = 0; i < arg.Size; ++i) {
+    if (arg.Value[i] && !arg.Keys[i]) {
+      arg.Keys[i] = nextKey++;
       HandleMapService::Get().SetKey(arg.Value[i], arg.Keys[i]);
     }
   }
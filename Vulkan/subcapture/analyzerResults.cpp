@@ -22,6 +22,15 @@ AnalyzerResults::AnalyzerResults() {
   m_Optimize = Configurator::Get().common.player.subcapture.optimize;
   // Affects optimized and unoptimized runs
   m_CaptureAsBuildInputs = Configurator::Get().common.player.subcapture.vulkan.captureASBuildInputs;
+  Load();
+}
+
+void AnalyzerResults::Load() {
+  m_ObjectKeys.clear();
+  m_BlasChainLoaded = false;
+  m_BlasChain.clear();
+  m_RetainedBlasCommands.clear();
+  m_BlasSourceByCommand.clear();
   if (!m_Optimize) {
     // No analysis-derived behaviour at all, so a file left over from an earlier
     // optimized run must not be read.
@@ -44,6 +44,10 @@ class AnalyzerResults {
 public:
   AnalyzerResults();
 
+  // (Re)loads the analysis file.  The constructor loads it once; the single-pass
+  // subcapture reloads it after writing it at the end of the range.
+  void Load();
+
   // True if the given object key should be restored in the recording pass.
   // Returns true (restore everything) when optimization is off or no keys were
   // loaded; otherwise tests set membership.
@@ -27,8 +27,7 @@ void CommandBufferLifecycleService::ClearState(CommandBufferState& state) {
   state.DependencyKeys.clear();
   state.BeginCommandBuffer.clear();
   state.EndCommandBuffer.clear();
-  state.RecordedCommands.clear();
-  state.RecordedCommandIds.clear();
+  state.RecordedCommands.Clear();
   state.EventStatesAfterSubmit.clear();
   state.ResetQueriesAfterSubmit.clear();
   state.UsedQueriesAfterSubmit.clear();
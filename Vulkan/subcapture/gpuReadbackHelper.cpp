@@ -11,6 +11,8 @@
 #include "handleMapService.h"
 #include "log.h"
 
+#include <algorithm>
+#include <array>
 #include <cstring>
 
 namespace gits {
@@ -41,6 +43,18 @@ bool GpuReadbackHelper::IsHostVisible(uint64_t physDevKey, uint32_t memoryTypeIn
          0;
 }
 
+bool GpuReadbackHelper::IsHostCoherent(VkPhysicalDevice physDevice, uint32_t memoryTypeIndex) {
+  VkPhysicalDeviceMemoryProperties props{};
+  m_Player.GetInstanceDispatchTable(physDevice)
+      .vkGetPhysicalDeviceMemoryProperties(physDevice, &props);
+  if (memoryTypeIndex >= props.memoryTypeCount) {
+    return false;
+  }
+  constexpr VkMemoryPropertyFlags kRequired =
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+  return (props.memoryTypes[memoryTypeIndex].propertyFlags & kRequired) == kRequired;
+}
+
 uint32_t GpuReadbackHelper::FindStagingMemoryTypeForPhysDevice(VkPhysicalDevice physDevice,
                                                                uint32_t memoryTypeBits) {
   VkPhysicalDeviceMemoryProperties props{};
@@ -1287,6 +1301,393 @@ bool GpuReadbackHelper::ReadImage(uint64_t deviceKey,
   return ok;
 }
 
+// ---------------------------------------------------------------------------
+// ReadResources
+//
+// Batched content-restore readback.  Consecutive requests are packed into one
+// command buffer whose copies land in one slot of a small staging ring, up to
+// kReadbackBatchBytes per batch (a single larger resource gets a batch of its
+// own and the slot's staging buffer grows to fit).  Each batch is submitted
+// with its own fence and is only drained - fence wait, then consume for each
+// entry in request order - when its slot comes round again or at the end, so
+// the host serializes one batch while the GPU copies the following ones.
+// HOST_COHERENT buffers take no slot space: they are read from a mapping when
+// their batch drains, which keeps consume in request order.
+// ---------------------------------------------------------------------------
+
+namespace {
+
+constexpr VkDeviceSize kReadbackBatchBytes = 64ull * 1024 * 1024;
+constexpr size_t kReadbackBatchEntries = 512;
+constexpr size_t kReadbackSlots = 3;
+// Entries are placed at multiples of this within a slot: vkCmdCopyImageToBuffer
+// needs bufferOffset to be a multiple of the texel block size (up to 32 bytes,
+// including 3-, 6-, 12- and 24-byte formats) and of 4 for depth/stencil
+// (VUID-vkCmdCopyImageToBuffer-dstImage-07975, -07978), so use their LCM.
+constexpr VkDeviceSize kReadbackEntryAlignment = 96;
+
+enum class ReadbackEntryKind {
+  Gpu,
+  Host,
+  Failed
+};
+
+struct ReadbackEntry {
+  size_t Index{};
+  ReadbackEntryKind Kind{ReadbackEntryKind::Failed};
+  VkDeviceSize StagingOffset{};
+  VkDeviceSize Size{};
+  std::vector<VkBufferImageCopy> Regions;
+};
+
+struct ReadbackSlot {
+  VkBuffer Buffer{VK_NULL_HANDLE};
+  VkDeviceMemory Memory{VK_NULL_HANDLE};
+  void* Mapped{};
+  VkDeviceSize Capacity{};
+  VkCommandBuffer CommandBuffer{VK_NULL_HANDLE};
+  VkFence Fence{VK_NULL_HANDLE};
+  bool Submitted{};
+  VkDeviceSize Bytes{};
+  std::vector<ReadbackEntry> Entries;
+};
+
+} // namespace
+
+bool GpuReadbackHelper::ReadResources(uint64_t deviceKey,
+                                      uint64_t physDevKey,
+                                      uint64_t queueKey,
+                                      uint64_t commandPoolKey,
+                                      const std::vector<ReadbackRequest>& requests,
+                                      const ReadbackConsumer& consume) {
+  if (requests.empty()) {
+    return true;
+  }
+
+  auto& hms = HandleMapService::Get();
+  auto device = reinterpret_cast<VkDevice>(hms.TryGetHandle(deviceKey));
+  auto physDevice = reinterpret_cast<VkPhysicalDevice>(hms.TryGetHandle(physDevKey));
+  auto queue = reinterpret_cast<VkQueue>(hms.TryGetHandle(queueKey));
+  auto pool = reinterpret_cast<VkCommandPool>(hms.TryGetHandle(commandPoolKey));
+  if (!device || !physDevice || !queue || !pool) {
+    for (size_t i = 0; i < requests.size(); ++i) {
+      consume(i, nullptr, 0);
+    }
+    return false;
+  }
+
+  auto& dt = m_Player.GetDeviceDispatchTable(device);
+  bool allOk = true;
+
+  // Host reads must observe all work already submitted on this queue, as the
+  // ALL_COMMANDS barrier of a GPU copy on the same queue does.
+  dt.vkQueueWaitIdle(queue);
+
+  auto recordCopies = [&](ReadbackSlot& slot) {
+    VkCommandBufferAllocateInfo ai{};
+    ai.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    ai.commandPool = pool;
+    ai.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    ai.commandBufferCount = 1;
+    if (dt.vkAllocateCommandBuffers(device, &ai, &slot.CommandBuffer) != VK_SUCCESS) {
+      slot.CommandBuffer = VK_NULL_HANDLE;
+      return false;
+    }
+
+    VkCommandBufferBeginInfo bi{};
+    bi.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    bi.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    dt.vkBeginCommandBuffer(slot.CommandBuffer, &bi);
+
+    for (auto& entry : slot.Entries) {
+      if (entry.Kind != ReadbackEntryKind::Gpu) {
+        continue;
+      }
+      const auto& request = requests[entry.Index];
+      if (!request.IsImage) {
+        auto buffer = reinterpret_cast<VkBuffer>(hms.TryGetHandle(request.ResourceKey));
+        if (!buffer) {
+          entry.Kind = ReadbackEntryKind::Failed;
+          continue;
+        }
+        VkBufferMemoryBarrier srcBarrier{};
+        srcBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        srcBarrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+        srcBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        srcBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        srcBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        srcBarrier.buffer = buffer;
+        srcBarrier.offset = 0;
+        srcBarrier.size = VK_WHOLE_SIZE;
+        dt.vkCmdPipelineBarrier(slot.CommandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 1, &srcBarrier, 0,
+                                nullptr);
+
+        VkBufferCopy region{0, entry.StagingOffset, entry.Size};
+        dt.vkCmdCopyBuffer(slot.CommandBuffer, buffer, slot.Buffer, 1, &region);
+        continue;
+      }
+
+      auto image = reinterpret_cast<VkImage>(hms.TryGetHandle(request.ResourceKey));
+      if (!image) {
+        entry.Kind = ReadbackEntryKind::Failed;
+        continue;
+      }
+      // Same transitions as ReadImage; see there for why no ownership transfer is done.
+      const VkImageAspectFlags transitionAspect =
+          AspectMaskForFormat(request.Format, request.Disjoint);
+      VkImageMemoryBarrier toSrc{};
+      toSrc.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+      toSrc.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+      toSrc.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+      toSrc.oldLayout = request.CurrentLayout;
+      toSrc.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+      toSrc.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+      toSrc.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+      toSrc.image = image;
+      toSrc.subresourceRange = {transitionAspect, 0, VK_REMAINING_MIP_LEVELS, 0,
+                                VK_REMAINING_ARRAY_LAYERS};
+      dt.vkCmdPipelineBarrier(slot.CommandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                              VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1,
+                              &toSrc);
+
+      for (auto& region : entry.Regions) {
+        region.bufferOffset += entry.StagingOffset;
+      }
+      dt.vkCmdCopyImageToBuffer(slot.CommandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                slot.Buffer, static_cast<uint32_t>(entry.Regions.size()),
+                                entry.Regions.data());
+
+      VkImageMemoryBarrier restore = toSrc;
+      restore.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+      restore.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+      restore.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+      restore.newLayout = request.CurrentLayout;
+      dt.vkCmdPipelineBarrier(slot.CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                              VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1,
+                              &restore);
+    }
+
+    // One staging barrier for the whole batch: TRANSFER_WRITE -> HOST_READ.
+    VkBufferMemoryBarrier dstBarrier{};
+    dstBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    dstBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    dstBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    dstBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    dstBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    dstBarrier.buffer = slot.Buffer;
+    dstBarrier.offset = 0;
+    dstBarrier.size = VK_WHOLE_SIZE;
+    dt.vkCmdPipelineBarrier(slot.CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                            VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &dstBarrier, 0, nullptr);
+
+    return dt.vkEndCommandBuffer(slot.CommandBuffer) == VK_SUCCESS;
+  };
+
+  auto releaseStaging = [&](ReadbackSlot& slot) {
+    if (slot.Buffer == VK_NULL_HANDLE) {
+      return;
+    }
+    dt.vkUnmapMemory(device, slot.Memory);
+    dt.vkDestroyBuffer(device, slot.Buffer, nullptr);
+    dt.vkFreeMemory(device, slot.Memory, nullptr);
+    slot.Buffer = VK_NULL_HANDLE;
+    slot.Memory = VK_NULL_HANDLE;
+    slot.Mapped = nullptr;
+    slot.Capacity = 0;
+  };
+
+  auto submit = [&](ReadbackSlot& slot) {
+    if (slot.Bytes == 0) {
+      return; // nothing for the GPU, host entries are read when the slot drains
+    }
+    if (slot.Capacity < slot.Bytes) {
+      releaseStaging(slot);
+      const VkDeviceSize capacity = std::max(slot.Bytes, kReadbackBatchBytes);
+      if (!AllocateStagingBuffer(device, physDevice, capacity, slot.Buffer, slot.Memory,
+                                 slot.Mapped)) {
+        slot.Buffer = VK_NULL_HANDLE;
+        slot.Memory = VK_NULL_HANDLE;
+        return;
+      }
+      slot.Capacity = capacity;
+    }
+    if (slot.Fence == VK_NULL_HANDLE) {
+      VkFenceCreateInfo fci{};
+      fci.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+      if (dt.vkCreateFence(device, &fci, nullptr, &slot.Fence) != VK_SUCCESS) {
+        slot.Fence = VK_NULL_HANDLE;
+        return;
+      }
+    }
+    if (!recordCopies(slot)) {
+      return;
+    }
+    VkSubmitInfo si{};
+    si.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    si.commandBufferCount = 1;
+    si.pCommandBuffers = &slot.CommandBuffer;
+    slot.Submitted = dt.vkQueueSubmit(queue, 1, &si, slot.Fence) == VK_SUCCESS;
+  };
+
+  auto drain = [&](ReadbackSlot& slot) {
+    bool copied = false;
+    if (slot.Submitted) {
+      copied = dt.vkWaitForFences(device, 1, &slot.Fence, VK_TRUE, UINT64_MAX) == VK_SUCCESS;
+      dt.vkResetFences(device, 1, &slot.Fence);
+      if (copied) {
+        VkMappedMemoryRange range{};
+        range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+        range.memory = slot.Memory;
+        range.offset = 0;
+        range.size = VK_WHOLE_SIZE;
+        dt.vkInvalidateMappedMemoryRanges(device, 1, &range);
+      }
+    }
+    if (slot.CommandBuffer != VK_NULL_HANDLE) {
+      dt.vkFreeCommandBuffers(device, pool, 1, &slot.CommandBuffer);
+      slot.CommandBuffer = VK_NULL_HANDLE;
+    }
+
+    for (const auto& entry : slot.Entries) {
+      const size_t size = static_cast<size_t>(entry.Size);
+      if (entry.Kind == ReadbackEntryKind::Gpu && copied) {
+        consume(entry.Index, static_cast<const uint8_t*>(slot.Mapped) + entry.StagingOffset,
+                size);
+        continue;
+      }
+      if (entry.Kind == ReadbackEntryKind::Host &&
+          VisitHostMemory(deviceKey, physDevKey, requests[entry.Index],
+                          [&](const uint8_t* data) { consume(entry.Index, data, size); })) {
+        continue;
+      }
+      // The mapping can fail (e.g. out of host address space); a one-shot GPU
+      // copy still works for a host-visible buffer.
+      std::vector<uint8_t> data;
+      if (entry.Kind == ReadbackEntryKind::Host &&
+          ReadBuffer(deviceKey, physDevKey, queueKey, commandPoolKey,
+                     requests[entry.Index].ResourceKey, 0, entry.Size, data)) {
+        consume(entry.Index, data.data(), data.size());
+        continue;
+      }
+      allOk = false;
+      consume(entry.Index, nullptr, 0);
+    }
+    slot.Entries.clear();
+    slot.Submitted = false;
+    slot.Bytes = 0;
+  };
+
+  std::array<ReadbackSlot, kReadbackSlots> slots;
+  size_t current = 0;
+  // Submits the slot being filled and moves on to the next one.  Slots are used
+  // round-robin, so the next one is the oldest in flight: drain it before reuse.
+  auto flush = [&]() {
+    if (slots[current].Entries.empty()) {
+      return;
+    }
+    submit(slots[current]);
+    current = (current + 1) % kReadbackSlots;
+    drain(slots[current]);
+  };
+
+  for (size_t i = 0; i < requests.size(); ++i) {
+    const auto& request = requests[i];
+    ReadbackEntry entry;
+    entry.Index = i;
+    if (request.IsImage) {
+      if (request.Extent.width != 0 && request.Extent.height != 0 && request.Extent.depth != 0) {
+        entry.Size = ComputeImageStagingLayout(request.Format, request.Extent, request.MipLevels,
+                                               request.ArrayLayers, entry.Regions);
+      }
+      if (entry.Size != 0 && !entry.Regions.empty()) {
+        entry.Kind = ReadbackEntryKind::Gpu;
+      }
+    } else if (request.Size != 0) {
+      entry.Size = request.Size;
+      entry.Kind = request.MemoryKey != 0 && IsHostCoherent(physDevice, request.MemoryTypeIndex)
+                       ? ReadbackEntryKind::Host
+                       : ReadbackEntryKind::Gpu;
+    }
+
+    if (slots[current].Entries.size() >= kReadbackBatchEntries) {
+      flush();
+    }
+    if (entry.Kind == ReadbackEntryKind::Gpu) {
+      VkDeviceSize offset = (slots[current].Bytes + kReadbackEntryAlignment - 1) /
+                            kReadbackEntryAlignment * kReadbackEntryAlignment;
+      if (slots[current].Bytes != 0 && offset + entry.Size > kReadbackBatchBytes) {
+        flush();
+        offset = 0;
+      }
+      entry.StagingOffset = offset;
+      slots[current].Bytes = offset + entry.Size;
+    }
+    slots[current].Entries.push_back(std::move(entry));
+  }
+  flush();
+  // 'current' is empty now; the rest drain oldest first.
+  for (size_t i = 1; i < kReadbackSlots; ++i) {
+    drain(slots[(current + i) % kReadbackSlots]);
+  }
+
+  for (auto& slot : slots) {
+    releaseStaging(slot);
+    if (slot.Fence != VK_NULL_HANDLE) {
+      dt.vkDestroyFence(device, slot.Fence, nullptr);
+    }
+  }
+  return allOk;
+}
+
+// ---------------------------------------------------------------------------
+// VisitHostMemory
+// ---------------------------------------------------------------------------
+
+bool GpuReadbackHelper::VisitHostMemory(uint64_t deviceKey,
+                                        uint64_t physDevKey,
+                                        const ReadbackRequest& request,
+                                        const std::function<void(const uint8_t*)>& visit) {
+  if (request.IsImage || request.MemoryKey == 0 || request.Size == 0) {
+    return false;
+  }
+  auto& hms = HandleMapService::Get();
+  auto device = reinterpret_cast<VkDevice>(hms.TryGetHandle(deviceKey));
+  auto physDevice = reinterpret_cast<VkPhysicalDevice>(hms.TryGetHandle(physDevKey));
+  auto memory = reinterpret_cast<VkDeviceMemory>(hms.TryGetHandle(request.MemoryKey));
+  if (!device || !physDevice || !memory) {
+    return false;
+  }
+  // Non-coherent memory would need an invalidate of nonCoherentAtomSize-aligned
+  // ranges first; leave it to the GPU copy.
+  if (!IsHostCoherent(physDevice, request.MemoryTypeIndex)) {
+    return false;
+  }
+
+  // Memory the replayed application keeps mapped cannot be mapped again
+  // (VUID-vkMapMemory-memory-00678), so read through its mapping.
+  auto* mapped = m_Player.GetMapTrackingService().GetData(deviceKey, request.MemoryKey);
+  if (mapped != nullptr && mapped->Ptr != nullptr) {
+    if (request.MemoryOffset < request.MappingOffset ||
+        request.MemoryOffset - request.MappingOffset + request.Size > mapped->Size) {
+      return false;
+    }
+    visit(static_cast<const uint8_t*>(mapped->Ptr) +
+          (request.MemoryOffset - request.MappingOffset));
+    return true;
+  }
+
+  auto& dt = m_Player.GetDeviceDispatchTable(device);
+  void* ptr = nullptr;
+  if (dt.vkMapMemory(device, memory, request.MemoryOffset, request.Size, 0, &ptr) != VK_SUCCESS ||
+      ptr == nullptr) {
+    return false;
+  }
+  visit(static_cast<const uint8_t*>(ptr));
+  dt.vkUnmapMemory(device, memory);
+  return true;
+}
+
 VkDeviceSize GpuReadbackHelper::GetImageStagingLayout(VkFormat format,
                                                       const VkExtent3D& extent,
                                                       uint32_t mipLevels,
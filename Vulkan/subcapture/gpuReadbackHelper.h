@@ -102,6 +102,18 @@ public:
                  std::vector<uint8_t>& outData,
                  std::vector<VkBufferImageCopy>& outRegions) override;
 
+  bool ReadResources(uint64_t deviceKey,
+                     uint64_t physDevKey,
+                     uint64_t queueKey,
+                     uint64_t commandPoolKey,
+                     const std::vector<ReadbackRequest>& requests,
+                     const ReadbackConsumer& consume) override;
+
+  bool VisitHostMemory(uint64_t deviceKey,
+                       uint64_t physDevKey,
+                       const ReadbackRequest& request,
+                       const std::function<void(const uint8_t*)>& visit) override;
+
   bool ReadAccelerationStructureSerialized(uint64_t deviceKey,
                                            uint64_t physDevKey,
                                            uint64_t queueKey,
@@ -158,6 +170,10 @@ private:
                      VkCommandPool pool,
                      std::function<void(VkCommandBuffer)> recordFn);
 
+  // True when memoryTypeIndex is HOST_VISIBLE | HOST_COHERENT, i.e. its bytes can be
+  // read through a mapping without vkInvalidateMappedMemoryRanges.
+  bool IsHostCoherent(VkPhysicalDevice physDevice, uint32_t memoryTypeIndex);
+
   // Internal helper: find a HOST_VISIBLE staging memory type given a resolved
   // VkPhysicalDevice handle directly, avoiding a handle?key?handle round-trip.
   uint32_t FindStagingMemoryTypeForPhysDevice(VkPhysicalDevice physDevice, uint32_t memoryTypeBits);
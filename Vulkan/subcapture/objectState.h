@@ -11,6 +11,7 @@
 #include "vulkanHeader2.h"
 #include "command.h"
 
+#include <cstring>
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
@@ -31,6 +32,12 @@ struct ObjectState {
   ObjectState() = default;
   virtual ~ObjectState() = default;
 
+  // States are allocated from per-size free lists carved out of large chunks (see
+  // objectStateTable.cpp): tracking allocates one per created object, and most of
+  // them are freed again while the stream runs.
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr, size_t size);
+
   uint64_t Key{};       // recorder-side handle key
   uint64_t ParentKey{}; // e.g. device key that owns this object
   // Additional keys that must be restored before this object.  Unlike
@@ -401,6 +408,43 @@ struct ExclusiveOwnerUpdate {
   bool Pending{false};
 };
 
+// Encoded vkCmd* commands recorded into one command buffer, kept back to back in a
+// single byte arena as [CommandId][uint32_t size][size bytes].  Clear() keeps the
+// arena's capacity, so a command buffer re-recorded every frame stops allocating once
+// its arena has grown to the size of one recording.
+struct RecordedCommandLog {
+  // Reserves room for one command of `size` encoded bytes and returns where to encode
+  // it.  The pointer is valid until the next Append.
+  char* Append(CommandId id, uint32_t size) {
+    const size_t offset = Bytes.size();
+    Bytes.resize(offset + sizeof(id) + sizeof(size) + size);
+    std::memcpy(Bytes.data() + offset, &id, sizeof(id));
+    std::memcpy(Bytes.data() + offset + sizeof(id), &size, sizeof(size));
+    return Bytes.data() + offset + sizeof(id) + sizeof(size);
+  }
+
+  // Calls visit(CommandId, const char* data, uint32_t size) for every command, in order.
+  template <typename TVisitor>
+  void ForEach(TVisitor&& visit) const {
+    size_t offset = 0;
+    while (offset < Bytes.size()) {
+      CommandId id;
+      uint32_t size;
+      std::memcpy(&id, Bytes.data() + offset, sizeof(id));
+      std::memcpy(&size, Bytes.data() + offset + sizeof(id), sizeof(size));
+      offset += sizeof(id) + sizeof(size);
+      visit(id, Bytes.data() + offset, size);
+      offset += size;
+    }
+  }
+
+  void Clear() {
+    Bytes.clear();
+  }
+
+  std::vector<char> Bytes;
+};
+
 struct CommandBufferState : ObjectState {
   // Needed for dependency-order restore: pool must exist before allocating buffers.
   uint64_t PoolKey{};
@@ -420,11 +464,9 @@ struct CommandBufferState : ObjectState {
   // Encoded bytes for the vkEndCommandBuffer call that closed the session.
   // Non-empty only while IsExecutable == true.
   std::vector<char> EndCommandBuffer;
-  // Encoded bytes (one entry per call) and matching command IDs for every
-  // vkCmd* issued while IsRecording == true.  Re-emitted verbatim during state
-  // restore in submission order.
-  std::vector<std::vector<char>> RecordedCommands;
-  std::vector<CommandId> RecordedCommandIds;
+  // Encoded bytes and command ID of every vkCmd* issued while IsRecording ==
+  // true.  Re-emitted verbatim during state restore in submission order.
+  RecordedCommandLog RecordedCommands;
   // Net signaled state each event ends up in after this command buffer is
   // submitted and executed (event key -> set/reset).  Populated by
   // vkCmdSetEvent / vkCmdResetEvent (and the 2/2KHR variants); applied to the
@@ -0,0 +1,181 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#include "objectStateTable.h"
+
+#include <mutex>
+#include <new>
+
+namespace gits {
+namespace vulkan {
+
+namespace {
+
+// Free lists of ObjectState-sized blocks, one per 16-byte size class, so that every
+// concrete state type is served from its own list.  Blocks are carved out of 64 KB
+// chunks and recycled, never returned to the system; larger states fall back to the
+// global allocator.
+class ObjectStatePool {
+public:
+  void* Allocate(size_t size) {
+    if (size > kMaxPooledSize) {
+      return ::operator new(size);
+    }
+    const size_t sizeClass = SizeClass(size);
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    FreeBlock*& head = m_FreeLists[sizeClass];
+    if (!head) {
+      Refill(sizeClass);
+    }
+    FreeBlock* block = head;
+    head = block->Next;
+    return block;
+  }
+
+  void Deallocate(void* ptr, size_t size) {
+    if (size > kMaxPooledSize) {
+      ::operator delete(ptr);
+      return;
+    }
+    const size_t sizeClass = SizeClass(size);
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto* block = static_cast<FreeBlock*>(ptr);
+    block->Next = m_FreeLists[sizeClass];
+    m_FreeLists[sizeClass] = block;
+  }
+
+private:
+  static constexpr size_t kGranularity = alignof(std::max_align_t) > 16
+                                             ? alignof(std::max_align_t)
+                                             : 16;
+  static constexpr size_t kMaxPooledSize = 2048;
+  static constexpr size_t kChunkSize = 64 * 1024;
+
+  struct FreeBlock {
+    FreeBlock* Next;
+  };
+
+  static size_t SizeClass(size_t size) {
+    return (size + kGranularity - 1) / kGranularity;
+  }
+
+  void Refill(size_t sizeClass) {
+    const size_t blockSize = sizeClass * kGranularity;
+    m_Chunks.emplace_back(new char[kChunkSize]);
+    char* chunk = m_Chunks.back().get();
+    FreeBlock*& head = m_FreeLists[sizeClass];
+    for (size_t offset = 0; offset + blockSize <= kChunkSize; offset += blockSize) {
+      auto* block = reinterpret_cast<FreeBlock*>(chunk + offset);
+      block->Next = head;
+      head = block;
+    }
+  }
+
+  std::mutex m_Mutex;
+  FreeBlock* m_FreeLists[kMaxPooledSize / kGranularity + 1]{};
+  std::vector<std::unique_ptr<char[]>> m_Chunks;
+};
+
+// Intentionally leaked: states owned by static objects may be freed during static
+// destruction, after a function-local static pool would be gone.
+ObjectStatePool& GetObjectStatePool() {
+  static auto* pool = new ObjectStatePool();
+  return *pool;
+}
+
+} // namespace
+
+void* ObjectState::operator new(size_t size) {
+  return GetObjectStatePool().Allocate(size);
+}
+
+void ObjectState::operator delete(void* ptr, size_t size) {
+  GetObjectStatePool().Deallocate(ptr, size);
+}
+
+// ---------------------------------------------------------------------------
+// ObjectStateTable
+// ---------------------------------------------------------------------------
+
+ObjectState* ObjectStateTable::Find(uint64_t key) const {
+  if (key >= kMaxPagedKey) {
+    auto it = m_Overflow.find(key);
+    return it != m_Overflow.end() ? it->second.second.get() : nullptr;
+  }
+  const size_t pageIndex = static_cast<size_t>(key >> kPageBits);
+  if (pageIndex >= m_Pages.size() || !m_Pages[pageIndex]) {
+    return nullptr;
+  }
+  return m_Pages[pageIndex]->Slots[key & (kPageSize - 1)].second.get();
+}
+
+void ObjectStateTable::Insert(std::unique_ptr<ObjectState> state) {
+  const uint64_t key = state->Key;
+  if (key >= kMaxPagedKey) {
+    Entry& entry = m_Overflow[key];
+    if (!entry.second) {
+      ++m_Size;
+    }
+    entry.first = key;
+    entry.second = std::move(state);
+    return;
+  }
+  const size_t pageIndex = static_cast<size_t>(key >> kPageBits);
+  if (pageIndex >= m_Pages.size()) {
+    m_Pages.resize(pageIndex + 1);
+  }
+  std::unique_ptr<Page>& page = m_Pages[pageIndex];
+  if (!page) {
+    page = std::make_unique<Page>();
+  }
+  Entry& entry = page->Slots[key & (kPageSize - 1)];
+  if (!entry.second) {
+    ++page->Live;
+    ++m_Size;
+  }
+  entry.first = key;
+  entry.second = std::move(state);
+}
+
+void ObjectStateTable::Erase(uint64_t key) {
+  if (key >= kMaxPagedKey) {
+    if (m_Overflow.erase(key)) {
+      --m_Size;
+    }
+    return;
+  }
+  const size_t pageIndex = static_cast<size_t>(key >> kPageBits);
+  if (pageIndex >= m_Pages.size() || !m_Pages[pageIndex]) {
+    return;
+  }
+  Page& page = *m_Pages[pageIndex];
+  Entry& entry = page.Slots[key & (kPageSize - 1)];
+  if (!entry.second) {
+    return;
+  }
+  // Release the entry before touching the page: a state destructor must not observe
+  // a half-erased table.
+  std::unique_ptr<ObjectState> removed = std::move(entry.second);
+  --page.Live;
+  --m_Size;
+  if (page.Live == 0) {
+    m_Pages[pageIndex].reset();
+    while (!m_Pages.empty() && !m_Pages.back()) {
+      m_Pages.pop_back();
+    }
+  }
+}
+
+void ObjectStateTable::Clear() {
+  m_Pages.clear();
+  m_Overflow.clear();
+  m_Size = 0;
+}
+
+} // namespace vulkan
+} // namespace gits
@@ -0,0 +1,191 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#pragma once
+
+#include "objectState.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gits {
+namespace vulkan {
+
+// Key-indexed storage for every tracked ObjectState, iterated in key order.
+//
+// Handle keys are issued by a counter, so they are dense and key order is creation
+// order.  A key selects a page and a slot within it directly: lookup is two array
+// accesses instead of a tree walk.  Removing a state leaves a tombstone (an empty
+// slot) that iteration skips; a page is freed once all its slots are tombstones, so
+// ranges of short-lived objects do not keep memory or iteration cost.  Keys too large
+// for the page directory are kept in an ordered overflow map and iterated after the
+// pages, which preserves key order.
+//
+// Entries are std::pair<uint64_t, std::unique_ptr<ObjectState>> so that loops written
+// against a std::map (for (auto& [key, statePtr] : states)) work unchanged.
+// Inserting or removing states while iterating is allowed; the iterator re-reads the
+// table on every step.
+class ObjectStateTable {
+public:
+  using Entry = std::pair<uint64_t, std::unique_ptr<ObjectState>>;
+
+  template <bool Const>
+  class IteratorBase {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Entry;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const Entry*, Entry*>;
+    using reference = std::conditional_t<Const, const Entry&, Entry&>;
+    using TablePtr = std::conditional_t<Const, const ObjectStateTable*, ObjectStateTable*>;
+
+    IteratorBase() = default;
+
+    reference operator*() const {
+      return *Current();
+    }
+    pointer operator->() const {
+      return Current();
+    }
+    IteratorBase& operator++() {
+      Advance();
+      Settle();
+      return *this;
+    }
+    IteratorBase operator++(int) {
+      IteratorBase old = *this;
+      ++*this;
+      return old;
+    }
+    bool operator==(const IteratorBase& other) const {
+      return m_Page == other.m_Page && m_Slot == other.m_Slot && m_Overflow == other.m_Overflow;
+    }
+    bool operator!=(const IteratorBase& other) const {
+      return !(*this == other);
+    }
+
+  private:
+    friend class ObjectStateTable;
+    using OverflowIterator = std::conditional_t<Const,
+                                                std::map<uint64_t, Entry>::const_iterator,
+                                                std::map<uint64_t, Entry>::iterator>;
+
+    // First live entry.
+    explicit IteratorBase(TablePtr table) : m_Table(table) {
+      Settle();
+    }
+    // end().
+    IteratorBase(TablePtr table, OverflowIterator overflowEnd)
+        : m_Table(table), m_Page(kOverflowPage), m_Overflow(overflowEnd) {}
+
+    pointer Current() const {
+      if (m_Page != kOverflowPage) {
+        return &m_Table->m_Pages[m_Page]->Slots[m_Slot];
+      }
+      return &m_Overflow->second;
+    }
+    // The page may have been freed or the directory shortened since the last step;
+    // Settle handles both.
+    void Advance() {
+      if (m_Page != kOverflowPage) {
+        ++m_Slot;
+      } else {
+        ++m_Overflow;
+      }
+    }
+    // Moves forward to the next live entry, or to end().
+    void Settle() {
+      while (m_Page < m_Table->m_Pages.size()) {
+        const auto& page = m_Table->m_Pages[m_Page];
+        if (page) {
+          for (; m_Slot < kPageSize; ++m_Slot) {
+            if (page->Slots[m_Slot].second) {
+              return;
+            }
+          }
+        }
+        ++m_Page;
+        m_Slot = 0;
+      }
+      // Past the pages: the position is the overflow map iterator alone.
+      if (m_Page != kOverflowPage) {
+        m_Page = kOverflowPage;
+        m_Slot = 0;
+        m_Overflow = m_Table->m_Overflow.begin();
+      }
+    }
+
+    TablePtr m_Table{};
+    size_t m_Page{};
+    size_t m_Slot{};
+    OverflowIterator m_Overflow{};
+  };
+
+  using iterator = IteratorBase<false>;
+  using const_iterator = IteratorBase<true>;
+
+  ObjectStateTable() = default;
+  ObjectStateTable(ObjectStateTable&&) = default;
+  ObjectStateTable& operator=(ObjectStateTable&&) = default;
+  ObjectStateTable(const ObjectStateTable&) = delete;
+  ObjectStateTable& operator=(const ObjectStateTable&) = delete;
+
+  // Returns the state stored under key, or nullptr.
+  ObjectState* Find(uint64_t key) const;
+  bool Contains(uint64_t key) const {
+    return Find(key) != nullptr;
+  }
+  // Stores state under state->Key, replacing any previous state with that key.
+  void Insert(std::unique_ptr<ObjectState> state);
+  // Leaves a tombstone; frees the page once it holds no live state.
+  void Erase(uint64_t key);
+  void Clear();
+
+  size_t Size() const {
+    return m_Size;
+  }
+
+  iterator begin() {
+    return iterator(this);
+  }
+  iterator end() {
+    return iterator(this, m_Overflow.end());
+  }
+  const_iterator begin() const {
+    return const_iterator(this);
+  }
+  const_iterator end() const {
+    return const_iterator(this, m_Overflow.end());
+  }
+
+private:
+  static constexpr size_t kPageBits = 10;
+  static constexpr size_t kPageSize = size_t{1} << kPageBits;
+  // Keys at or above this go to m_Overflow, bounding the directory to 2^18 pointers.
+  static constexpr uint64_t kMaxPagedKey = uint64_t{1} << 28;
+  static constexpr size_t kOverflowPage = SIZE_MAX;
+
+  struct Page {
+    std::array<Entry, kPageSize> Slots;
+    size_t Live{};
+  };
+
+  std::vector<std::unique_ptr<Page>> m_Pages;
+  std::map<uint64_t, Entry> m_Overflow;
+  size_t m_Size{};
+};
+
+} // namespace vulkan
+} // namespace gits
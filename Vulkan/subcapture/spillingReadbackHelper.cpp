@@ -0,0 +1,137 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#include "spillingReadbackHelper.h"
+#include "subcaptureFatal.h"
+
+namespace gits {
+namespace vulkan {
+
+SpillingReadbackHelper::SpillingReadbackHelper(IGpuReadbackHelper& live,
+                                               const std::filesystem::path& spillPath)
+    : m_Live(live), m_SpillPath(spillPath) {
+  m_File.open(m_SpillPath, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+  if (!m_File) {
+    FatalSubcaptureError("failed to create the content spill file '" + m_SpillPath.string() +
+                         "'");
+  }
+}
+
+SpillingReadbackHelper::~SpillingReadbackHelper() {
+  m_File.close();
+  std::error_code ec;
+  std::filesystem::remove(m_SpillPath, ec);
+}
+
+void SpillingReadbackHelper::Spill(const SpillKey& key, const uint8_t* data, size_t size) {
+  SpillEntry entry;
+  entry.FileOffset = m_SpilledBytes;
+  entry.Size = size;
+  m_File.seekp(static_cast<std::streamoff>(entry.FileOffset));
+  m_File.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+  if (!m_File) {
+    FatalSubcaptureError("failed to write " + std::to_string(size) +
+                         " bytes to the content spill file '" + m_SpillPath.string() + "'");
+  }
+  m_SpilledBytes += size;
+  m_Entries[key] = entry;
+}
+
+bool SpillingReadbackHelper::Load(const SpillKey& key) {
+  auto it = m_Entries.find(key);
+  if (it == m_Entries.end()) {
+    return false;
+  }
+  m_Scratch.resize(it->second.Size);
+  m_File.seekg(static_cast<std::streamoff>(it->second.FileOffset));
+  m_File.read(reinterpret_cast<char*>(m_Scratch.data()),
+              static_cast<std::streamsize>(it->second.Size));
+  if (!m_File) {
+    FatalSubcaptureError("failed to read back the content spill file '" + m_SpillPath.string() +
+                         "'");
+  }
+  return true;
+}
+
+bool SpillingReadbackHelper::ReadBuffer(uint64_t deviceKey,
+                                        uint64_t physDevKey,
+                                        uint64_t queueKey,
+                                        uint64_t commandPoolKey,
+                                        uint64_t bufferKey,
+                                        VkDeviceSize srcOffset,
+                                        VkDeviceSize size,
+                                        std::vector<uint8_t>& outData) {
+  const SpillKey key{Source::Buffer, bufferKey, srcOffset, size};
+  if (m_Mode == Mode::Replay) {
+    if (!Load(key)) {
+      return false;
+    }
+    outData = m_Scratch;
+    return true;
+  }
+  if (!m_Live.ReadBuffer(deviceKey, physDevKey, queueKey, commandPoolKey, bufferKey, srcOffset,
+                         size, outData)) {
+    return false;
+  }
+  Spill(key, outData.data(), outData.size());
+  return true;
+}
+
+bool SpillingReadbackHelper::ReadResources(uint64_t deviceKey,
+                                           uint64_t physDevKey,
+                                           uint64_t queueKey,
+                                           uint64_t commandPoolKey,
+                                           const std::vector<ReadbackRequest>& requests,
+                                           const ReadbackConsumer& consume) {
+  if (m_Mode == Mode::Replay) {
+    bool ok = true;
+    for (size_t i = 0; i < requests.size(); ++i) {
+      const SpillKey key{Source::Resource, requests[i].ResourceKey, 0, requests[i].Size};
+      // The capture run read a superset of these requests, so a miss is a read that
+      // already failed then.  The caller reports it, as for a live failure.
+      if (Load(key)) {
+        consume(i, m_Scratch.data(), m_Scratch.size());
+      } else {
+        consume(i, nullptr, 0);
+        ok = false;
+      }
+    }
+    return ok;
+  }
+  // A failed read is not spilled, so Replay reports it as failed too.
+  return m_Live.ReadResources(deviceKey, physDevKey, queueKey, commandPoolKey, requests,
+                              [&](size_t i, const uint8_t* data, size_t size) {
+                                if (size != 0) {
+                                  Spill({Source::Resource, requests[i].ResourceKey, 0,
+                                         requests[i].Size},
+                                        data, size);
+                                }
+                                consume(i, data, size);
+                              });
+}
+
+bool SpillingReadbackHelper::VisitHostMemory(uint64_t deviceKey,
+                                             uint64_t physDevKey,
+                                             const ReadbackRequest& request,
+                                             const std::function<void(const uint8_t*)>& visit) {
+  const SpillKey key{Source::HostMemory, request.ResourceKey, 0, request.Size};
+  if (m_Mode == Mode::Replay) {
+    if (!Load(key)) {
+      return false;
+    }
+    visit(m_Scratch.data());
+    return true;
+  }
+  return m_Live.VisitHostMemory(deviceKey, physDevKey, request, [&](const uint8_t* data) {
+    Spill(key, data, static_cast<size_t>(request.Size));
+    visit(data);
+  });
+}
+
+} // namespace vulkan
+} // namespace gits
@@ -0,0 +1,209 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#pragma once
+
+#include "stateTrackingService.h" // for IGpuReadbackHelper
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace gits {
+namespace vulkan {
+
+// IGpuReadbackHelper decorator used by the single-pass subcapture, which emits the
+// state restore only once the range has ended but must restore resource contents as
+// they were when it started.
+//
+// In Capture mode every content read (ReadResources, ReadBuffer, VisitHostMemory) is
+// forwarded to the live helper and its bytes are appended to a spill file on disk.
+// In Replay mode the same reads are answered from that file instead, so the GPU is
+// not touched and later writes by the recorded range are not observed.  Property
+// and requirement queries are always forwarded: they depend on the device, not on
+// the contents.  Acceleration structure readback is not supported by the
+// single-pass flow and is forwarded unchanged.
+class SpillingReadbackHelper final : public IGpuReadbackHelper {
+public:
+  enum class Mode {
+    Capture,
+    Replay
+  };
+
+  SpillingReadbackHelper(IGpuReadbackHelper& live, const std::filesystem::path& spillPath);
+  ~SpillingReadbackHelper();
+  SpillingReadbackHelper(const SpillingReadbackHelper&) = delete;
+  SpillingReadbackHelper& operator=(const SpillingReadbackHelper&) = delete;
+
+  void SetMode(Mode mode) {
+    m_Mode = mode;
+  }
+
+  uint64_t GetSpilledBytes() const {
+    return m_SpilledBytes;
+  }
+
+  bool IsHostVisible(uint64_t physDevKey, uint32_t memoryTypeIndex) override {
+    return m_Live.IsHostVisible(physDevKey, memoryTypeIndex);
+  }
+  uint32_t FindStagingMemoryType(uint64_t physDevKey, uint32_t memoryTypeBits) override {
+    return m_Live.FindStagingMemoryType(physDevKey, memoryTypeBits);
+  }
+  bool GetQueueFamilyProperties(uint64_t physDevKey,
+                                std::vector<VkQueueFamilyProperties>& outProps) override {
+    return m_Live.GetQueueFamilyProperties(physDevKey, outProps);
+  }
+  bool QueryStagingBufferRequirements(uint64_t deviceKey,
+                                      VkDeviceSize size,
+                                      VkBufferUsageFlags usage,
+                                      VkMemoryRequirements& outReq) override {
+    return m_Live.QueryStagingBufferRequirements(deviceKey, size, usage, outReq);
+  }
+  bool QueryBufferRequirements(uint64_t deviceKey,
+                               const VkBufferCreateInfo& createInfo,
+                               VkMemoryRequirements& outReq) override {
+    return m_Live.QueryBufferRequirements(deviceKey, createInfo, outReq);
+  }
+  bool QueryImageRequirements(uint64_t deviceKey,
+                              const VkImageCreateInfo& createInfo,
+                              VkMemoryRequirements& outReq,
+                              bool& outRequiresDedicatedAllocation) override {
+    return m_Live.QueryImageRequirements(deviceKey, createInfo, outReq,
+                                         outRequiresDedicatedAllocation);
+  }
+  uint32_t FindCompatibleMemoryType(uint64_t physDevKey, uint32_t memoryTypeBits) override {
+    return m_Live.FindCompatibleMemoryType(physDevKey, memoryTypeBits);
+  }
+  VkDeviceSize GetImageStagingLayout(VkFormat format,
+                                     const VkExtent3D& extent,
+                                     uint32_t mipLevels,
+                                     uint32_t arrayLayers,
+                                     std::vector<VkBufferImageCopy>& outRegions) override {
+    return m_Live.GetImageStagingLayout(format, extent, mipLevels, arrayLayers, outRegions);
+  }
+  bool StageBufferRegions(uint64_t deviceKey,
+                          uint64_t physDevKey,
+                          uint64_t appCbKey,
+                          uint64_t srcBufferKey,
+                          const std::vector<CapturedBuildInputRegion>& regions,
+                          StagedInputReadback& outStaging) override {
+    return m_Live.StageBufferRegions(deviceKey, physDevKey, appCbKey, srcBufferKey, regions,
+                                     outStaging);
+  }
+  bool ReadStaged(const StagedInputReadback& staging, std::vector<uint8_t>& outData) override {
+    return m_Live.ReadStaged(staging, outData);
+  }
+  void FreeStaged(const StagedInputReadback& staging) override {
+    m_Live.FreeStaged(staging);
+  }
+  bool WaitQueueIdle(uint64_t deviceKey, uint64_t queueKey) override {
+    return m_Mode == Mode::Replay || m_Live.WaitQueueIdle(deviceKey, queueKey);
+  }
+  bool ReadImage(uint64_t deviceKey,
+                 uint64_t physDevKey,
+                 uint64_t queueKey,
+                 uint64_t commandPoolKey,
+                 uint64_t imageKey,
+                 VkFormat format,
+                 const VkExtent3D& extent,
+                 uint32_t mipLevels,
+                 uint32_t arrayLayers,
+                 VkSampleCountFlagBits samples,
+                 VkImageLayout currentLayout,
+                 bool disjoint,
+                 std::vector<uint8_t>& outData,
+                 std::vector<VkBufferImageCopy>& outRegions) override {
+    return m_Live.ReadImage(deviceKey, physDevKey, queueKey, commandPoolKey, imageKey, format,
+                            extent, mipLevels, arrayLayers, samples, currentLayout, disjoint,
+                            outData, outRegions);
+  }
+  bool ReadAccelerationStructureSerialized(uint64_t deviceKey,
+                                           uint64_t physDevKey,
+                                           uint64_t queueKey,
+                                           uint64_t commandPoolKey,
+                                           uint64_t accelerationStructureKey,
+                                           std::vector<uint8_t>& outData,
+                                           VkDeviceAddress& outDeviceAddress,
+                                           uint64_t& outOpaqueCaptureAddress,
+                                           uint64_t& outMemoryOpaqueCaptureAddress) override {
+    return m_Live.ReadAccelerationStructureSerialized(
+        deviceKey, physDevKey, queueKey, commandPoolKey, accelerationStructureKey, outData,
+        outDeviceAddress, outOpaqueCaptureAddress, outMemoryOpaqueCaptureAddress);
+  }
+  bool QueryAccelerationStructureBuildSizes(
+      uint64_t deviceKey,
+      const VkAccelerationStructureBuildGeometryInfoKHR& buildInfo,
+      const uint32_t* pMaxPrimitiveCounts,
+      VkAccelerationStructureBuildSizesInfoKHR& outSizes) override {
+    return m_Live.QueryAccelerationStructureBuildSizes(deviceKey, buildInfo, pMaxPrimitiveCounts,
+                                                       outSizes);
+  }
+  bool ReserveScratchBufferAddress(uint64_t deviceKey,
+                                   uint64_t physDevKey,
+                                   VkDeviceSize size,
+                                   VkDeviceAddress& outDeviceAddress,
+                                   uint64_t& outOpaqueCaptureAddress,
+                                   uint64_t& outMemoryOpaqueCaptureAddress) override {
+    return m_Live.ReserveScratchBufferAddress(deviceKey, physDevKey, size, outDeviceAddress,
+                                              outOpaqueCaptureAddress,
+                                              outMemoryOpaqueCaptureAddress);
+  }
+  void ReleaseReservedAddresses() override {
+    m_Live.ReleaseReservedAddresses();
+  }
+
+  // Spilled content reads.
+  bool ReadBuffer(uint64_t deviceKey,
+                  uint64_t physDevKey,
+                  uint64_t queueKey,
+                  uint64_t commandPoolKey,
+                  uint64_t bufferKey,
+                  VkDeviceSize srcOffset,
+                  VkDeviceSize size,
+                  std::vector<uint8_t>& outData) override;
+  bool ReadResources(uint64_t deviceKey,
+                     uint64_t physDevKey,
+                     uint64_t queueKey,
+                     uint64_t commandPoolKey,
+                     const std::vector<ReadbackRequest>& requests,
+                     const ReadbackConsumer& consume) override;
+  bool VisitHostMemory(uint64_t deviceKey,
+                       uint64_t physDevKey,
+                       const ReadbackRequest& request,
+                       const std::function<void(const uint8_t*)>& visit) override;
+
+private:
+  enum class Source : uint32_t {
+    Resource,
+    Buffer,
+    HostMemory
+  };
+  // (source, resource key, offset, size) -> (file offset, byte count).
+  using SpillKey = std::tuple<Source, uint64_t, uint64_t, uint64_t>;
+  struct SpillEntry {
+    uint64_t FileOffset{};
+    uint64_t Size{};
+  };
+
+  void Spill(const SpillKey& key, const uint8_t* data, size_t size);
+  // Reads a spilled entry into m_Scratch.  False if the read was never captured.
+  bool Load(const SpillKey& key);
+
+  IGpuReadbackHelper& m_Live;
+  std::filesystem::path m_SpillPath;
+  std::fstream m_File;
+  uint64_t m_SpilledBytes{};
+  std::map<SpillKey, SpillEntry> m_Entries;
+  std::vector<uint8_t> m_Scratch;
+  Mode m_Mode{Mode::Capture};
+};
+
+} // namespace vulkan
+} // namespace gits
@@ -26,6 +26,7 @@
 #include <limits>
 #include <memory>
 #include <sstream>
+#include <typeinfo>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -141,9 +142,8 @@ bool StateTrackingService::ShouldRestore(uint64_t key) const {
   // in-range vkQueueSubmit's VkQueue (or a helper's command pool) unmapped,
   // crashing vkQueueSubmitRunner::Run() on HandleMapService::GetHandle. Their
   // owning VkDevice is pulled in automatically by RestoreOne (parent-first).
-  auto it = m_States.find(key);
-  if (it != m_States.end()) {
-    switch (it->second->CreationCommandId) {
+  if (const ObjectState* state = m_States.Find(key)) {
+    switch (state->CreationCommandId) {
     case CommandId::ID_VKGETDEVICEQUEUE:
     case CommandId::ID_VKGETDEVICEQUEUE2:
     case CommandId::ID_VKCREATECOMMANDPOOL:
@@ -162,21 +162,71 @@ bool StateTrackingService::ShouldRestore(uint64_t key) const {
 void StateTrackingService::StoreState(std::unique_ptr<ObjectState> state) {
   uint64_t key = state->Key;
   // Key 0 denotes VK_NULL_HANDLE; no real object ever has key 0.  Inserting such
-  // an entry would place it at m_States.begin() (the map is ordered by key), so
+  // an entry would place it at m_States.begin() (the table is ordered by key), so
   // it would be the FIRST object handed to RestoreOne and emit a bogus creation
   // command with a null handle before any genuine object is restored.
   if (!key) {
     return;
   }
-  m_States[key] = std::move(state);
+  m_States.Insert(std::move(state));
 }
 
 void StateTrackingService::RemoveState(uint64_t key) {
-  m_States.erase(key);
+  m_States.Erase(key);
 }
 
 bool StateTrackingService::HasState(uint64_t key) const {
-  return m_States.count(key) != 0;
+  return m_States.Contains(key);
+}
+
+namespace {
+
+// Copies state as its dynamic type, which must be one of TStates.
+template <typename... TStates>
+std::unique_ptr<ObjectState> CloneStateAs(const ObjectState& state) {
+  std::unique_ptr<ObjectState> clone;
+  ((typeid(state) == typeid(TStates)
+        ? void(clone = std::make_unique<TStates>(static_cast<const TStates&>(state)))
+        : void()),
+   ...);
+  GITS_ASSERT(clone, "Vulkan subcapture: cannot snapshot an object state of unknown type");
+  return clone;
+}
+
+std::unique_ptr<ObjectState> CloneState(const ObjectState& state) {
+  return CloneStateAs<ObjectState, InstanceState, PhysicalDeviceState, DeviceState,
+                      DeviceMemoryState, FenceState, QueueState, SemaphoreState, EventState,
+                      BufferState, ImageState, BufferViewState, ImageViewState, RenderPassState,
+                      FramebufferState, PipelineCacheState, PipelineLayoutState, PipelineState,
+                      ShaderModuleState, DescriptorSetLayoutState, DescriptorPoolState,
+                      DescriptorUpdateTemplateState, DescriptorSetState, SamplerState,
+                      SamplerYcbcrConversionState, CommandPoolState, CommandBufferState,
+                      SurfaceState, SwapchainState, QueryPoolState, AccelerationStructureState,
+                      DeferredOperationState, VideoSessionState, VideoSessionParametersState>(
+      state);
+}
+
+} // namespace
+
+void StateTrackingService::CaptureRestoreSnapshot() {
+  m_SnapshotStates.Clear();
+  for (const auto& [key, statePtr] : m_States) {
+    m_SnapshotStates.Insert(CloneState(*statePtr));
+  }
+  m_SnapshotDescriptorSetUpdateService = m_DescriptorSetUpdateService;
+  m_SnapshotDeviceAddressTracking = m_DeviceAddressTracking;
+}
+
+void StateTrackingService::SwapRestoreSnapshot() {
+  std::swap(m_States, m_SnapshotStates);
+  std::swap(m_DescriptorSetUpdateService, m_SnapshotDescriptorSetUpdateService);
+  std::swap(m_DeviceAddressTracking, m_SnapshotDeviceAddressTracking);
+}
+
+void StateTrackingService::DropRestoreSnapshot() {
+  m_SnapshotStates.Clear();
+  m_SnapshotDescriptorSetUpdateService = {};
+  m_SnapshotDeviceAddressTracking = {};
 }
 
 // True for a Destroyed object whose state is retained *only* so RestoreBlasChain can
@@ -218,7 +268,7 @@ void StateTrackingService::RestoreState() {
   GITS_ASSERT(m_GpuReadbackHelper);
   GITS_ASSERT(m_Recorder.IsOpen());
 
-  LOG_INFO << "Vulkan subcapture: emitting state restore (" << m_States.size() << " objects)";
+  LOG_INFO << "Vulkan subcapture: emitting state restore (" << m_States.Size() << " objects)";
 
   m_RestoredThisPass.clear();
   m_DescriptorSetsAllocated.clear();
@@ -226,6 +276,15 @@ void StateTrackingService::RestoreState() {
   m_TransientlyRestored.clear();
   m_RestoredInputRegionHashes.clear();
   m_NextSyntheticKey = kSyntheticKeyBase;
+  // Content restore is per pass as well: with several subcapture ranges every
+  // range start restores the buffers and images again, into its own stream.
+  for (auto& [_, statePtr] : m_States) {
+    if (auto* buf = dynamic_cast<BufferState*>(statePtr.get())) {
+      buf->ContentRestored = false;
+    } else if (auto* img = dynamic_cast<ImageState*>(statePtr.get())) {
+      img->ContentRestored = false;
+    }
+  }
 
   // Emit StateRestoreBegin marker
   {
@@ -687,7 +746,7 @@ namespace {
 // same queue family index.  Submitting a CB allocated from pool family X to a
 // queue from family Y is invalid; there is no fallback pairing when families
 // cannot be matched.
-static bool FindQueueAndPool(const std::map<uint64_t, std::unique_ptr<ObjectState>>& states,
+static bool FindQueueAndPool(const ObjectStateTable& states,
                              uint64_t deviceKey,
                              uint64_t& outQueueKey,
                              uint64_t& outPoolKey) {
@@ -738,7 +797,7 @@ static bool FindQueueAndPool(const std::map<uint64_t, std::unique_ptr<ObjectStat
 // family the application used (and therefore a query-capable one), unlike the
 // generic FindQueueAndPool above which returns the first family that pairs.
 static bool FindQueueAndPoolForFamily(
-    const std::map<uint64_t, std::unique_ptr<ObjectState>>& states,
+    const ObjectStateTable& states,
     uint64_t deviceKey,
     uint32_t familyIndex,
     uint64_t& outQueueKey,
@@ -802,7 +861,7 @@ static bool MaySubmitImageOperationOnQueueFamily(const ImageState& img, uint32_t
 // graphics-capable family (VUID-vkCmdCopyImageToBuffer-commandBuffer-10216).
 // Content restore manifests name concrete queue/pool keys, so only restored
 // handles are returned.
-static bool FindGraphicsQueueAndPool(const std::map<uint64_t, std::unique_ptr<ObjectState>>& states,
+static bool FindGraphicsQueueAndPool(const ObjectStateTable& states,
                                      uint64_t deviceKey,
                                      const std::vector<VkQueueFamilyProperties>& families,
                                      const std::unordered_set<uint64_t>& restored,
@@ -873,7 +932,7 @@ static bool FindGraphicsQueueAndPool(const std::map<uint64_t, std::unique_ptr<Ob
 // callers apply that requirement themselves for depth/stencil images).
 // std::map, not unordered_map, so callers iterate families in a stable order.
 static std::map<uint32_t, std::pair<uint64_t, uint64_t>> FindAllRestoredQueueAndPools(
-    const std::map<uint64_t, std::unique_ptr<ObjectState>>& states,
+    const ObjectStateTable& states,
     uint64_t deviceKey,
     const std::unordered_set<uint64_t>& restored) {
   std::unordered_map<uint32_t, uint64_t> familyToQueue;
@@ -2956,9 +3015,9 @@ StateTrackingService::CommandBufferRestoreOutcome StateTrackingService::RestoreC
   if (!cb->BeginCommandBuffer.empty()) {
     // Re-emit vkBeginCommandBuffer and every recorded vkCmd*.
     EmitRawCommand(CommandId::ID_VKBEGINCOMMANDBUFFER, cb->BeginCommandBuffer);
-    for (size_t i = 0; i < cb->RecordedCommands.size(); ++i) {
-      EmitRawCommand(cb->RecordedCommandIds[i], cb->RecordedCommands[i]);
-    }
+    cb->RecordedCommands.ForEach([this](CommandId id, const char* data, uint32_t size) {
+      EmitRawCommand(id, data, size);
+    });
     // If the CB was in executable state (ended but not reset), close it again
     // so the second player has it in the same executable state.
     if (cb->IsExecutable && !cb->EndCommandBuffer.empty()) {
@@ -3073,7 +3132,8 @@ void StateTrackingService::RestoreMappedMemory(ObjectState* state) {
 // device memory and batches the uploads, flushing and tearing down once it has
 // consumed manifest-many data tokens.  Nothing staging-related is written into
 // the stream, and the recorder streams the readback bytes one resource at a
-// time so peak host memory stays bounded to a single resource.
+// time straight out of GpuReadbackHelper::ReadResources' staging ring, so peak
+// host memory stays bounded to that ring.
 // ---------------------------------------------------------------------------
 
 // Fixed (never-growing) synthetic GITSKeys for temporary staging resources created in
@@ -3148,18 +3208,19 @@ static VkBufferCreateInfo MakeCaptureReplayBufferCreateInfo(
 namespace {
 
 // Returns true when the CPU shadow of `mem` fully covers `buf`'s entire bound
-// range and its bytes match the live GPU readback `data` exactly.  See the
-// coverage + equality rules documented above; callers MUST fall back to a GPU
-// copy whenever this returns false (conservative, always-correct default).
+// range and its bytes match the live content `data` (`size` bytes) exactly.  See
+// the coverage + equality rules documented above; callers MUST fall back to a
+// GPU copy whenever this returns false (conservative, always-correct default).
 bool ShadowFullyCoversAndMatches(const BufferState& buf,
                                  const DeviceMemoryState& mem,
-                                 const std::vector<uint8_t>& data) {
+                                 const uint8_t* data,
+                                 size_t size) {
   // A shadow must exist to rely on the mapped-memory restore.
   if (mem.ShadowBuffer.empty()) {
     return false;
   }
   // The readback must have produced exactly the buffer's bytes.
-  if (data.size() != static_cast<size_t>(buf.BufferSize)) {
+  if (data == nullptr || size != static_cast<size_t>(buf.BufferSize)) {
     return false;
   }
   const VkDeviceSize begin = buf.MemoryOffset;
@@ -3174,10 +3235,27 @@ bool ShadowFullyCoversAndMatches(const BufferState& buf,
     return false;
   }
   // (2) EQUALITY: shadow bytes for the range match the live readback.
-  return std::memcmp(data.data(), mem.ShadowBuffer.data() + static_cast<size_t>(begin),
+  return std::memcmp(data, mem.ShadowBuffer.data() + static_cast<size_t>(begin),
                      static_cast<size_t>(buf.BufferSize)) == 0;
 }
 
+// Describes a whole-buffer readback.  The bound memory is passed along so that
+// the helper can read a HOST_COHERENT buffer through a mapping, with no GPU copy.
+ReadbackRequest MakeBufferReadbackRequest(uint64_t bufKey,
+                                          const BufferState& buf,
+                                          const DeviceMemoryState* mem) {
+  ReadbackRequest request;
+  request.ResourceKey = bufKey;
+  request.Size = buf.BufferSize;
+  if (mem != nullptr) {
+    request.MemoryKey = buf.BoundMemoryKey;
+    request.MemoryTypeIndex = mem->MemoryTypeIndex;
+    request.MemoryOffset = buf.MemoryOffset;
+    request.MappingOffset = mem->IsMapped ? mem->MappingOffset : 0;
+  }
+  return request;
+}
+
 } // namespace
 
 static void EmitStagingUploadAndCopyBuffer(SubcaptureRecorder& recorder,
@@ -5053,6 +5131,66 @@ void StateTrackingService::RestoreAccelerationStructureContents() {
   }
 }
 
+// True when `size` bytes are one 32-bit word repeated, returned in `word`.
+static bool IsConstantFill(const uint8_t* data, size_t size, uint32_t& word) {
+  if (size < sizeof(word) || size % sizeof(word) != 0) {
+    return false;
+  }
+  std::memcpy(&word, data, sizeof(word));
+  return std::memcmp(data, data + sizeof(word), size - sizeof(word)) == 0;
+}
+
+void StateTrackingService::EmitRestoreContentData(uint64_t deviceKey,
+                                                  size_t index,
+                                                  const uint8_t* data,
+                                                  size_t size,
+                                                  RestoreContentCacheIndex& cache) {
+  static char sEmptyByte = 0;
+  using Payload = RestoreContentCachedDataCommand::Payload;
+
+  MemoryRegions::Region region;
+  region.Offset = static_cast<uint64_t>(index); // resource index, not a byte offset
+  region.Size = 0;
+  region.Data = &sEmptyByte;
+
+  RestoreContentCachedDataCommand cachedCmd;
+  bool useCachedCmd = true;
+  uint32_t word = 0;
+  if (size == 0) {
+    // Readback failed: an empty raw region still keeps the token count intact.
+    useCachedCmd = false;
+  } else if (IsConstantFill(data, size, word)) {
+    cachedCmd.m_Payload = static_cast<uint32_t>(Payload::Fill);
+    cachedCmd.m_Value = word;
+  } else {
+    const uint64_t hash = ComputeHash(data, size, THashType::XXCRC32);
+    if (cache.Contains(hash, size)) {
+      cachedCmd.m_Payload = static_cast<uint32_t>(Payload::Reference);
+      cachedCmd.m_Value = hash;
+    } else {
+      useCachedCmd = cache.Insert(hash, size, [](uint64_t) {});
+      cachedCmd.m_Cached = useCachedCmd ? 1 : 0;
+      cachedCmd.m_Value = hash;
+      region.Size = static_cast<uint64_t>(size);
+      region.Data = reinterpret_cast<char*>(const_cast<uint8_t*>(data));
+    }
+  }
+
+  // Payloads that take no part in caching keep the original token.
+  if (!useCachedCmd) {
+    RestoreContentDataCommand dataCmd;
+    dataCmd.m_DeviceKey = deviceKey;
+    dataCmd.m_Regions.Regions.push_back(region);
+    dataCmd.m_Regions.Size = 1;
+    m_Recorder.Record(RestoreContentDataSerializer(dataCmd));
+    return;
+  }
+  cachedCmd.m_DeviceKey = deviceKey;
+  cachedCmd.m_Regions.Regions.push_back(region);
+  cachedCmd.m_Regions.Size = 1;
+  m_Recorder.Record(RestoreContentCachedDataSerializer(cachedCmd));
+}
+
 void StateTrackingService::RestoreBufferContents() {
   // Group buffers by device.
   std::unordered_map<uint64_t, std::vector<uint64_t>> buffersByDevice;
@@ -5152,7 +5290,11 @@ void StateTrackingService::RestoreBufferContents() {
     manifest.m_QueueKey = queueKey;
     manifest.m_CommandPoolKey = poolKey;
 
+    // The probes below read host memory directly, so let the GPU finish first.
+    m_GpuReadbackHelper->WaitQueueIdle(deviceKey, queueKey);
+
     std::vector<uint64_t> orderedKeys;
+    std::vector<ReadbackRequest> requests;
     for (uint64_t bufKey : bufKeys) {
       auto* buf = static_cast<BufferState*>(GetState(bufKey));
       if (!buf) {
@@ -5161,17 +5303,26 @@ void StateTrackingService::RestoreBufferContents() {
 
       // Only host-visible buffers are skip-eligible; probe their live content
       // now and exclude them when the CPU shadow already covers and matches it.
-      // The probe bytes are discarded; the data pass below re-reads the live
-      // bytes of the buffers that survive (recorder-side readback cost is
-      // acceptable and peak host memory stays bounded to one resource).
+      // A coherent buffer is compared in place through a mapping; only a
+      // non-coherent one needs a GPU copy of the probe bytes, which are then
+      // discarded (peak host memory stays bounded to one resource).
       auto* mem = GetState<DeviceMemoryState>(buf->BoundMemoryKey);
+      const ReadbackRequest request = MakeBufferReadbackRequest(bufKey, *buf, mem);
       const bool hostVisible =
           mem != nullptr && m_GpuReadbackHelper->IsHostVisible(physDevKey, mem->MemoryTypeIndex);
       if (hostVisible) {
-        std::vector<uint8_t> probe;
-        if (m_GpuReadbackHelper->ReadBuffer(deviceKey, physDevKey, queueKey, poolKey, bufKey,
-                                            /*srcOffset=*/0, buf->BufferSize, probe) &&
-            ShadowFullyCoversAndMatches(*buf, *mem, probe)) {
+        bool matches = false;
+        if (!m_GpuReadbackHelper->VisitHostMemory(
+                deviceKey, physDevKey, request, [&](const uint8_t* data) {
+                  matches = ShadowFullyCoversAndMatches(*buf, *mem, data, buf->BufferSize);
+                })) {
+          std::vector<uint8_t> probe;
+          matches = m_GpuReadbackHelper->ReadBuffer(deviceKey, physDevKey, queueKey, poolKey,
+                                                    bufKey, /*srcOffset=*/0, buf->BufferSize,
+                                                    probe) &&
+                    ShadowFullyCoversAndMatches(*buf, *mem, probe.data(), probe.size());
+        }
+        if (matches) {
           LOG_TRACE << "Vulkan subcapture: buffer key=" << bufKey
                     << " matches CPU shadow - excluded from content manifest "
                        "(mapped-memory restore covers it)";
@@ -5185,45 +5336,35 @@ void StateTrackingService::RestoreBufferContents() {
       manifest.m_Buffers.push_back(entry);
       manifest.m_TotalBytes += buf->BufferSize;
       orderedKeys.push_back(bufKey);
+      requests.push_back(request);
     }
     if (manifest.m_Buffers.empty()) {
       continue;
     }
     m_Recorder.Record(RestoreContentManifestSerializer(manifest));
 
-    // Stream each surviving buffer's bytes one at a time so peak host RAM stays
-    // bounded.  The manifest and the data tokens are 1:1 (compare-and-skip
-    // already excluded the redundant buffers above), so emit exactly one token
-    // per manifest entry.  A zero-length region is emitted only if a phase-2
-    // readback unexpectedly fails after the phase-1 probe succeeded: the token
-    // is still emitted so the player's token count matches the manifest and the
-    // stream terminates cleanly without a separate end token.
-    static char sEmptyByte = 0;
-    for (size_t i = 0; i < orderedKeys.size(); ++i) {
-      const uint64_t bufKey = orderedKeys[i];
-      std::vector<uint8_t> data;
-      auto* buf = static_cast<BufferState*>(GetState(bufKey));
-      if (buf) {
-        if (!m_GpuReadbackHelper->ReadBuffer(deviceKey, physDevKey, queueKey, poolKey, bufKey,
-                                             /*srcOffset=*/0, buf->BufferSize, data)) {
-          LOG_WARNING << "Vulkan subcapture: GPU readback failed for buffer key=" << bufKey;
-          data.clear();
-        }
-      }
-
-      RestoreContentDataCommand dataCmd;
-      dataCmd.m_DeviceKey = deviceKey;
-      MemoryRegions::Region region;
-      region.Offset = static_cast<uint64_t>(i); // resource index, not a byte offset
-      region.Size = static_cast<uint64_t>(data.size());
-      region.Data = data.empty() ? &sEmptyByte : reinterpret_cast<char*>(data.data());
-      dataCmd.m_Regions.Regions.push_back(region);
-      dataCmd.m_Regions.Size = 1;
-      m_Recorder.Record(RestoreContentDataSerializer(dataCmd));
+    // Stream the surviving buffers' bytes as the batched readback delivers
+    // them, so peak host RAM stays bounded to the readback's staging ring.  The
+    // manifest and the data tokens are 1:1 (compare-and-skip already excluded
+    // the redundant buffers above), and ReadResources reports every request in
+    // order, so emit exactly one token per manifest entry.  A zero-length
+    // region is emitted only if a readback unexpectedly fails: the token is
+    // still emitted so the player's token count matches the manifest and the
+    // stream terminates cleanly without a separate end token.  Constant and
+    // repeated payloads shrink to fills and references (EmitRestoreContentData).
+    RestoreContentCacheIndex contentCache;
+    m_GpuReadbackHelper->ReadResources(
+        deviceKey, physDevKey, queueKey, poolKey, requests,
+        [&](size_t i, const uint8_t* data, size_t size) {
+          const uint64_t bufKey = orderedKeys[i];
+          if (size == 0) {
+            LOG_WARNING << "Vulkan subcapture: GPU readback failed for buffer key=" << bufKey;
+          }
+          EmitRestoreContentData(deviceKey, i, data, size, contentCache);
 
-      LOG_TRACE << "Vulkan subcapture: streamed buffer content, key=" << bufKey
-                << " size=" << data.size();
-    }
+          LOG_TRACE << "Vulkan subcapture: streamed buffer content, key=" << bufKey
+                    << " size=" << size;
+        });
   }
 }
 
@@ -5447,7 +5588,6 @@ void StateTrackingService::RestoreImageContents() {
     // token.  Because the manifest and the readback below always use the
     // same pair, the player's upload copy runs on a family known to support
     // it.
-    static char sEmptyByte = 0;
     auto emitGroup = [&](const std::vector<uint64_t>& keys, uint64_t targetQueueKey,
                          uint64_t targetPoolKey) {
       if (keys.empty()) {
@@ -5484,38 +5624,39 @@ void StateTrackingService::RestoreImageContents() {
       }
       m_Recorder.Record(RestoreContentManifestSerializer(manifest));
 
-      for (size_t i = 0; i < orderedKeys.size(); ++i) {
-        const uint64_t imgKey = orderedKeys[i];
-        std::vector<uint8_t> data;
-        std::vector<VkBufferImageCopy> regions;
+      std::vector<ReadbackRequest> requests;
+      requests.reserve(orderedKeys.size());
+      for (uint64_t imgKey : orderedKeys) {
         auto* img = static_cast<ImageState*>(GetState(imgKey));
-        if (img) {
-          if (!m_GpuReadbackHelper->ReadImage(deviceKey, physDevKey, targetQueueKey, targetPoolKey,
-                                              imgKey, img->Format, img->Extent, img->MipLevels,
-                                              img->ArrayLayers, img->Samples, img->CurrentLayout,
-                                              img->Disjoint, data, regions)) {
-            LOG_WARNING << "Vulkan subcapture: GPU readback failed for image key=" << imgKey;
-            data.clear();
-          } else {
-            // The player's upload leaves the image in its tracked layout, so
-            // EmitImageLayoutTransitions must skip it.
-            img->ContentRestored = true;
-          }
-        }
-
-        RestoreContentDataCommand dataCmd;
-        dataCmd.m_DeviceKey = deviceKey;
-        MemoryRegions::Region region;
-        region.Offset = static_cast<uint64_t>(i); // resource index, not a byte offset
-        region.Size = static_cast<uint64_t>(data.size());
-        region.Data = data.empty() ? &sEmptyByte : reinterpret_cast<char*>(data.data());
-        dataCmd.m_Regions.Regions.push_back(region);
-        dataCmd.m_Regions.Size = 1;
-        m_Recorder.Record(RestoreContentDataSerializer(dataCmd));
-
-        LOG_TRACE << "Vulkan subcapture: streamed image content, key=" << imgKey
-                  << " size=" << data.size();
+        ReadbackRequest request;
+        request.ResourceKey = imgKey;
+        request.IsImage = true;
+        request.Format = img->Format;
+        request.Extent = img->Extent;
+        request.MipLevels = img->MipLevels;
+        request.ArrayLayers = img->ArrayLayers;
+        request.CurrentLayout = img->CurrentLayout;
+        request.Disjoint = img->Disjoint;
+        requests.push_back(request);
       }
+
+      RestoreContentCacheIndex contentCache;
+      m_GpuReadbackHelper->ReadResources(
+          deviceKey, physDevKey, targetQueueKey, targetPoolKey, requests,
+          [&](size_t i, const uint8_t* data, size_t size) {
+            const uint64_t imgKey = orderedKeys[i];
+            if (size == 0) {
+              LOG_WARNING << "Vulkan subcapture: GPU readback failed for image key=" << imgKey;
+            } else if (auto* img = static_cast<ImageState*>(GetState(imgKey))) {
+              // The player's upload leaves the image in its tracked layout, so
+              // EmitImageLayoutTransitions must skip it.
+              img->ContentRestored = true;
+            }
+            EmitRestoreContentData(deviceKey, i, data, size, contentCache);
+
+            LOG_TRACE << "Vulkan subcapture: streamed image content, key=" << imgKey
+                      << " size=" << size;
+          });
     };
 
     for (const auto& [family, keys] : groupsByFamily) {
@@ -5542,17 +5683,21 @@ void StateTrackingService::RestoreImageContents() {
 // ---------------------------------------------------------------------------
 
 void StateTrackingService::EmitRawCommand(CommandId id, const std::vector<char>& encoded) {
-  if (encoded.empty()) {
+  EmitRawCommand(id, encoded.data(), encoded.size());
+}
+
+void StateTrackingService::EmitRawCommand(CommandId id, const char* encoded, size_t size) {
+  if (size == 0) {
     return;
   }
   class RawSerializer : public stream::CommandSerializer {
   public:
-    RawSerializer(CommandId cmdId, const std::vector<char>& data) : m_CmdId(cmdId) {
+    RawSerializer(CommandId cmdId, const char* data, size_t size) : m_CmdId(cmdId) {
       // Base class m_DataSize is uint64_t; preserve full size to avoid
       // silently truncating very large encoded blobs.
-      m_DataSize = static_cast<uint64_t>(data.size());
-      m_Data.reset(new char[data.size()]);
-      std::memcpy(m_Data.get(), data.data(), data.size());
+      m_DataSize = static_cast<uint64_t>(size);
+      m_Data.reset(new char[size]);
+      std::memcpy(m_Data.get(), data, size);
     }
     uint32_t Id() const override {
       return static_cast<uint32_t>(m_CmdId);
@@ -5561,7 +5706,7 @@ void StateTrackingService::EmitRawCommand(CommandId id, const std::vector<char>&
   private:
     CommandId m_CmdId;
   };
-  m_Recorder.Record(RawSerializer(id, encoded));
+  m_Recorder.Record(RawSerializer(id, encoded, size));
 }
 
 } // namespace vulkan
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "objectState.h"
+#include "objectStateTable.h"
 #include "subcaptureRecorder.h"
 #include "descriptorSetUpdateService.h"
 #include "queryPoolStateService.h"
@@ -26,6 +27,34 @@ namespace gits {
 namespace vulkan {
 
 class AnalyzerResults;
+class RestoreContentCacheIndex;
+
+// One resource for IGpuReadbackHelper::ReadResources.  A buffer is read from offset 0
+// for Size bytes; an image is read with the layout GetImageStagingLayout reports.
+struct ReadbackRequest {
+  uint64_t ResourceKey{};
+  bool IsImage{};
+  VkDeviceSize Size{};
+  // Buffers only: the bound memory, its type and the buffer's offset within it.  When
+  // the type is HOST_VISIBLE | HOST_COHERENT the bytes are read straight from a host
+  // mapping instead of through a GPU copy.  MappingOffset is where the replayed
+  // application's own mapping of that memory starts, if it currently holds one.
+  uint64_t MemoryKey{};
+  uint32_t MemoryTypeIndex{UINT32_MAX};
+  VkDeviceSize MemoryOffset{};
+  VkDeviceSize MappingOffset{};
+  // Images only.
+  VkFormat Format{VK_FORMAT_UNDEFINED};
+  VkExtent3D Extent{};
+  uint32_t MipLevels{};
+  uint32_t ArrayLayers{};
+  VkImageLayout CurrentLayout{VK_IMAGE_LAYOUT_UNDEFINED};
+  bool Disjoint{};
+};
+
+// Receives the bytes of request 'index'.  size is 0 when the resource could not be
+// read back; data is only valid for the duration of the call.
+using ReadbackConsumer = std::function<void(size_t index, const uint8_t* data, size_t size)>;
 
 // ---------------------------------------------------------------------------
 // IGpuReadbackHelper: interface injected from the player module.
@@ -166,6 +195,27 @@ public:
                          std::vector<uint8_t>& outData,
                          std::vector<VkBufferImageCopy>& outRegions) = 0;
 
+  // Reads back every request and hands the bytes to consume in request order.  GPU
+  // copies are packed into one command buffer per batch, each batch landing in a slot
+  // of a small staging ring and fenced on its own, so consume runs for one batch while
+  // the GPU copies the next.  HOST_COHERENT buffers are read straight from a mapping
+  // instead.  Returns false if any request failed (consume still saw it, with size 0).
+  virtual bool ReadResources(uint64_t deviceKey,
+                             uint64_t physDevKey,
+                             uint64_t queueKey,
+                             uint64_t commandPoolKey,
+                             const std::vector<ReadbackRequest>& requests,
+                             const ReadbackConsumer& consume) = 0;
+
+  // Calls visit with a pointer to the live bytes of a HOST_COHERENT buffer request,
+  // without copying them.  Returns false, without calling visit, when the memory is not
+  // coherent or cannot be mapped; the caller then falls back to ReadBuffer.  The caller
+  // must make sure the GPU has finished writing that memory (see WaitQueueIdle).
+  virtual bool VisitHostMemory(uint64_t deviceKey,
+                               uint64_t physDevKey,
+                               const ReadbackRequest& request,
+                               const std::function<void(const uint8_t*)>& visit) = 0;
+
   // Reads the serialized bytes of a VkAccelerationStructureKHR into outData, via a
   // throwaway capture/replay buffer. outDeviceAddress is that buffer's device address.
   // outOpaqueCaptureAddress / outMemoryOpaqueCaptureAddress are its buffer- and
@@ -228,20 +278,12 @@ public:
   // Retrieve a typed state pointer; returns nullptr if not found or wrong type.
   template <typename T>
   T* GetState(uint64_t key) {
-    auto it = m_States.find(key);
-    if (it == m_States.end()) {
-      return nullptr;
-    }
-    return dynamic_cast<T*>(it->second.get());
+    return dynamic_cast<T*>(m_States.Find(key));
   }
 
   // Returns the base state pointer; returns nullptr if not found.
   ObjectState* GetState(uint64_t key) {
-    auto it = m_States.find(key);
-    if (it == m_States.end()) {
-      return nullptr;
-    }
-    return it->second.get();
+    return m_States.Find(key);
   }
 
   // Returns true if key is currently tracked (not yet Destroyed).
@@ -270,9 +312,9 @@ public:
   void EnsureRestored(uint64_t key);
 
   // Returns all states in key order (== creation order, since keys are
-  // sequential integers).  Prefer iterating this map over a separate ordered
-  // container; the map is the single source of truth.
-  const std::map<uint64_t, std::unique_ptr<ObjectState>>& GetStates() const {
+  // sequential integers).  Prefer iterating this table over a separate ordered
+  // container; the table is the single source of truth.
+  const ObjectStateTable& GetStates() const {
     return m_States;
   }
 
@@ -311,6 +353,15 @@ public:
     m_AnalyzerResults = results;
   }
 
+  // Single-pass subcapture: copy everything RestoreState reads (object states,
+  // descriptor contents, device addresses) at the range start, so the restore can be
+  // emitted once the range has ended from the state it would have seen at its start.
+  // SwapRestoreSnapshot exchanges the copy with the live tables; call it once before
+  // and once after that RestoreState.
+  void CaptureRestoreSnapshot();
+  void SwapRestoreSnapshot();
+  void DropRestoreSnapshot();
+
   // Find a live queue key and command pool key of deviceKey that share the same queue
   // family index, for one-shot GPU readback. False if no such pair exists.
   bool FindQueueAndPool(uint64_t deviceKey, uint64_t& outQueueKey, uint64_t& outPoolKey) const;
@@ -393,6 +444,14 @@ private:
   void RestoreMappedMemory(ObjectState* state);
   void RestoreBufferContents();
   void RestoreImageContents();
+  // Emit the data token for manifest entry `index`: a RestoreContentCachedData fill,
+  // reference to an identical payload still held in `cache`, or cached raw payload
+  // when the bytes allow it, else a plain RestoreContentData token.
+  void EmitRestoreContentData(uint64_t deviceKey,
+                              size_t index,
+                              const uint8_t* data,
+                              size_t size,
+                              RestoreContentCacheIndex& cache);
   void RestoreAccelerationStructureContents();
 
   void EmitAccelerationStructureDeserialize(uint64_t deviceKey,
@@ -528,6 +587,7 @@ private:
   // Emit a pre-encoded command directly from a raw byte buffer (used for
   // replaying in-flight command buffer commands during state restore).
   void EmitRawCommand(CommandId id, const std::vector<char>& encoded);
+  void EmitRawCommand(CommandId id, const char* encoded, size_t size);
 
   SubcaptureRecorder& m_Recorder;
   IGpuReadbackHelper* m_GpuReadbackHelper{nullptr};
@@ -536,10 +596,9 @@ private:
   QueryPoolStateService m_QueryPoolState{*this};
   DeviceAddressTrackingService m_DeviceAddressTracking;
   // Single ordered container: key (sequential integer) -> owned state.
-  // std::map keeps entries sorted by key, which equals creation order because
-  // Vulkan keys are sequential integers assigned by the coder, exactly the
-  // same as the DX subcapture which also uses std::map for this reason.
-  std::map<uint64_t, std::unique_ptr<ObjectState>> m_States;
+  // Iterated in key order, which equals creation order because Vulkan keys are
+  // sequential integers assigned by the coder (see ObjectStateTable).
+  ObjectStateTable m_States;
   // Keys for which RestoreOne has fully completed (object created + handle
   // registered).  Inserted only after successful creation so dependents can
   // rely on the presence of a key here as proof the object actually exists.
@@ -591,6 +650,10 @@ private:
   std::map<std::pair<uint64_t, uint64_t>, uint64_t> m_RestoredInputRegionHashes;
   // See SetSubmittedCommandBufferCallback.
   std::function<void(uint64_t, uint64_t)> m_OnCommandBufferSubmitted;
+  // See CaptureRestoreSnapshot.
+  ObjectStateTable m_SnapshotStates;
+  DescriptorSetUpdateService m_SnapshotDescriptorSetUpdateService;
+  DeviceAddressTrackingService m_SnapshotDeviceAddressTracking;
 };
 
 } // namespace vulkan
@@ -23,11 +23,12 @@ namespace vulkan {
 
 SubcaptureLayer::SubcaptureLayer(PlayerManager& playerManager,
                                  const std::string& framesStr,
-                                 bool analysisMode)
+                                 SubcapturePass pass)
     : Layer("Subcapture"),
-      m_AnalysisMode(analysisMode),
+      m_AnalysisMode(pass == SubcapturePass::Analysis),
+      m_SinglePass(pass == SubcapturePass::SinglePass),
       m_SubcaptureRange(framesStr),
-      m_Recorder(!analysisMode),
+      m_Recorder(m_SubcaptureRange, !m_AnalysisMode),
       m_GpuReadbackHelper(playerManager),
       m_StateTracking(m_Recorder),
       m_SyncState(m_StateTracking),
@@ -35,23 +36,34 @@ SubcaptureLayer::SubcaptureLayer(PlayerManager& playerManager,
       m_CommandBufferLifecycle(m_StateTracking),
       m_MappedMemory(m_StateTracking) {
   m_StateTracking.SetGpuReadbackHelper(&m_GpuReadbackHelper);
-  if (m_AnalysisMode) {
-    // Analysis pass: collect in-range object usage; never restore.
+  if (m_SinglePass && m_SubcaptureRange.IsMultiRange()) {
+    FatalSubcaptureError("Common.Player.Subcapture.Vulkan.SinglePass supports a single frame "
+                         "range only; run the two-pass flow for several ranges");
+  }
+  if (m_AnalysisMode || m_SinglePass) {
+    // Analysis pass: collect in-range object usage; never restore.  The single-pass
+    // flow collects the same usage, but only for objects that exist before the range,
+    // so it has no pre-range BLAS chain to reduce.
     m_AnalyzerService = std::make_unique<AnalyzerService>(m_StateTracking, m_SubcaptureRange);
     m_AnalyzerRaytracingService =
         std::make_unique<AnalyzerRaytracingService>(m_StateTracking, m_GpuReadbackHelper);
-    m_RaytracingOptimizationService = std::make_unique<RaytracingOptimizationService>();
     m_AnalyzerService->SetRaytracingService(m_AnalyzerRaytracingService.get());
-    m_AnalyzerService->SetOptimizationService(m_RaytracingOptimizationService.get());
+    if (m_AnalysisMode) {
+      m_RaytracingOptimizationService = std::make_unique<RaytracingOptimizationService>();
+      m_AnalyzerService->SetOptimizationService(m_RaytracingOptimizationService.get());
+    }
     // Drive the analyzer's TLAS instance readback and flush the chain-reduction graph at
     // submit time, once the staged builds/copies have executed. Flushing at submit gives
     // the chain graph true GPU execution order across command buffers.
     m_StateTracking.SetSubmittedCommandBufferCallback(
         [this](uint64_t cbKey, uint64_t submitQueueKey) {
           m_AnalyzerRaytracingService->ReadStagedTlasInstances(cbKey, submitQueueKey);
-          m_RaytracingOptimizationService->OnQueueSubmit(cbKey);
+          if (m_RaytracingOptimizationService) {
+            m_RaytracingOptimizationService->OnQueueSubmit(cbKey);
+          }
         });
-  } else {
+  }
+  if (!m_AnalysisMode && !m_SinglePass) {
     // Recording pass: gate restore by the analysis results (a no-op that
     // restores everything when optimization is off or the analysis set is
     // empty / absent).
@@ -59,12 +71,77 @@ SubcaptureLayer::SubcaptureLayer(PlayerManager& playerManager,
   }
 }
 
+SubcaptureLayer::~SubcaptureLayer() {
+  // The stream ended inside the range: keep what was recorded, behind an unpruned
+  // restore, since the analysis never completed.  Destructors must not throw.
+  if (!m_Recorder.IsSpilling()) {
+    return;
+  }
+  try {
+    LOG_WARNING << "Vulkan subcapture: stream ended inside the single-pass range; the "
+                   "state restore is not optimized";
+    m_Recorder.EndSpill();
+    m_StateTracking.SwapRestoreSnapshot();
+    if (m_ContentSpill) {
+      m_ContentSpill->SetMode(SpillingReadbackHelper::Mode::Replay);
+    }
+    TriggerRestoreState();
+    m_StateTracking.SwapRestoreSnapshot();
+    m_StateTracking.DropRestoreSnapshot();
+    m_StateTracking.SetGpuReadbackHelper(&m_GpuReadbackHelper);
+    m_ContentSpill.reset();
+    m_Recorder.AppendSpill();
+    m_Recorder.FinishRecording();
+  } catch (...) {
+  }
+}
+
 // ---- Frame boundary ------------------------------------------------------
 
 void SubcaptureLayer::TriggerRestoreState() {
   m_StateTracking.RestoreState();
 }
 
+void SubcaptureLayer::BeginSinglePassRange() {
+  for (const auto& [key, statePtr] : m_StateTracking.GetStates()) {
+    if (dynamic_cast<const AccelerationStructureState*>(statePtr.get())) {
+      FatalSubcaptureError("the stream creates acceleration structures before the subcapture "
+                           "range, which Common.Player.Subcapture.Vulkan.SinglePass cannot "
+                           "restore; disable it to run the two-pass flow");
+    }
+  }
+
+  m_StateTracking.CaptureRestoreSnapshot();
+  m_ContentSpill = std::make_unique<SpillingReadbackHelper>(
+      m_GpuReadbackHelper, m_Recorder.GetSpillPath("_contents.spill"));
+  m_StateTracking.SetGpuReadbackHelper(m_ContentSpill.get());
+  // No analysis results are set yet, so this restores (and reads) every object.
+  m_Recorder.SetDiscard(true);
+  TriggerRestoreState();
+  m_Recorder.SetDiscard(false);
+  LOG_INFO << "Vulkan subcapture: spilled " << m_ContentSpill->GetSpilledBytes()
+           << " bytes of resource contents at the single-pass range start";
+  m_Recorder.BeginSpill();
+}
+
+void SubcaptureLayer::FinishSinglePassRange() {
+  m_Recorder.EndSpill();
+  // The analysis covers objects alive at the range end, as in the analysis pass.
+  m_AnalyzerService->DumpAnalysisFile();
+  m_AnalyzerResults.Load();
+  m_StateTracking.SetAnalyzerResults(&m_AnalyzerResults);
+
+  m_StateTracking.SwapRestoreSnapshot();
+  m_ContentSpill->SetMode(SpillingReadbackHelper::Mode::Replay);
+  TriggerRestoreState();
+  m_StateTracking.SwapRestoreSnapshot();
+  m_StateTracking.DropRestoreSnapshot();
+  m_StateTracking.SetGpuReadbackHelper(&m_GpuReadbackHelper);
+  m_ContentSpill.reset();
+
+  m_Recorder.AppendSpill();
+}
+
 void SubcaptureLayer::Post(vkQueuePresentKHRCommand& command) {
   // vkQueuePresentKHR consumes (unsignals) all binary semaphores listed in
   // pWaitSemaphores.  Clear IsSignaled so we don't incorrectly signal them
@@ -122,19 +199,41 @@ void SubcaptureLayer::Post(vkQueuePresentKHRCommand& command) {
   }
 
   // Analysis pass: advance the frame counter and dump the analysis file when
-  // the range ends.  No restore and no recording happen here.
+  // the last range ends.  With several ranges the analysis covers their union,
+  // which the recording pass then restores at every range start.  No restore
+  // and no recording happen here.
   if (m_AnalysisMode) {
     const bool wasInRange = m_SubcaptureRange.InRange();
+    const bool wasLastRange = !m_SubcaptureRange.HasLaterRange();
     m_SubcaptureRange.FrameEnd();
     const bool nowInRange = m_SubcaptureRange.InRange();
-    if (wasInRange && !nowInRange && m_AnalyzerService) {
+    if (wasInRange && !nowInRange && wasLastRange && m_AnalyzerService) {
       m_AnalyzerService->DumpAnalysisFile();
     }
     return;
   }
 
-  // Fire state restore exactly once, before the first recorded frame.
+  // Single-pass: the restore is written only once the range has ended, in front of the
+  // spilled range.  The final in-range present is still recorded by RecordingLayer.
+  if (m_SinglePass) {
+    const bool wasInRange = m_SubcaptureRange.InRange();
+    if (m_SubcaptureRange.IsRestorePoint()) {
+      m_Recorder.OpenStream();
+      BeginSinglePassRange();
+    }
+    m_SubcaptureRange.FrameEnd();
+    if (wasInRange && !m_SubcaptureRange.InRange() && m_Recorder.IsSpilling()) {
+      FinishSinglePassRange();
+    }
+    m_Recording = m_SubcaptureRange.InRange();
+    return;
+  }
+
+  // Fire state restore exactly once per range, before its first recorded frame.
+  // Replay (and state tracking) simply continues between ranges, so every later
+  // range restores the state as it is at its own start into a new stream.
   if (m_SubcaptureRange.IsRestorePoint()) {
+    m_Recorder.OpenStream();
     TriggerRestoreState();
     // After RestoreState the recorder stream is open; the very next FrameEnd
     // will put us inside the range so recording begins below.
@@ -440,6 +539,14 @@ void SubcaptureLayer::Post(RestoreContentDataCommand& command) {
   // leaves behind never reach this layer as commands. Reconstructing them from the manifest
   // would have to mirror every failure path the upload can take, so take the layouts the
   // upload actually applied instead. A data token can flush a batch, so drain after each.
+  AdoptAppliedImageLayouts();
+}
+
+void SubcaptureLayer::Post(RestoreContentCachedDataCommand& command) {
+  AdoptAppliedImageLayouts();
+}
+
+void SubcaptureLayer::AdoptAppliedImageLayouts() {
   for (const auto& [imageKey, layout] :
        PlayerManager::Get().GetRestoreContentService().DrainAppliedImageLayouts()) {
     auto* image = m_StateTracking.GetState<ImageState>(imageKey);
@@ -2256,8 +2363,16 @@ void SubcaptureLayer::Pre(vkCmdBuildAccelerationStructuresKHRCommand& command) {
 }
 
 void SubcaptureLayer::RequireBlasChainForRaytracing(const char* commandName) {
-  if (m_AnalysisMode || !m_SubcaptureRange.BeforeRange() ||
-      !m_AnalyzerResults.CaptureAsBuildInputs() || m_AnalyzerResults.HasBlasChain()) {
+  if (m_AnalysisMode || !m_SubcaptureRange.BeforeRange()) {
+    return;
+  }
+  if (m_SinglePass) {
+    FatalSubcaptureError(std::string("the stream calls ") + commandName +
+                         " before the subcapture range, which "
+                         "Common.Player.Subcapture.Vulkan.SinglePass cannot restore; disable "
+                         "it to run the two-pass flow");
+  }
+  if (!m_AnalyzerResults.CaptureAsBuildInputs() || m_AnalyzerResults.HasBlasChain()) {
     return;
   }
   FatalSubcaptureError(
@@ -22,6 +22,7 @@
 #include "analyzerService.h"
 #include "analyzerRaytracingService.h"
 #include "raytracingOptimizationService.h"
+#include "spillingReadbackHelper.h"
 #include "commandCodersAuto.h"
 
 #include <memory>
@@ -33,6 +34,16 @@ namespace vulkan {
 
 class PlayerManager;
 
+// Which subcapture pass a SubcaptureLayer runs.
+enum class SubcapturePass {
+  // Restore the state at the range start, pruned by an analysis file if present.
+  Recording,
+  // Write the analysis file only; the stream must be replayed again to record.
+  Analysis,
+  // Analyze and record in one replay; see SubcaptureLayer::BeginSinglePassRange.
+  SinglePass
+};
+
 // SubcaptureLayer sits in the player layer stack and tracks the live state of
 // every Vulkan object that passes through.  During normal playback it keeps
 // the state tables up-to-date so that a future state-restore pass (triggered
@@ -43,24 +54,26 @@ public:
   // framesStr: frame range string from config, e.g. "5" or "3-6".
   // An empty/"-" string disables subcapture.
   //
-  // analysisMode == true selects the analysis pass: the recorder is kept closed
-  // (no output stream), no state restore is emitted, and an AnalyzerService is
-  // created so the AnalyzerLayer can collect in-range object usage and dump the
-  // analysis file.  analysisMode == false is the regular recording pass.
+  // SubcapturePass::Analysis keeps the recorder closed (no output stream), emits no
+  // state restore, and creates an AnalyzerService so the AnalyzerLayer can collect
+  // in-range object usage and dump the analysis file.  SubcapturePass::SinglePass
+  // also creates the AnalyzerService, and records a restore pruned by the analysis
+  // it wrote at the end of the range.
   explicit SubcaptureLayer(PlayerManager& playerManager,
                            const std::string& framesStr,
-                           bool analysisMode = false);
+                           SubcapturePass pass = SubcapturePass::Recording);
+  ~SubcaptureLayer();
 
   StateTrackingService& GetStateTrackingService() {
     return m_StateTracking;
   }
 
-  // Non-null only in analysis mode. Passed to the AnalyzerLayer.
+  // Non-null only in analysis and single-pass mode. Passed to the AnalyzerLayer.
   AnalyzerService* GetAnalyzerService() {
     return m_AnalyzerService.get();
   }
 
-  // Non-null only in analysis mode. Passed to the AnalyzerLayer.
+  // Non-null only in analysis and single-pass mode. Passed to the AnalyzerLayer.
   AnalyzerRaytracingService* GetAnalyzerRaytracingService() {
     return m_AnalyzerRaytracingService.get();
   }
@@ -117,6 +130,7 @@ public:
   // Adopt the image layouts left by player-side uploads, whose internal barriers bypass
   // layer callbacks.
   void Post(RestoreContentDataCommand& command) override;
+  void Post(RestoreContentCachedDataCommand& command) override;
 
   // ---- Synchronization -------------------------------------------------
   void Post(vkCreateFenceCommand& command) override;
@@ -383,6 +397,10 @@ public:
   }
 
 private:
+  // Take the image layouts the player's content upload applied; see
+  // Post(RestoreContentDataCommand&).
+  void AdoptAppliedImageLayouts();
+
   // Query every bound address buffer because a parent trim may omit the original query.
   void TrackBoundBufferDeviceAddress(uint64_t bufferKey);
 
@@ -444,6 +462,15 @@ private:
 
   void TriggerRestoreState();
 
+  // Single-pass mode, at the restore point: snapshot the restore inputs, read every
+  // resource content the unpruned restore would read into a spill file (discarding the
+  // commands), and spill the range's commands until FinishSinglePassRange.
+  void BeginSinglePassRange();
+  // Single-pass mode, at the last in-range present: dump and load the analysis, write
+  // the restore it prunes from the snapshot and the spilled contents, then append the
+  // spilled range.  RecordingLayer records the final present after this.
+  void FinishSinglePassRange();
+
   void RemoveDescriptorSetsByPool(uint64_t poolKey);
 
   // Analysis pass only: mark every object handle embedded in a
@@ -453,7 +480,8 @@ private:
 
   // Recording pass: abort when the application builds acceleration structures before the
   // range but no reduced chain was loaded, leaving nothing to replay them from. No-op in
-  // analysis mode, in serialize mode, or once a chain is present.
+  // analysis mode, in serialize mode, or once a chain is present. Single-pass mode cannot
+  // load a chain before the range, so it always aborts.
   void RequireBlasChainForRaytracing(const char* commandName);
 
   void RefuseGenericAccelerationStructure(uint64_t asKey, VkAccelerationStructureTypeKHR type);
@@ -467,6 +495,7 @@ private:
   // True for the analysis pass.  Declared first so it can be used in the
   // member initializer list (e.g. to keep the recorder closed).
   bool m_AnalysisMode{false};
+  bool m_SinglePass{false};
   SubcaptureRange m_SubcaptureRange;
   SubcaptureRecorder m_Recorder;
   GpuReadbackHelper m_GpuReadbackHelper;
@@ -477,15 +506,17 @@ private:
   MappedMemoryService m_MappedMemory;
   // Recording pass: consumed by StateTrackingService to gate restore.
   AnalyzerResults m_AnalyzerResults;
-  // Analysis pass only: collects in-range object usage and dumps the analysis
-  // file.  Null in recording mode.
+  // Analysis and single-pass only: collects in-range object usage and dumps the
+  // analysis file.  Null in recording mode.
   std::unique_ptr<AnalyzerService> m_AnalyzerService;
-  // Analysis pass only: TLAS->BLAS discovery via GPU readback of TLAS instance
-  // buffers. Null in recording mode.
+  // Analysis and single-pass only: TLAS->BLAS discovery via GPU readback of TLAS
+  // instance buffers. Null in recording mode.
   std::unique_ptr<AnalyzerRaytracingService> m_AnalyzerRaytracingService;
   // Analysis pass only: reduces pre-range BLAS build/update/copy chains to the
   // minimal restore set. Null in recording mode.
   std::unique_ptr<RaytracingOptimizationService> m_RaytracingOptimizationService;
+  // Single-pass only, while the range is spilled: resource contents at the range start.
+  std::unique_ptr<SpillingReadbackHelper> m_ContentSpill;
 
   // Pending window geometry: set when a CreateWindowMetaCommand is observed,
   // consumed when the next surface creation command is processed.
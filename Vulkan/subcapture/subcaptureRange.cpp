@@ -10,6 +10,7 @@
 #include "exception.h"
 #include "log.h"
 
+#include <sstream>
 #include <string>
 
 namespace gits {
@@ -20,52 +21,84 @@ SubcaptureRange::SubcaptureRange(const std::string& framesStr) {
     return;
   }
 
-  try {
-    const auto pos = framesStr.find('-');
-    if (pos != std::string::npos) {
-      m_StartFrame = static_cast<uint32_t>(std::stoi(framesStr.substr(0, pos)));
-      m_EndFrame = static_cast<uint32_t>(std::stoi(framesStr.substr(pos + 1)));
-    } else {
-      m_StartFrame = static_cast<uint32_t>(std::stoi(framesStr));
-      m_EndFrame = m_StartFrame;
+  std::stringstream ranges(framesStr);
+  std::string rangeStr;
+  while (std::getline(ranges, rangeStr, ',')) {
+    Range range;
+    try {
+      const auto pos = rangeStr.find('-');
+      if (pos != std::string::npos) {
+        range.Start = static_cast<uint32_t>(std::stoi(rangeStr.substr(0, pos)));
+        range.End = static_cast<uint32_t>(std::stoi(rangeStr.substr(pos + 1)));
+      } else {
+        range.Start = static_cast<uint32_t>(std::stoi(rangeStr));
+        range.End = range.Start;
+      }
+    } catch (...) {
+      throw Exception("Vulkan subcapture: invalid frame range '" + framesStr + "'");
     }
-  } catch (...) {
+    if (range.End < range.Start) {
+      throw Exception("Vulkan subcapture: invalid frame range '" + framesStr + "'");
+    }
+    if (!m_Ranges.empty() && range.Start <= m_Ranges.back().End + 1) {
+      throw Exception("Vulkan subcapture: frame ranges in '" + framesStr +
+                      "' must be ascending and separated by at least one frame");
+    }
+    m_Ranges.push_back(range);
+  }
+  if (m_Ranges.empty()) {
     throw Exception("Vulkan subcapture: invalid frame range '" + framesStr + "'");
   }
 
   m_Enabled = true;
-  LOG_INFO << "Vulkan subcapture enabled for frames " << m_StartFrame << "-" << m_EndFrame;
+  for (const auto& range : m_Ranges) {
+    LOG_INFO << "Vulkan subcapture enabled for frames " << range.Start << "-" << range.End;
+  }
 }
 
 void SubcaptureRange::FrameEnd() {
   ++m_CurrentFrame;
+  if (m_Current < m_Ranges.size() && m_CurrentFrame > m_Ranges[m_Current].End) {
+    ++m_Current;
+  }
 }
 
 bool SubcaptureRange::IsRestorePoint() const {
-  if (!m_Enabled || m_RestoreFired) {
+  if (!m_Enabled || m_RestoresFired > m_Current || m_Current >= m_Ranges.size()) {
     return false;
   }
   // m_CurrentFrame is the 1-based number of the frame currently being rendered.
-  // State restore must be captured at the start of m_StartFrame, i.e. on the
-  // present that completes frame (m_StartFrame - 1).
-  // Using ">=" together with the m_RestoreFired latch above also covers the
-  // trimming case (m_StartFrame == 1): there is no earlier frame to restore
-  // from, so the condition is satisfied on the very first present and restore
-  // fires once before any frame is recorded. For m_StartFrame >= 2 the counter
-  // passes through every value, so ">=" first becomes true exactly at
-  // m_CurrentFrame == m_StartFrame - 1, identical to the previous "==" check.
-  if (m_CurrentFrame >= m_StartFrame - 1) {
-    m_RestoreFired = true;
+  // State restore must be captured at the start of the range's first frame,
+  // i.e. on the present that completes frame (Start - 1).
+  // Using ">=" together with the m_RestoresFired latch above also covers the
+  // trimming case (Start == 1): there is no earlier frame to restore from, so
+  // the condition is satisfied on the very first present and restore fires
+  // once before any frame is recorded. For Start >= 2 the counter passes
+  // through every value, so ">=" first becomes true exactly at
+  // m_CurrentFrame == Start - 1, identical to the previous "==" check.
+  if (m_CurrentFrame >= m_Ranges[m_Current].Start - 1) {
+    m_RestoresFired = m_Current + 1;
     return true;
   }
   return false;
 }
 
 bool SubcaptureRange::InRange() const {
-  if (!m_Enabled) {
+  if (!m_Enabled || m_Current >= m_Ranges.size()) {
     return false;
   }
-  return m_CurrentFrame >= m_StartFrame && m_CurrentFrame <= m_EndFrame;
+  return m_CurrentFrame >= m_Ranges[m_Current].Start && m_CurrentFrame <= m_Ranges[m_Current].End;
+}
+
+std::string SubcaptureRange::CurrentRangeString() const {
+  if (m_Current >= m_Ranges.size()) {
+    return {};
+  }
+  const auto& range = m_Ranges[m_Current];
+  if (range.Start == range.End) {
+    return std::to_string(range.Start);
+  }
+  return std::to_string(range.Start) + "-" + std::to_string(range.End);
 }
 
 } // namespace vulkan
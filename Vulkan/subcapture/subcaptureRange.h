@@ -10,6 +10,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 namespace gits {
 namespace vulkan {
@@ -17,8 +18,14 @@ namespace vulkan {
 // Tracks the current frame counter and decides when state restore should be
 // triggered.  Mirrors DirectX SubcaptureRange in design: a frame string such
 // as "5" or "3-6" is parsed at construction; IsRestorePoint() returns true
-// exactly once, on the frame immediately before the subcapture start frame
-// (i.e. after Present N-1 is observed).
+// exactly once per range, on the frame immediately before the range's start
+// frame (i.e. after Present N-1 is observed).
+//
+// A comma-separated list such as "3-6,10,20-25" requests several subcaptures
+// from one replay pass.  Ranges must be ascending and separated by at least one
+// frame: the next range's restore point is the present that ends the frame
+// before it, which must not also be the last recorded present of the previous
+// range.  Each range gets its own output stream (see SubcaptureRecorder).
 //
 // "Frame 1" in GITS convention is the first frame after state restore ends,
 // so a range of "1" means trimming mode - state restore fires immediately
@@ -30,35 +37,57 @@ public:
   // An empty or "-" string means subcapture is disabled.
   explicit SubcaptureRange(const std::string& framesStr);
 
-  // Called after each vkQueuePresentKHR.  Advances the frame counter.
+  // Called after each vkQueuePresentKHR.  Advances the frame counter, and moves
+  // on to the next range once the current one has ended.
   void FrameEnd();
 
-  // Returns true exactly once: on the Present call that precedes the first
-  // frame of the requested subcapture range.  After it returns true once it
-  // always returns false (state restore should only be triggered once).
+  // Returns true exactly once per range: on the Present call that precedes the
+  // first frame of that range.  After it returns true for the last range it
+  // always returns false.
   bool IsRestorePoint() const;
 
-  // Returns true while the current frame is within [startFrame_, endFrame_].
+  // Returns true while the current frame is within the current range.
   bool InRange() const;
 
+  // Returns true before the start of the current (i.e. next to be recorded)
+  // range.  False once every range has ended.
   bool BeforeRange() const {
-    return m_CurrentFrame < m_StartFrame;
+    return m_Current < m_Ranges.size() && m_CurrentFrame < m_Ranges[m_Current].Start;
+  }
+
+  // Returns true if a range other than the current one is still to come, i.e.
+  // state needed by a later restore must keep being tracked in range too.
+  bool HasLaterRange() const {
+    return m_Current + 1 < m_Ranges.size();
   }
 
+  // True when there is more than one range.
+  bool IsMultiRange() const {
+    return m_Ranges.size() > 1;
+  }
+
+  // The current range as a frames string ("3-6", or "3" for a single frame).
+  std::string CurrentRangeString() const;
+
   // Returns true if subcapture is enabled at all.
   bool IsEnabled() const {
     return m_Enabled;
   }
 
 private:
+  struct Range {
+    uint32_t Start{1};
+    uint32_t End{1};
+  };
+
   bool m_Enabled{false};
-  uint32_t m_StartFrame{1};
-  uint32_t m_EndFrame{1};
+  std::vector<Range> m_Ranges;
+  size_t m_Current{0}; // index of the range being recorded or coming next
   uint32_t m_CurrentFrame{1}; // 1-based number of the frame currently being
                               // rendered; advanced to the next frame after each
                               // present (FrameEnd). Starts at 1 (frame 1 is in
                               // progress before the first present).
-  mutable bool m_RestoreFired{false};
+  mutable size_t m_RestoresFired{0};
 };
 
 } // namespace vulkan
@@ -11,6 +11,7 @@
 #include "gits.h"
 #include "log.h"
 #include "messageBus.h"
+#include "subcaptureFatal.h"
 
 #include <filesystem>
 #include <memory>
@@ -18,35 +19,162 @@
 namespace gits {
 namespace vulkan {
 
-SubcaptureRecorder::SubcaptureRecorder(bool enabled) {
+namespace {
+
+// Re-records a spilled command verbatim.
+class SpilledCommandSerializer : public stream::CommandSerializer {
+public:
+  SpilledCommandSerializer(unsigned id, uint64_t size) : m_Id(id) {
+    m_DataSize = size;
+    m_Data.reset(new char[size]);
+  }
+  unsigned Id() const override {
+    return m_Id;
+  }
+  char* Buffer() {
+    return m_Data.get();
+  }
+
+private:
+  unsigned m_Id{};
+};
+
+} // namespace
+
+SubcaptureRecorder::SubcaptureRecorder(const SubcaptureRange& range, bool enabled)
+    : m_Range(range) {
   const auto& cfg = Configurator::Get();
 
   if (!enabled || !cfg.common.player.subcapture.enabled ||
       cfg.common.player.subcapture.frames.empty()) {
     return;
   }
+  m_Enabled = true;
+  OpenStream();
+}
 
+std::filesystem::path SubcaptureRecorder::GetStreamPath() const {
   // Configurator::PrepareSubcapturePath() has already been called by playerUtils.cpp
   // and resolved %f% and %r% in common.player.subcapturePath using the common
   // subcapture frames string (see configurator.cpp).  Use the prepared path directly.
-  m_StreamPath = cfg.common.player.subcapturePath;
+  const auto& cfg = Configurator::Get();
+  const std::filesystem::path& path = cfg.common.player.subcapturePath;
+  if (!m_Range.IsMultiRange()) {
+    return path;
+  }
 
+  const std::string rangeName = "frames-" + m_Range.CurrentRangeString();
+  const std::string allRangesName = "frames-" + cfg.common.player.subcapture.frames;
+  std::string pathStr = path.string();
+  const auto pos = pathStr.find(allRangesName);
+  if (pos == std::string::npos) {
+    return path / rangeName;
+  }
+  pathStr.replace(pos, allRangesName.size(), rangeName);
+  return pathStr;
+}
+
+void SubcaptureRecorder::OpenStream() {
+  if (!m_Enabled || (m_Writer && !m_Finished)) {
+    return;
+  }
+  const auto& cfg = Configurator::Get();
+  m_StreamPath = GetStreamPath();
   m_Writer = std::make_unique<stream::StreamWriter>(m_StreamPath,
                                                     cfg.common.player.subcapture.compressionType);
+  m_Finished = false;
   LOG_INFO << "Vulkan subcapture: output stream opened at " << m_StreamPath.string();
 }
 
 SubcaptureRecorder::~SubcaptureRecorder() {
   FinishRecording();
+  if (m_Spill.is_open()) {
+    m_Spill.close();
+    std::error_code ec;
+    std::filesystem::remove(m_SpillPath, ec);
+  }
 }
 
 void SubcaptureRecorder::Record(const stream::CommandSerializer& serializer) {
-  if (!m_Writer) {
+  if (m_Discard) {
+    return;
+  }
+  if (m_Spilling) {
+    const unsigned id = serializer.Id();
+    const uint64_t size = serializer.Size();
+    m_Spill.write(reinterpret_cast<const char*>(&id), sizeof(id));
+    m_Spill.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    m_Spill.write(serializer.Data(), static_cast<std::streamsize>(size));
+    if (!m_Spill) {
+      FatalSubcaptureError("failed to write to the range spill file '" + m_SpillPath.string() +
+                           "'");
+    }
+    ++m_SpilledCommands;
+    return;
+  }
+  if (!m_Writer || m_Finished) {
     return;
   }
   m_Writer->Record(serializer);
 }
 
+std::filesystem::path SubcaptureRecorder::GetSpillPath(const std::string& suffix) const {
+  std::filesystem::path streamPath = GetStreamPath();
+  if (!streamPath.has_filename()) {
+    streamPath = streamPath.parent_path();
+  }
+  return streamPath.parent_path() / (streamPath.filename().string() + suffix);
+}
+
+void SubcaptureRecorder::BeginSpill() {
+  if (!m_Enabled || m_Spilling) {
+    return;
+  }
+  m_SpillPath = GetSpillPath("_range.spill");
+  if (m_SpillPath.has_parent_path()) {
+    std::filesystem::create_directories(m_SpillPath.parent_path());
+  }
+  m_Spill.open(m_SpillPath, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+  if (!m_Spill) {
+    FatalSubcaptureError("failed to create the range spill file '" + m_SpillPath.string() + "'");
+  }
+  m_Spilling = true;
+  m_SpilledCommands = 0;
+}
+
+void SubcaptureRecorder::EndSpill() {
+  if (!m_Spilling) {
+    return;
+  }
+  m_Spilling = false;
+  m_Spill.flush();
+}
+
+void SubcaptureRecorder::AppendSpill() {
+  if (m_Spilling || !m_Spill.is_open()) {
+    return;
+  }
+  m_Spill.seekg(0);
+  for (uint64_t i = 0; i < m_SpilledCommands; ++i) {
+    unsigned id{};
+    uint64_t size{};
+    m_Spill.read(reinterpret_cast<char*>(&id), sizeof(id));
+    m_Spill.read(reinterpret_cast<char*>(&size), sizeof(size));
+    SpilledCommandSerializer serializer(id, size);
+    m_Spill.read(serializer.Buffer(), static_cast<std::streamsize>(size));
+    if (!m_Spill) {
+      FatalSubcaptureError("failed to read back the range spill file '" + m_SpillPath.string() +
+                           "'");
+    }
+    Record(serializer);
+  }
+  m_Spill.close();
+  std::error_code ec;
+  std::filesystem::remove(m_SpillPath, ec);
+  LOG_INFO << "Vulkan subcapture: appended " << m_SpilledCommands << " recorded range commands";
+  m_SpilledCommands = 0;
+}
+
 void SubcaptureRecorder::FinishRecording() {
   if (m_Finished || !m_Writer) {
     return;
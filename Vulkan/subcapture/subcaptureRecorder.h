@@ -10,9 +10,13 @@
 
 #include "commandSerializer.h"
 #include "streamWriter.h"
+#include "subcaptureRange.h"
 
+#include <cstdint>
 #include <filesystem>
+#include <fstream>
 #include <memory>
+#include <string>
 
 namespace gits {
 namespace vulkan {
@@ -23,12 +27,18 @@ namespace vulkan {
 // The recorder is constructed once per player session.  If subcapture is
 // disabled in config (empty frames string) the internal StreamWriter is never
 // created and Record() is a no-op.
+//
+// With several frame ranges, each range is written to its own stream: the
+// configured path with "frames-<all ranges>" (the %r% expansion) replaced by
+// "frames-<range>", or a "frames-<range>" subdirectory of it when the path has
+// no %r%.
 class SubcaptureRecorder {
 public:
   // enabled == false keeps the recorder permanently closed even when subcapture
   // is configured.  Used by the analysis pass, which tracks state and writes the
   // analysis file but must never open (and thus overwrite) the output stream.
-  explicit SubcaptureRecorder(bool enabled = true);
+  // Opens the stream for the first range of 'range'.
+  explicit SubcaptureRecorder(const SubcaptureRange& range, bool enabled = true);
   ~SubcaptureRecorder();
   SubcaptureRecorder(const SubcaptureRecorder&) = delete;
   SubcaptureRecorder& operator=(const SubcaptureRecorder&) = delete;
@@ -39,14 +49,48 @@ public:
   // Flush and close the stream.  Idempotent -- safe to call from destructor.
   void FinishRecording();
 
+  // Open the stream for the range the SubcaptureRange currently points at,
+  // unless a stream is already open.  Called at every restore point.
+  void OpenStream();
+
   bool IsOpen() const {
     return m_Writer != nullptr;
   }
 
+  // Single-pass subcapture: until EndSpill(), Record() appends to a spill file next
+  // to the output stream instead, so that the state restore, which is only known
+  // once the range has ended, can still be written in front of the range.
+  void BeginSpill();
+  void EndSpill();
+  // Record every spilled command into the open stream, in order, and delete the spill.
+  void AppendSpill();
+
+  bool IsSpilling() const {
+    return m_Spilling;
+  }
+
+  // While set, Record() drops every command.  Used by the single-pass subcapture to
+  // run a restore for its content reads only.
+  void SetDiscard(bool discard) {
+    m_Discard = discard;
+  }
+
+  // Path of a temporary file kept next to the output stream of the current range.
+  std::filesystem::path GetSpillPath(const std::string& suffix) const;
+
 private:
+  std::filesystem::path GetStreamPath() const;
+
+  const SubcaptureRange& m_Range;
+  bool m_Enabled{false};
   std::unique_ptr<stream::StreamWriter> m_Writer;
   std::filesystem::path m_StreamPath;
   bool m_Finished{false};
+  std::fstream m_Spill;
+  std::filesystem::path m_SpillPath;
+  bool m_Spilling{false};
+  uint64_t m_SpilledCommands{};
+  bool m_Discard{false};
 };
 
 } // namespace vulkan
@@ -199,8 +199,7 @@ void SyncStateService::InvalidateCBIfOneTimeSubmit(uint64_t key) {
     cbState->DependencyKeys.clear();
     cbState->BeginCommandBuffer.clear();
     cbState->EndCommandBuffer.clear();
-    cbState->RecordedCommands.clear();
-    cbState->RecordedCommandIds.clear();
+    cbState->RecordedCommands.Clear();
     cbState->EventStatesAfterSubmit.clear();
     cbState->ResetQueriesAfterSubmit.clear();
     cbState->UsedQueriesAfterSubmit.clear();
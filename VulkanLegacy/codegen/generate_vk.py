@@ -328,6 +328,17 @@ def make_inherit_type(func_type: FuncType) -> str:
         case _:
             return 'CFunction'
 
+def is_concurrent_exec(token: Token) -> bool:
+    """Return whether the parallel executor may run Exec() of the token on a worker.
+
+    Only plain command recording qualifies: Run() of such a token is exactly
+    Exec() followed by StateTrack().
+    """
+    return (bool(token.token_cache)
+            and make_inherit_type(token.function_type) == 'CFunction'
+            and not token.run_wrap
+            and not any(arg.remove_mapping for arg in token.args))
+
 def get_indent(s: str) -> str:
     """Return the base indentation of given code as a string."""
     # In case of multiline strings, first line should be the least indented.
@@ -1142,6 +1153,7 @@ def main() -> None:
         make_ctype=make_ctype,
         make_func_type_flags=make_func_type_flags,
         make_inherit_type=make_inherit_type,
+        is_concurrent_exec=is_concurrent_exec,
         vk_functions=enabled_tokens,
     )
 
@@ -1155,6 +1167,7 @@ def main() -> None:
         undecorated_type=undecorated_type,
         make_func_type_flags=make_func_type_flags,
         make_inherit_type=make_inherit_type,
+        is_concurrent_exec=is_concurrent_exec,
         vk_functions=enabled_tokens,
         primitive_types=primitive_types,
     )
@@ -127,4 +127,10 @@ VkCommandBuffer gits::Vulkan::${cname}::CommandBuffer() {
   return _commandBuffer.Original();
 }
 % endif
+% if is_concurrent_exec(token):
+
+bool gits::Vulkan::${cname}::ConcurrencyKeys(std::vector<uint64_t>& keys) {
+  return CommandBufferConcurrencyKeys(*_commandBuffer, keys);
+}
+% endif
 % endfor
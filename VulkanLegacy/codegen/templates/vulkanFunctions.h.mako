@@ -60,6 +60,9 @@ namespace gits {
       virtual void ${run_function_name}() override;
     % if token.token_cache:
       virtual VkCommandBuffer CommandBuffer();
+    % endif
+    % if is_concurrent_exec(token):
+      virtual bool ConcurrencyKeys(std::vector<uint64_t>& keys) override;
     % endif
       virtual void Exec();
       virtual void StateTrack();
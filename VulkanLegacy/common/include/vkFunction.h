@@ -78,6 +78,12 @@ public:
   virtual VkCommandBuffer CommandBuffer();
   virtual std::set<uint64_t> GetMappedPointers() = 0;
   virtual uint64_t Size() const override;
+
+protected:
+  // Concurrency keys of a command recording token: the command buffer and the
+  // pool it was allocated from, as recording into command buffers of one pool
+  // must be externally synchronized.
+  static bool CommandBufferConcurrencyKeys(VkCommandBuffer cmdBuf, std::vector<uint64_t>& keys);
 };
 
 class CQueueSubmitFunction : public CFunction {
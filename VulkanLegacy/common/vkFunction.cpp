@@ -9,6 +9,7 @@
 #include "vkFunction.h"
 #include "vulkanFunctions.h"
 #include "vulkanPreToken.h"
+#include "vulkanStateDynamic.h"
 
 namespace gits {
 namespace Vulkan {
@@ -81,6 +82,30 @@ VkCommandBuffer CFunction::CommandBuffer() {
   return VK_NULL_HANDLE;
 }
 
+bool CFunction::CommandBufferConcurrencyKeys(VkCommandBuffer cmdBuf,
+                                             std::vector<uint64_t>& keys) {
+  // Tokens are then only cached in the command buffer state and executed when
+  // the command buffer is submitted.
+  const auto& cfg = Configurator::Get();
+  if (cfg.vulkan.player.execCmdBuffsBeforeQueueSubmit) {
+    return false;
+  }
+  // The special dispatch path (tracing, Lua events, error checks) shares the
+  // logger and the Lua state, so it must not run on the worker threads.
+  if (log::ShouldLog(LogLevel::TRACE) || cfg.common.shared.useEvents ||
+      cfg.common.player.exitOnError || !cfg.common.player.traceSelectedFrames.empty()) {
+    return false;
+  }
+
+  auto it = SD()._commandbufferstates.find(cmdBuf);
+  if (it == SD()._commandbufferstates.end() || !it->second->commandPoolStateStore) {
+    return false;
+  }
+  keys.push_back((uint64_t)cmdBuf);
+  keys.push_back((uint64_t)it->second->commandPoolStateStore->commandPoolHandle);
+  return true;
+}
+
 uint64_t CFunction::Size() const {
   uint64_t total = 0;
 
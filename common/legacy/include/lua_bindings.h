@@ -15,9 +15,11 @@ extern "C" {
 }
 #include "log.h"
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <mutex>
+#include <vector>
 
 namespace gits {
 namespace lua {
@@ -26,6 +28,31 @@ void CreateAndRegisterEvents(const char* script);
 bool FunctionExists(const char* name, lua_State* L);
 void RaiseHookError(const char* name, lua_State* L);
 
+// API call hooks defined in the event script, looked up once after the script
+// is loaded. Checking for a hook is a lock-free bit test and pushing it is a
+// single lua_rawgeti, so hookless calls never touch the Lua state and hooked
+// calls skip the global table lookup.
+class HookTable {
+  const char* const* _names;
+  std::vector<int> _refs;
+  std::vector<std::atomic<uint64_t>> _mask;
+
+public:
+  HookTable(const char* const* names, size_t count);
+  HookTable(const HookTable& other) = delete;
+  HookTable& operator=(const HookTable& other) = delete;
+
+  // Must be called on the loaded script before any hooked function is called.
+  void Resolve(lua_State* L);
+
+  bool Exists(size_t id) const {
+    return ((_mask[id / 64].load(std::memory_order_acquire) >> (id % 64)) & 1) != 0;
+  }
+  void Push(lua_State* L, size_t id) const {
+    lua_rawgeti(L, LUA_REGISTRYINDEX, _refs[id]);
+  }
+};
+
 template <class T>
 void lua_push(lua_State* L, T value) {
   lua_pushnumber(L, static_cast<lua_Number>(value));
@@ -192,6 +219,16 @@ namespace {
 std::recursive_mutex luaMutex;
 }
 
+#define LUA_CALL_HOOK(luas, hooks, id, name, callargs, declargs)                                   \
+  {                                                                                                \
+    using namespace gits::lua;                                                                     \
+    (hooks).Push(luas, id);                                                                        \
+    ArgsPusher ap(luas);                                                                           \
+    ap.push callargs;                                                                              \
+    if (lua_pcall(luas, ArgNum<void declargs>::value, 1, 0) != 0)                                  \
+      RaiseHookError(name, luas);                                                                  \
+  }
+
 #define LUA_CALL_FUNCTION(luas, name, callargs, declargs)                                          \
   {                                                                                                \
     using namespace gits::lua;                                                                     \
@@ -36,6 +36,9 @@ private:
 public:
   CRunner();
   void Register(std::shared_ptr<CHandler> plugin);
+  bool HasHandlers() const {
+    return _hasHandlers;
+  }
   TResultType operator()(CAction& action, CToken& token) const;
 };
 
@@ -58,6 +61,9 @@ public:
 class CAction : private gits::noncopyable {
 public:
   virtual void Run(CToken& token);
+  // Waits for tokens whose execution is still in progress. Called before
+  // played tokens are released.
+  virtual void Flush() {}
   virtual ~CAction() {}
 };
 
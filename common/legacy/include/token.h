@@ -67,6 +67,18 @@ public:
   virtual void Run() = 0;
   virtual void Exec(){};
   virtual void StateTrack(){};
+  /**
+   * @brief Returns keys of the objects modified by Exec()
+   *
+   * Used by the parallel executor. A token that returns true has its Exec()
+   * run on a worker thread, concurrently with other such tokens that share
+   * none of its keys, and its StateTrack() called after that in stream order.
+   * Tokens returning false are run through Run() after all previous tokens
+   * finished.
+   */
+  virtual bool ConcurrencyKeys(std::vector<uint64_t>& keys) {
+    return false;
+  }
   virtual uint64_t Size() const {
     return CId::Size;
   }
@@ -41,6 +41,26 @@ bool FunctionExists(const char* name, lua_State* L) {
   return status;
 }
 
+HookTable::HookTable(const char* const* names, size_t count)
+    : _names(names), _refs(count, LUA_NOREF), _mask((count + 63) / 64) {}
+
+void HookTable::Resolve(lua_State* L) {
+  std::vector<uint64_t> mask(_mask.size(), 0);
+  for (size_t id = 0; id < _refs.size(); ++id) {
+    lua_getglobal(L, _names[id]);
+    if (lua_isfunction(L, -1)) {
+      _refs[id] = luaL_ref(L, LUA_REGISTRYINDEX);
+      mask[id / 64] |= uint64_t(1) << (id % 64);
+    } else {
+      _refs[id] = LUA_NOREF;
+      lua_pop(L, 1);
+    }
+  }
+  for (size_t i = 0; i < mask.size(); ++i) {
+    _mask[i].store(mask[i], std::memory_order_release);
+  }
+}
+
 std::function<void()> CreateWrapper(lua_ptr& L, const char* name) {
   // If there is not such function in the script, return empty handler.
   if (!FunctionExists(name, L.get())) {
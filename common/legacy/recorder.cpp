@@ -126,6 +126,7 @@ LONG WINAPI MyUnhandledExceptionFilter(_EXCEPTION_POINTERS* exceptionInfo) {
     CRecorder::Instance().Stop();
     CRecorder::Instance().Save();
   }
+  log::Flush();
   return EXCEPTION_EXECUTE_HANDLER;
 }
 } // namespace
@@ -839,6 +840,7 @@ void gits::CRecorder::Close() {
     CGits::Instance().GetMessageBus().publish({PUBLISHER_RECORDER, TOPIC_END},
                                               std::make_shared<EndOfRecordingMessage>());
     CRecorder::Dispose();
+    log::Flush();
   };
 }
 
@@ -342,16 +342,27 @@ CToken* CScheduler::Token() {
 bool CScheduler::Run(CAction& action) {
   auto& runner = CGits::Instance().Runner();
 
-  while (auto result = Token()) {
+  for (;;) {
+    // Tokens of the current chunk are released when the next one is loaded.
+    if (_nextToPlay == _tokenList.end()) {
+      action.Flush();
+    }
+    auto result = Token();
+    if (result == nullptr) {
+      break;
+    }
+
     // run token
     runner(action, *result);
     // Give control to GITS framework on frame begin.
     const unsigned id = result->Id();
     if (id == CToken::ID_FRAME_END || id == CToken::ID_INIT_END) {
+      action.Flush();
       return false;
     }
 
     if (CGits::Instance().Finished()) {
+      action.Flush();
       return true;
     }
   }
@@ -76,6 +76,11 @@ PLOG_LINKAGE void Initialize(gits::LogLevel lvl, plog::IAppender* appender);
 PLOG_LINKAGE void AddConsoleAppender();
 PLOG_LINKAGE void RemoveConsoleAppender();
 PLOG_LINKAGE void AddFileAppender(const std::filesystem::path& logFilePath);
+// Moves sink writes to a background thread; see AsyncAppender in log.cpp.
+PLOG_LINKAGE void EnableAsyncLogging();
+// Writes out everything queued so far. Also runs on std::quick_exit; called from
+// the crash and shutdown paths.
+PLOG_LINKAGE void Flush();
 PLOG_LINKAGE bool ShouldLog(gits::LogLevel lvl);
 } // namespace log
 } // namespace gits
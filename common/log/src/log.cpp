@@ -15,7 +15,17 @@
 #include <plog/Formatters/MessageOnlyFormatter.h>
 #include <plog/Init.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #ifdef _WIN32
 #include <plog/Appenders/DebugOutputAppender.h>
@@ -49,11 +59,18 @@ util::nstring LogPrefix(plog::Severity severity) {
   auto now = std::chrono::system_clock::now();
   auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
   auto timeT = std::chrono::system_clock::to_time_t(now);
+  // Formatting may run on any producer thread outside the sinks' locks, so
+  // std::localtime and its shared buffer are not an option.
+  std::tm localTime{};
+#ifdef _WIN32
+  localtime_s(&localTime, &timeT);
+#else
+  localtime_r(&timeT, &localTime);
+#endif
 
   // Print formatted date and time on a pre-allocated buffer
   char buffer[32];
-  size_t offset =
-      std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", std::localtime(&timeT));
+  size_t offset = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &localTime);
   std::snprintf(&buffer[offset], sizeof(buffer) - offset, ".%03d", static_cast<int>(ms.count()));
 
   util::nostringstream ss;
@@ -84,8 +101,238 @@ namespace gits {
 namespace log {
 
 namespace {
+// Forwards records to a sink appender.  Until Start() it does so inline on the
+// logging thread; afterwards every thread formats and timestamps its records and
+// hands them to its own single-producer/single-consumer ring, and a background
+// writer drains all rings into the sink.  Records of one thread keep their
+// order; records of different threads are merged by timestamp within a drain,
+// but one pushed just after a drain is written after the records of that drain,
+// so across threads the order is only approximate.  Errors (and anything more
+// severe) still go out inline, after the queued records, so they are on disk
+// before whatever follows them can crash the process.
+class AsyncAppender : public plog::IAppender {
+public:
+  explicit AsyncAppender(plog::IAppender& sink) : m_Sink(sink) {}
+  ~AsyncAppender() override {
+    Stop();
+  }
+
+  void write(const plog::Record& record) override {
+    // Threads logging while the writer is not running never get a queue.
+    if (!m_Running.load(std::memory_order_relaxed)) {
+      m_Sink.write(record);
+      return;
+    }
+    // Announce the write on this thread's queue before checking m_Running again,
+    // so Stop() can wait for every producer that may still push to a queue (both
+    // sequentially consistent).  The flag is per thread, so producers do not
+    // contend on it.
+    Queue& queue = LocalQueue();
+    ActiveWrite active(queue.Writing);
+    if (!m_Running.load()) {
+      m_Sink.write(record);
+      return;
+    }
+    if (record.getSeverity() <= plog::error) {
+      std::lock_guard<std::mutex> lock(m_WriteMutex);
+      DrainLocked();
+      m_Sink.write(record);
+      return;
+    }
+
+    Entry entry{std::chrono::steady_clock::now(), record.getSeverity(),
+                plog::GitsFormatter::format(record)};
+    while (!queue.TryPush(entry)) {
+      m_WakeUp.notify_one();
+      std::this_thread::yield();
+    }
+  }
+
+  void Start() {
+    std::lock_guard<std::mutex> lock(m_WriteMutex);
+    if (m_Writer.joinable()) {
+      return;
+    }
+    m_StopRequested = false;
+    m_Writer = std::thread(&AsyncAppender::Run, this);
+    m_Running.store(true, std::memory_order_release);
+  }
+
+  // Stops accepting queued records first, then waits for the producers already
+  // past that check, and only then drains; a record pushed after the final drain
+  // would be lost.
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(m_WriteMutex);
+      if (!m_Writer.joinable()) {
+        return;
+      }
+      m_Running.store(false);
+    }
+    // The writer keeps draining meanwhile, so producers blocked on a full queue
+    // get through.  A thread registering its queue after this snapshot sees
+    // m_Running already cleared.
+    std::vector<std::shared_ptr<Queue>> queues;
+    {
+      std::lock_guard<std::mutex> lock(m_QueuesMutex);
+      queues = m_Queues;
+    }
+    for (const auto& queue : queues) {
+      while (queue->Writing.load()) {
+        m_WakeUp.notify_one();
+        std::this_thread::yield();
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_WriteMutex);
+      m_StopRequested = true;
+    }
+    m_WakeUp.notify_one();
+    m_Writer.join();
+    Flush();
+  }
+
+  void Flush() {
+    std::lock_guard<std::mutex> lock(m_WriteMutex);
+    DrainLocked();
+  }
+
+private:
+  // Only the owning thread sets its flag, and appenders are not re-entered.
+  struct ActiveWrite {
+    explicit ActiveWrite(std::atomic<bool>& writing) : Writing(writing) {
+      Writing.store(true);
+    }
+    ~ActiveWrite() {
+      Writing.store(false, std::memory_order_release);
+    }
+    std::atomic<bool>& Writing;
+  };
+
+  struct Entry {
+    std::chrono::steady_clock::time_point Time;
+    plog::Severity Severity{plog::none};
+    plog::util::nstring Line;
+  };
+
+  class Queue {
+  public:
+    bool TryPush(Entry& entry) {
+      const size_t tail = m_Tail.load(std::memory_order_relaxed);
+      if (tail - m_Head.load(std::memory_order_acquire) == kCapacity) {
+        return false;
+      }
+      m_Slots[tail % kCapacity] = std::move(entry);
+      m_Tail.store(tail + 1, std::memory_order_release);
+      return true;
+    }
+
+    template <typename F>
+    void Drain(F&& consume) {
+      size_t head = m_Head.load(std::memory_order_relaxed);
+      const size_t tail = m_Tail.load(std::memory_order_acquire);
+      for (; head != tail; ++head) {
+        consume(std::move(m_Slots[head % kCapacity]));
+      }
+      m_Head.store(head, std::memory_order_release);
+    }
+
+    // Set when the producing thread exits; the queue is dropped once drained.
+    std::atomic<bool> Orphaned{false};
+    // Set by the producing thread while it is in write().
+    std::atomic<bool> Writing{false};
+
+  private:
+    static constexpr size_t kCapacity = 1024;
+    std::array<Entry, kCapacity> m_Slots;
+    alignas(64) std::atomic<size_t> m_Head{0};
+    alignas(64) std::atomic<size_t> m_Tail{0};
+  };
+
+  struct ThreadQueue {
+    std::shared_ptr<Queue> Ptr;
+    ~ThreadQueue() {
+      if (Ptr) {
+        Ptr->Orphaned.store(true, std::memory_order_release);
+      }
+    }
+  };
+
+  Queue& LocalQueue() {
+    thread_local ThreadQueue local;
+    if (!local.Ptr) {
+      local.Ptr = std::make_shared<Queue>();
+      std::lock_guard<std::mutex> lock(m_QueuesMutex);
+      m_Queues.push_back(local.Ptr);
+    }
+    return *local.Ptr;
+  }
+
+  void Run() {
+    std::unique_lock<std::mutex> lock(m_WriteMutex);
+    while (!m_StopRequested) {
+      m_WakeUp.wait_for(lock, std::chrono::milliseconds(10));
+      DrainLocked();
+    }
+  }
+
+  // Caller holds m_WriteMutex, which makes it the single consumer of every queue.
+  void DrainLocked() {
+    std::vector<std::shared_ptr<Queue>> queues;
+    {
+      std::lock_guard<std::mutex> lock(m_QueuesMutex);
+      queues = m_Queues;
+    }
+    std::vector<Queue*> finished;
+    for (const auto& queue : queues) {
+      const bool orphaned = queue->Orphaned.load(std::memory_order_acquire);
+      queue->Drain([this](Entry&& entry) { m_Batch.push_back(std::move(entry)); });
+      if (orphaned) {
+        finished.push_back(queue.get());
+      }
+    }
+    if (!finished.empty()) {
+      std::lock_guard<std::mutex> lock(m_QueuesMutex);
+      std::erase_if(m_Queues, [&](const std::shared_ptr<Queue>& queue) {
+        return std::find(finished.begin(), finished.end(), queue.get()) != finished.end();
+      });
+    }
+
+    // Stable, so records of one thread made at the same clock tick keep their
+    // order.
+    std::stable_sort(m_Batch.begin(), m_Batch.end(),
+                     [](const Entry& a, const Entry& b) { return a.Time < b.Time; });
+    for (const auto& entry : m_Batch) {
+      // Already formatted by the producer, so pass it through the RAW instance,
+      // which GitsFormatter leaves untouched.
+      plog::Record record(entry.Severity, "", 0, "", nullptr, GITS_LOG_INSTANCE_ID_RAW);
+      record << entry.Line;
+      m_Sink.write(record);
+    }
+    m_Batch.clear();
+  }
+
+  plog::IAppender& m_Sink;
+  std::atomic<bool> m_Running{false};
+  std::mutex m_QueuesMutex;
+  std::vector<std::shared_ptr<Queue>> m_Queues;
+  std::mutex m_WriteMutex;
+  std::condition_variable m_WakeUp;
+  bool m_StopRequested{false};
+  std::vector<Entry> m_Batch;
+  std::thread m_Writer;
+};
+
+// Declared in this order so the async appender is destroyed (and drained)
+// while the appenders it writes to are still alive.
 static plog::ColorConsoleAppender<plog::GitsFormatter> consoleAppender;
 static plog::DynamicAppender dynamicAppender;
+static std::unique_ptr<plog::IAppender> fileAppender;
+static AsyncAppender asyncAppender(dynamicAppender);
+
+void FlushOnQuickExit() {
+  asyncAppender.Flush();
+}
 } // namespace
 
 void SetMaxSeverity(gits::LogLevel lvl) {
@@ -118,9 +365,11 @@ plog::Severity GetSeverity(gits::LogLevel lvl) {
 void Initialize(gits::LogLevel lvl) {
   auto severity = GetSeverity(lvl);
   plog::init(severity);
-  plog::get()->addAppender(&dynamicAppender);
+  plog::get()->addAppender(&asyncAppender);
 
 #ifdef _WIN32
+  // Attached to the logger directly, not behind the async appender: queued records
+  // arrive preformatted, which would defeat MessageOnlyFormatter.
   static plog::DebugOutputAppender<plog::MessageOnlyFormatter> debugAppender;
   plog::get()->addAppender(&debugAppender);
 #endif
@@ -144,7 +393,6 @@ void RemoveConsoleAppender() {
 }
 
 void AddFileAppender(const std::filesystem::path& logFilePath) {
-  static std::unique_ptr<plog::IAppender> fileAppender;
   if (logFilePath.empty()) {
     return;
   }
@@ -152,9 +400,23 @@ void AddFileAppender(const std::filesystem::path& logFilePath) {
   // Filename format: gits_<pid>.log
   std::string fileName = "gits_" + std::to_string(getpid()) + ".log";
   std::filesystem::path logFile = logFilePath / fileName;
+  if (fileAppender) {
+    asyncAppender.Flush();
+    dynamicAppender.removeAppender(fileAppender.get());
+  }
   fileAppender = std::make_unique<plog::RollingFileAppender<plog::GitsFormatter>>(logFile.c_str());
 
-  plog::get()->addAppender(fileAppender.get());
+  dynamicAppender.addAppender(fileAppender.get());
+}
+
+void EnableAsyncLogging() {
+  static std::once_flag registered;
+  std::call_once(registered, [] { std::at_quick_exit(FlushOnQuickExit); });
+  asyncAppender.Start();
+}
+
+void Flush() {
+  asyncAppender.Flush();
 }
 
 bool ShouldLog(gits::LogLevel lvl) {
@@ -0,0 +1,99 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#pragma once
+
+#include "streamReader.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gits {
+namespace stream {
+
+// Plays a stream from memory, for benchmarking.  The constructor reads and
+// decompresses the whole stream once.  Run() then plays it in full and replays
+// everything after state restore (the ID_INIT_END command) until it has played
+// that part loopCount times, without any file I/O or decompression.
+//
+// Every pass decodes from a fresh copy of the resident bytes, because runners
+// and layers may patch command data in place.  As in StreamReader, copying and
+// decoding happen on a separate thread one block ahead of the replay, so pass
+// timings only include running the commands.  The frames must leave the state
+// the way the restore left it for later passes to be faithful; objects the
+// frames destroy without recreating are not brought back.
+class ResidentStreamReader : public BaseStreamReader {
+public:
+  using PassCallback = std::function<void(unsigned pass)>;
+
+  ResidentStreamReader(std::vector<CommandFactory*>& commandFactories,
+                       std::istream& stream,
+                       unsigned loopCount);
+  void Run() override;
+  void Close() override;
+
+  // Called when a pass reaches the looped part (right after state restore for
+  // the first pass) and when it finishes.
+  void SetPassCallbacks(PassCallback onPassBegin, PassCallback onPassEnd);
+  unsigned GetFramesPerPass() const {
+    return m_FramesPerPass;
+  }
+
+private:
+  struct Block {
+    std::unique_ptr<char[]> Data;
+    uint64_t Size{};
+  };
+
+  // A block copied out of m_Blocks and decoded for one pass.
+  struct DecodedBlock {
+    std::unique_ptr<char[]> Data;
+    std::vector<std::unique_ptr<CommandRunner>> Runners;
+    unsigned Pass{};
+    // Index of the first runner of the looped part, SIZE_MAX if not in this block.
+    size_t PassBegin{SIZE_MAX};
+    bool PassEnd{};
+    bool Full{};
+  };
+
+  void Load(std::istream& stream);
+  void Decode();
+  // Decodes commands from the first one onwards of the block held in block.Data
+  // and marks where the looped part begins if loopCommand is in the block.
+  void DecodeBlock(DecodedBlock& block, uint64_t dataSize, size_t first, size_t loopCommand);
+  void RunBlock(DecodedBlock& block);
+
+  std::vector<CommandFactory*>& m_CommandFactories;
+  unsigned m_LoopCount{};
+  std::vector<Block> m_Blocks;
+  // Position of the first command after state restore: the block and the index
+  // of the command within it.
+  size_t m_LoopBlock{SIZE_MAX};
+  size_t m_LoopCommand{};
+  unsigned m_FramesPerPass{};
+  uint64_t m_MaxBlockSize{};
+  PassCallback m_OnPassBegin;
+  PassCallback m_OnPassEnd;
+
+  std::thread m_DecodingThread;
+  std::mutex m_Mutex;
+  std::condition_variable m_Condition;
+  DecodedBlock m_Decoded[2];
+  bool m_DecodeFinished{};
+  std::atomic<bool> m_Closed{};
+};
+
+} // namespace stream
+} // namespace gits
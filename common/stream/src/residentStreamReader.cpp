@@ -0,0 +1,212 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#include "residentStreamReader.h"
+#include "streamHeader.h"
+#include "commandId.h"
+#include "log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace gits {
+namespace stream {
+
+ResidentStreamReader::ResidentStreamReader(std::vector<CommandFactory*>& commandFactories,
+                                           std::istream& stream,
+                                           unsigned loopCount)
+    : m_CommandFactories(commandFactories), m_LoopCount(loopCount) {
+  Load(stream);
+}
+
+void ResidentStreamReader::Close() {
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_Closed = true;
+  m_Condition.notify_all();
+}
+
+void ResidentStreamReader::SetPassCallbacks(PassCallback onPassBegin, PassCallback onPassEnd) {
+  m_OnPassBegin = std::move(onPassBegin);
+  m_OnPassEnd = std::move(onPassEnd);
+}
+
+void ResidentStreamReader::Load(std::istream& stream) {
+  std::unique_ptr<StreamDecompressor> decompressor;
+  if (StreamHeader::Get().GetCompressionType() == CompressionType::ZSTD) {
+    decompressor.reset(new ZSTDStreamDecompressor());
+  } else {
+    decompressor.reset(new LZ4StreamDecompressor());
+  }
+
+  std::vector<char> compressed;
+  uint64_t residentBytes = 0;
+  bool afterStateRestore = false;
+  while (stream) {
+    uint64_t compressedSize{};
+    uint64_t uncompressedSize{};
+    stream.read(reinterpret_cast<char*>(&compressedSize), sizeof(compressedSize));
+    stream.read(reinterpret_cast<char*>(&uncompressedSize), sizeof(uncompressedSize));
+    if (!stream) {
+      break;
+    }
+    compressed.resize(compressedSize);
+    stream.read(compressed.data(), compressedSize);
+
+    Block block;
+    block.Data.reset(new char[uncompressedSize]);
+    block.Size = decompressor->Decompress(compressed.data(), block.Data.get(), compressedSize,
+                                          uncompressedSize);
+    if (block.Size != uncompressedSize) {
+      LOG_ERROR << "Decompressed " << block.Size << " instead of " << uncompressedSize
+                << " for compressed " << compressedSize;
+      std::quick_exit(EXIT_FAILURE);
+    }
+
+    // Locate the end of state restore and count the frames of the looped part.
+    size_t command = 0;
+    for (uint64_t offset = 0; offset < block.Size; ++command) {
+      unsigned id{};
+      uint64_t size{};
+      std::memcpy(&id, block.Data.get() + offset, sizeof(id));
+      offset += sizeof(id);
+      std::memcpy(&size, block.Data.get() + offset, sizeof(size));
+      offset += sizeof(size) + size;
+      if (afterStateRestore && id == static_cast<unsigned>(CommonCommandId::ID_FRAME_END)) {
+        ++m_FramesPerPass;
+      }
+      if (!afterStateRestore && id == static_cast<unsigned>(CommonCommandId::ID_INIT_END)) {
+        afterStateRestore = true;
+        m_LoopBlock = m_Blocks.size();
+        m_LoopCommand = command + 1;
+      }
+    }
+
+    residentBytes += block.Size;
+    m_MaxBlockSize = std::max(m_MaxBlockSize, block.Size);
+    m_Blocks.push_back(std::move(block));
+  }
+  for (DecodedBlock& decoded : m_Decoded) {
+    decoded.Data.reset(new char[m_MaxBlockSize]);
+  }
+
+  LOG_INFO << "Stream loaded into memory: " << m_Blocks.size() << " blocks, "
+           << residentBytes / (1024 * 1024) << " MB";
+  if (m_LoopBlock == SIZE_MAX) {
+    LOG_WARNING << "Stream has no state restore, it will be played only once";
+    m_LoopCount = 1;
+  }
+}
+
+void ResidentStreamReader::Run() {
+  m_DecodingThread = std::thread{&ResidentStreamReader::Decode, this};
+
+  for (size_t index = 0; !m_Closed; ++index) {
+    DecodedBlock& block = m_Decoded[index % 2];
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_Condition.wait(lock, [&] { return block.Full || m_DecodeFinished || m_Closed; });
+      if (!block.Full) {
+        break;
+      }
+    }
+
+    RunBlock(block);
+
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      block.Full = false;
+      m_Condition.notify_all();
+    }
+  }
+
+  m_DecodingThread.join();
+}
+
+void ResidentStreamReader::Decode() {
+  size_t index = 0;
+  for (unsigned pass = 1; pass <= m_LoopCount && !m_Closed; ++pass) {
+    const size_t firstBlock = pass == 1 ? 0 : m_LoopBlock;
+    for (size_t i = firstBlock; i < m_Blocks.size(); ++i, ++index) {
+      DecodedBlock& decoded = m_Decoded[index % 2];
+      {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Condition.wait(lock, [&] { return !decoded.Full || m_Closed; });
+        if (m_Closed) {
+          return;
+        }
+      }
+
+      const Block& block = m_Blocks[i];
+      std::memcpy(decoded.Data.get(), block.Data.get(), block.Size);
+      decoded.Pass = pass;
+      decoded.PassEnd = i + 1 == m_Blocks.size() && m_LoopBlock != SIZE_MAX;
+      decoded.PassBegin = SIZE_MAX;
+      const size_t loopCommand = i == m_LoopBlock ? m_LoopCommand : SIZE_MAX;
+      DecodeBlock(decoded, block.Size, pass > 1 ? loopCommand : 0, loopCommand);
+
+      {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        decoded.Full = true;
+        m_Condition.notify_all();
+      }
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_DecodeFinished = true;
+  m_Condition.notify_all();
+}
+
+void ResidentStreamReader::DecodeBlock(DecodedBlock& block,
+                                       uint64_t dataSize,
+                                       size_t first,
+                                       size_t loopCommand) {
+  uint64_t offset = 0;
+  size_t command = 0;
+  for (; offset < dataSize; ++command) {
+    if (command == loopCommand) {
+      block.PassBegin = block.Runners.size();
+    }
+    unsigned id = *reinterpret_cast<unsigned*>(block.Data.get() + offset);
+    offset += sizeof(id);
+    uint64_t size = *reinterpret_cast<uint64_t*>(block.Data.get() + offset);
+    offset += sizeof(size);
+    if (command >= first) {
+      for (CommandFactory* commandFactory : m_CommandFactories) {
+        CommandRunner* runner = commandFactory->CreateCommand(id);
+        if (runner) {
+          runner->DecodeData(block.Data.get() + offset);
+          block.Runners.emplace_back(runner);
+        }
+      }
+    }
+    offset += size;
+  }
+  if (command == loopCommand) {
+    block.PassBegin = block.Runners.size();
+  }
+}
+
+void ResidentStreamReader::RunBlock(DecodedBlock& block) {
+  for (size_t i = 0; i <= block.Runners.size() && !m_Closed; ++i) {
+    if (i == block.PassBegin && m_OnPassBegin) {
+      m_OnPassBegin(block.Pass);
+    }
+    if (i < block.Runners.size()) {
+      block.Runners[i]->Run();
+    }
+  }
+  block.Runners.clear();
+  if (block.PassEnd && m_OnPassEnd && !m_Closed) {
+    m_OnPassEnd(block.Pass);
+  }
+}
+
+} // namespace stream
+} // namespace gits
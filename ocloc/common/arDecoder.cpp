@@ -35,77 +35,71 @@ std::string Ar::ReadUnpaddedString(const char* paddedString, size_t maxLength) {
   return std::string(paddedString, unpaddedSize);
 }
 
-std::string Ar::ReadLongFileName(std::string longFileNamesSection, size_t offset) {
-  size_t end = offset;
-  while ((end < longFileNamesSection.size()) &&
-         (longFileNamesSection[end] != ArSpecialCases::fileNameTerminator)) {
-    ++end;
+std::string Ar::ReadLongFileName(std::string_view longFileNamesSection, size_t offset) {
+  if (offset >= longFileNamesSection.size()) {
+    return std::string();
   }
-  return std::string(longFileNamesSection.data() + offset, end - offset);
+  const auto end = longFileNamesSection.find(ArSpecialCases::fileNameTerminator, offset);
+  return std::string(longFileNamesSection.substr(offset, end - offset));
 }
 
-Ar::Ar(const uint8_t* data, size_t dataLength) {
-  std::vector<uint8_t> binary(data, data + dataLength);
-  const uint8_t* decodePos = binary.data() + arMagic.size();
-  while (decodePos + sizeof(ArFileEntryHeader) <= &binary.back()) {
-    auto fileEntryHeader = reinterpret_cast<const ArFileEntryHeader*>(decodePos);
-    auto fileEntryDataPos = decodePos + sizeof(ArFileEntryHeader);
-    const auto fileSize = std::stoull(fileEntryHeader->fileSizeInBytes);
-    if (fileSize + (fileEntryDataPos - binary.data()) > binary.size()) {
+Ar::Ar(const uint8_t* data, size_t dataLength)
+    : binary(data, dataLength), decodeOffset(arMagic.size()) {}
+
+bool Ar::NextFile(ArFileData& file) {
+  while (decodeOffset + sizeof(ArFileEntryHeader) < binary.size()) {
+    auto fileEntryHeader = reinterpret_cast<const ArFileEntryHeader*>(binary.data() + decodeOffset);
+    const auto identifier =
+        std::string(fileEntryHeader->identifier, sizeof(fileEntryHeader->identifier));
+    const auto fileEntryDataOffset = decodeOffset + sizeof(ArFileEntryHeader);
+    const auto fileSize = std::stoull(std::string(fileEntryHeader->fileSizeInBytes,
+                                                  sizeof(fileEntryHeader->fileSizeInBytes)));
+    if (fileSize > binary.size() - fileEntryDataOffset) {
       LOG_ERROR << "Corrupt AR archive - out of bounds data of file entry with idenfitier '" +
-                       std::string(fileEntryHeader->identifier,
-                                   sizeof(fileEntryHeader->identifier)) +
-                       "'";
+                       identifier + "'";
       throw EOperationFailed(EXCEPTION_MESSAGE);
     }
 
-    if (std::string(fileEntryHeader->trailingMagic, sizeof(fileEntryHeader->trailingMagic)) !=
+    if (std::string_view(fileEntryHeader->trailingMagic, sizeof(fileEntryHeader->trailingMagic)) !=
         ArSpecialCases::arFileEntryTrailingMagic) {
-      LOG_WARNING << "File entry header with identifier '" +
-                         std::string(fileEntryHeader->identifier,
-                                     sizeof(fileEntryHeader->identifier)) +
+      LOG_WARNING << "File entry header with identifier '" + identifier +
                          "' has invalid header trailing string";
     }
 
-    ArFileData fileEntry = {};
-    fileEntry.fileName =
+    const auto fileData = binary.subspan(fileEntryDataOffset, fileSize);
+    decodeOffset = fileEntryDataOffset + fileSize;
+    decodeOffset += fileSize & 1U; // implicit 2-byte alignment
+
+    file.fileName =
         ReadUnpaddedString(fileEntryHeader->identifier, sizeof(fileEntryHeader->identifier));
-    fileEntry.fileData = std::vector<uint8_t>(fileEntryDataPos, fileEntryDataPos + fileSize);
+    if (file.fileName.empty()) {
+      if (ArSpecialCases::longFileNamesFile == std::string_view(fileEntryHeader->identifier, 2U)) {
+        longFileNamesSection = fileData;
+        continue;
+      }
+      LOG_ERROR << "Corrupt AR archive - file entry does not have identifier : '" + identifier +
+                       "'";
+      throw EOperationFailed(EXCEPTION_MESSAGE);
+    }
 
-    if (fileEntry.fileName.empty()) {
-      if (ArSpecialCases::longFileNamesFile == std::string(fileEntryHeader->identifier, 2U)) {
-        fileEntry.fileName = ArSpecialCases::longFileNamesFile;
-        longFileNamesEntry = std::move(fileEntry);
-      } else {
-        LOG_ERROR << "Corrupt AR archive - file entry does not have identifier : '" +
-                         std::string(fileEntryHeader->identifier,
-                                     sizeof(fileEntryHeader->identifier)) +
-                         "'";
+    if (ArSpecialCases::longFileNamePrefix == file.fileName[0]) {
+      const auto longFileNamePos = std::stoull(identifier.substr(1));
+      file.fileName = ReadLongFileName(
+          std::string_view(reinterpret_cast<const char*>(longFileNamesSection.data()),
+                           longFileNamesSection.size()),
+          static_cast<size_t>(longFileNamePos));
+      if (file.fileName.empty()) {
+        LOG_ERROR << "Corrupt AR archive - long file name entry has broken identifier : '" +
+                         identifier + "'";
         throw EOperationFailed(EXCEPTION_MESSAGE);
       }
-    } else {
-      if (ArSpecialCases::longFileNamePrefix == fileEntry.fileName[0]) {
-        const auto longFileNamePos = std::stoull(fileEntryHeader->identifier + 1);
-        fileEntry.fileName = ReadLongFileName(
-            std::string(reinterpret_cast<const char*>(longFileNamesEntry.fileData.data()),
-                        longFileNamesEntry.fileData.size()),
-            static_cast<size_t>(longFileNamePos));
-        if (fileEntry.fileName.empty()) {
-          LOG_ERROR << "Corrupt AR archive - long file name entry has broken identifier : '" +
-                           std::string(fileEntryHeader->identifier,
-                                       sizeof(fileEntryHeader->identifier)) +
-                           "'";
-          throw EOperationFailed(EXCEPTION_MESSAGE);
-        }
-      }
-      if (fileEntry.fileName.size() < paddingFilenamePrefix.size() ||
-          fileEntry.fileName.substr(0, paddingFilenamePrefix.size()) != paddingFilenamePrefix) {
-        files.push_back(std::move(fileEntry));
-      }
     }
-
-    decodePos = fileEntryDataPos + fileSize;
-    decodePos += fileSize & 1U; // implicit 2-byte alignment
+    if (file.fileName.starts_with(paddingFilenamePrefix)) {
+      continue;
+    }
+    file.fileData = fileData;
+    return true;
   }
+  return false;
 }
 } // namespace gits
@@ -8,9 +8,10 @@
 
 #pragma once
 
-#include <string>
-#include <vector>
 #include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
 
 namespace gits {
 class Ar {
@@ -35,23 +36,31 @@ class Ar {
   };
   static_assert(60U == sizeof(ArFileEntryHeader), "Wrong size detected in ArFileEntryHeader");
 
-  struct ArFileData {
-    std::string fileName;
-    std::vector<uint8_t> fileData;
-  };
-
-  ArFileData longFileNamesEntry;
-
   bool IsStringPadding(char character);
   std::string ReadUnpaddedString(const char* paddedString, size_t maxLength);
-  std::string ReadLongFileName(std::string longFileNamesSection, size_t offset);
+  std::string ReadLongFileName(std::string_view longFileNamesSection, size_t offset);
 
 public:
   static constexpr std::string_view arMagic = "!<arch>\n";
   static constexpr std::string_view paddingFilenamePrefix = "pad_";
 
-  std::vector<ArFileData> files;
+  // View of a member file; fileData points into the decoded archive.
+  struct ArFileData {
+    std::string fileName;
+    std::span<const uint8_t> fileData;
+  };
 
+  // Decodes the archive in place: data is not copied and must outlive the
+  // decoder and the views it returns.
   Ar(const uint8_t* data, size_t dataLength);
+
+  // Decodes the next member file, skipping the long file names section and
+  // padding files. Returns false at the end of the archive.
+  bool NextFile(ArFileData& file);
+
+private:
+  std::span<const uint8_t> binary;
+  size_t decodeOffset;
+  std::span<const uint8_t> longFileNamesSection;
 };
 } // namespace gits
@@ -20,6 +20,10 @@ namespace gits {
 namespace ocloc {
 CDriver drv;
 namespace {
+enum HookId : unsigned { HOOK_oclocInvoke, HOOK_oclocFreeOutput, HOOKS_COUNT };
+const char* const hookNames[] = {"oclocInvoke", "oclocFreeOutput"};
+gits::lua::HookTable hooks(hookNames, HOOKS_COUNT);
+
 bool load_ocloc_function_generic(void*& func, const char* name) {
   auto lib = drv.Library();
   if (lib == nullptr) {
@@ -94,35 +98,32 @@ int __ocloccall special_oclocInvoke(unsigned int argc,
                       dataInputHeaders, lenInputHeaders, nameInputHeaders);
   bool call_orig = true;
   int ret = 0;
-  if (Configurator::Get().common.shared.useEvents) {
+  if (hooks.Exists(HOOK_oclocInvoke)) {
     std::unique_lock<std::recursive_mutex> lock(gits::lua::luaMutex);
     if (!bypass_luascript) {
       auto L = CGits::Instance().GetLua().get();
-      bool exists = gits::lua::FunctionExists("oclocInvoke", L);
-      if (exists) {
-        LOG_TRACE_RAW << " Lua begin" << std::endl;
-        lua_getglobal(L, "oclocInvoke");
-        gits::lua::lua_push(L, argc);
-        lua_push_ext(L, argv, argc, true);
-        gits::lua::lua_push(L, numSources);
-        lua_push_ext<const uint8_t*>(L, sources, numSources, true);
-        lua_push_ext(L, sourceLens, numSources);
-        lua_push_ext(L, sourcesNames, numSources, true);
-        gits::lua::lua_push(L, numInputHeaders);
-        lua_push_ext<const uint8_t*>(L, dataInputHeaders, numInputHeaders, true);
-        lua_push_ext(L, lenInputHeaders, numInputHeaders);
-        lua_push_ext(L, nameInputHeaders, numInputHeaders, true);
-        lua_pushlightuserdata(L, (void*)numOutputs);
-        lua_pushlightuserdata(L, (void*)dataOutputs);
-        lua_pushlightuserdata(L, (void*)lenOutputs);
-        lua_pushlightuserdata(L, (void*)nameOutputs);
-        if (lua_pcall(L, 14, 1, 0) != 0) {
-          gits::lua::RaiseHookError("oclocInvoke", L);
-        }
-        call_orig = false;
-        lua_pop(L, lua_gettop(L));
-        LOG_TRACE_RAW << "Lua End" << std::endl;
+      LOG_TRACE_RAW << " Lua begin" << std::endl;
+      hooks.Push(L, HOOK_oclocInvoke);
+      gits::lua::lua_push(L, argc);
+      lua_push_ext(L, argv, argc, true);
+      gits::lua::lua_push(L, numSources);
+      lua_push_ext<const uint8_t*>(L, sources, numSources, true);
+      lua_push_ext(L, sourceLens, numSources);
+      lua_push_ext(L, sourcesNames, numSources, true);
+      gits::lua::lua_push(L, numInputHeaders);
+      lua_push_ext<const uint8_t*>(L, dataInputHeaders, numInputHeaders, true);
+      lua_push_ext(L, lenInputHeaders, numInputHeaders);
+      lua_push_ext(L, nameInputHeaders, numInputHeaders, true);
+      lua_pushlightuserdata(L, (void*)numOutputs);
+      lua_pushlightuserdata(L, (void*)dataOutputs);
+      lua_pushlightuserdata(L, (void*)lenOutputs);
+      lua_pushlightuserdata(L, (void*)nameOutputs);
+      if (lua_pcall(L, 14, 1, 0) != 0) {
+        gits::lua::RaiseHookError("oclocInvoke", L);
       }
+      call_orig = false;
+      lua_pop(L, lua_gettop(L));
+      LOG_TRACE_RAW << "Lua End" << std::endl;
     }
   }
   if (call_orig) {
@@ -167,25 +168,22 @@ int __ocloccall special_oclocFreeOutput(uint32_t* numOutputs,
                                         char*** nameOutputs) {
   int ret = 0;
   bool call_orig = true;
-  if (Configurator::Get().common.shared.useEvents) {
+  if (hooks.Exists(HOOK_oclocFreeOutput)) {
     std::unique_lock<std::recursive_mutex> lock(gits::lua::luaMutex);
     if (!bypass_luascript) {
       auto L = CGits::Instance().GetLua().get();
-      bool exists = gits::lua::FunctionExists("oclocFreeOutput", L);
-      if (exists) {
-        LOG_TRACE_RAW << " Lua begin" << std::endl;
-        lua_getglobal(L, "oclocFreeOutput");
-        lua_pushlightuserdata(L, (void*)numOutputs);
-        lua_pushlightuserdata(L, (void*)dataOutputs);
-        lua_pushlightuserdata(L, (void*)lenOutputs);
-        lua_pushlightuserdata(L, (void*)nameOutputs);
-        if (lua_pcall(L, 4, 1, 0) != 0) {
-          gits::lua::RaiseHookError("oclocFreeOutput", L);
-        }
-        call_orig = false;
-        lua_pop(L, lua_gettop(L));
-        LOG_TRACE_RAW << "Lua End" << std::endl;
+      LOG_TRACE_RAW << " Lua begin" << std::endl;
+      hooks.Push(L, HOOK_oclocFreeOutput);
+      lua_pushlightuserdata(L, (void*)numOutputs);
+      lua_pushlightuserdata(L, (void*)dataOutputs);
+      lua_pushlightuserdata(L, (void*)lenOutputs);
+      lua_pushlightuserdata(L, (void*)nameOutputs);
+      if (lua_pcall(L, 4, 1, 0) != 0) {
+        gits::lua::RaiseHookError("oclocFreeOutput", L);
       }
+      call_orig = false;
+      lua_pop(L, lua_gettop(L));
+      LOG_TRACE_RAW << "Lua End" << std::endl;
     }
   }
   LOG_TRACE_RAW << LOG_PREFIX << "oclocFreeOutput()";
@@ -282,6 +280,7 @@ void RegisterLuaDriverFunctions() {
   auto L = CGits::Instance().GetLua();
   luaL_newlib(L.get(), exports);
   lua_setglobal(L.get(), "drvOcloc");
+  hooks.Resolve(L.get());
 }
 
 CDriver::CDriver() {
@@ -156,7 +156,8 @@ CoclocInvoke_V1::CoclocInvoke_V1(int return_value,
       hashes.push_back(hash);
       if (IsAr((*dataOutputs)[i])) {
         Ar archive((*dataOutputs)[i], (*lenOutputs)[i]);
-        for (const auto& file : archive.files) {
+        Ar::ArFileData file;
+        while (archive.NextFile(file)) {
           hash = ComputeHash(file.fileData.data(), file.fileData.size(), THashType::XX);
           hashes.push_back(hash);
         }
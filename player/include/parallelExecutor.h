@@ -0,0 +1,79 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+/**
+* @file   parallelExecutor.h
+*
+* @brief GITS tokens dependency-aware parallel executor.
+*
+*/
+
+#pragma once
+
+#include "sequentialExecutor.h"
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace gits {
+
+// Executes independent tokens concurrently on a pool of worker threads.
+//
+// Tokens reporting concurrency keys (see CToken::ConcurrencyKeys) are added
+// to a dependency graph: a token depends on the last scheduled token sharing
+// any of its keys, so tokens on the same object keep their stream order while
+// tokens on disjoint objects run in parallel. The playback thread state tracks
+// each such token after it has been executed, in stream order. Any other token first waits for
+// the whole graph to finish and is then run in lockstep on its recorded thread
+// by the sequential executor, so the graph never spans such a token.
+class CParallelExecutor : public CAction {
+  struct CTask {
+    CToken* token;
+    unsigned pendingDeps;
+    bool finished;
+    std::vector<CTask*> successors;
+  };
+
+  CSequentialExecutor _sequentialExecutor;
+  std::vector<std::thread> _workers;
+  std::mutex _mutex;
+  std::condition_variable _readyCondition;
+  std::condition_variable _finishedCondition;
+  bool _shutdown;
+
+  // current window of the dependency graph
+  std::vector<std::unique_ptr<CTask>> _tasks;
+  std::unordered_map<uint64_t, CTask*> _lastTaskForKey;
+  std::deque<CTask*> _readyTasks;
+  size_t _finishedTasks;
+  size_t _trackedTasks;
+
+  std::vector<uint64_t> _keys;
+
+  // statistics
+  uint64_t _tokensCount;
+  uint64_t _concurrentTokensCount;
+  uint64_t _windowsCount;
+
+  void Schedule(CToken& token);
+  void StateTrackFinished(std::unique_lock<std::mutex>& lock, bool wait);
+  void WorkerLoop();
+
+public:
+  CParallelExecutor();
+  ~CParallelExecutor();
+  CParallelExecutor(const CParallelExecutor& other) = delete;
+  CParallelExecutor& operator=(const CParallelExecutor& other) = delete;
+  void Run(CToken& token) override;
+  void Flush() override;
+};
+
+} // namespace gits
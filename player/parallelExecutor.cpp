@@ -0,0 +1,178 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+/**
+* @file   parallelExecutor.cpp
+*
+* @brief  GITS tokens dependency-aware parallel executor.
+*
+*/
+
+#include "parallelExecutor.h"
+#include "token.h"
+#include "gits.h"
+
+#include <algorithm>
+
+namespace {
+// Bounds the memory held by a window of independent tokens.
+const size_t MAX_WINDOW_TOKENS = 4096;
+} // namespace
+
+gits::CParallelExecutor::CParallelExecutor()
+    : _shutdown(false),
+      _finishedTasks(0),
+      _trackedTasks(0),
+      _tokensCount(0),
+      _concurrentTokensCount(0),
+      _windowsCount(0) {
+  unsigned workersCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+  for (unsigned i = 0; i < workersCount; ++i) {
+    _workers.emplace_back([this]() { WorkerLoop(); });
+  }
+  LOG_INFO << "Parallel executor started with " << workersCount << " worker threads";
+}
+
+gits::CParallelExecutor::~CParallelExecutor() {
+  try {
+    Flush();
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _shutdown = true;
+    }
+    _readyCondition.notify_all();
+    for (auto& t : _workers) {
+      if (t.joinable()) {
+        t.join();
+      }
+    }
+    LOG_INFO << "Parallel executor: " << _concurrentTokensCount << " of " << _tokensCount
+             << " tokens executed concurrently in " << _windowsCount << " windows";
+  } catch (...) {
+    topmost_exception_handler("CParallelExecutor::~CParallelExecutor");
+  }
+}
+
+void gits::CParallelExecutor::Run(CToken& token) {
+  ++_tokensCount;
+  if (Configurator::Get().common.player.nullRun) {
+    return;
+  }
+
+  // Runner handlers act on the token around its execution, so with any
+  // registered every token is run in lockstep.
+  _keys.clear();
+  if (!CGits::Instance().Runner().HasHandlers() && token.ConcurrencyKeys(_keys)) {
+    Schedule(token);
+    return;
+  }
+
+  Flush();
+  _sequentialExecutor.Run(token);
+}
+
+void gits::CParallelExecutor::Schedule(CToken& token) {
+  if (_tasks.size() >= MAX_WINDOW_TOKENS) {
+    Flush();
+  }
+
+  ++_concurrentTokensCount;
+
+  std::unique_lock<std::mutex> lock(_mutex);
+  StateTrackFinished(lock, false);
+  if (_tasks.empty()) {
+    ++_windowsCount;
+  }
+  _tasks.push_back(std::make_unique<CTask>(CTask{&token, 0, false, {}}));
+  CTask* task = _tasks.back().get();
+
+  for (auto key : _keys) {
+    CTask*& last = _lastTaskForKey[key];
+    if (last != nullptr && last != task && !last->finished &&
+        std::find(last->successors.begin(), last->successors.end(), task) ==
+            last->successors.end()) {
+      last->successors.push_back(task);
+      ++task->pendingDeps;
+    }
+    last = task;
+  }
+
+  if (task->pendingDeps == 0) {
+    _readyTasks.push_back(task);
+    _readyCondition.notify_one();
+  }
+}
+
+void gits::CParallelExecutor::Flush() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  StateTrackFinished(lock, true);
+  _tasks.clear();
+  _lastTaskForKey.clear();
+  _finishedTasks = 0;
+  _trackedTasks = 0;
+}
+
+void gits::CParallelExecutor::StateTrackFinished(std::unique_lock<std::mutex>& lock, bool wait) {
+  // State tracking is not thread safe and must follow execution, so it is done
+  // on the playback thread, in stream order, for the leading finished tasks.
+  // Only this thread modifies _tasks, so it is safe to walk them unlocked.
+  while (_trackedTasks < _tasks.size()) {
+    CTask* task = _tasks[_trackedTasks].get();
+    if (!task->finished) {
+      if (!wait) {
+        return;
+      }
+      _finishedCondition.wait(lock);
+      continue;
+    }
+    lock.unlock();
+    task->token->StateTrack();
+    lock.lock();
+    ++_trackedTasks;
+  }
+}
+
+void gits::CParallelExecutor::WorkerLoop() {
+  try {
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;) {
+      while (_readyTasks.empty() && !_shutdown) {
+        _readyCondition.wait(lock);
+      }
+      if (_readyTasks.empty()) {
+        return;
+      }
+
+      CTask* task = _readyTasks.front();
+      _readyTasks.pop_front();
+
+      lock.unlock();
+      task->token->Exec();
+      lock.lock();
+
+      task->finished = true;
+      for (auto successor : task->successors) {
+        if (--successor->pendingDeps == 0) {
+          _readyTasks.push_back(successor);
+          _readyCondition.notify_one();
+        }
+      }
+      ++_finishedTasks;
+      _finishedCondition.notify_all();
+    }
+  } catch (gits::Exception& ex) {
+    LOG_ERROR << "Unhandled exception: " << ex.what() << " on parallel executor worker";
+    std::quick_exit(EXIT_FAILURE);
+  } catch (std::exception& ex) {
+    LOG_ERROR << "Unhandled system exception: " << ex.what() << " on parallel executor worker";
+    std::quick_exit(EXIT_FAILURE);
+  } catch (...) {
+    LOG_ERROR << "Unhandled exception caught on parallel executor worker";
+    std::quick_exit(EXIT_FAILURE);
+  }
+}
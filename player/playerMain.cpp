@@ -46,6 +46,7 @@
 #include "windowing.h"
 #include "timer.h"
 #include "runner.h"
+#include "parallelExecutor.h"
 #include "sequentialExecutor.h"
 #include "pragmas.h"
 #include "playerOptions.h"
@@ -252,6 +253,9 @@ int MainBody(int argc, char* argv[]) {
   if (!cfg.common.shared.logToConsole.value_or(true)) {
     log::RemoveConsoleAppender();
   }
+  if (cfg.common.shared.asyncLogging) {
+    log::EnableAsyncLogging();
+  }
   if (!cfg.common.player.outputTracePath.empty()) {
     log::AddFileAppender(cfg.common.player.outputTracePath);
   }
@@ -381,7 +385,9 @@ int MainBody(int argc, char* argv[]) {
     }
 
     // register tokens executor
-    if (cfg.common.player.faithfulThreading) {
+    if (cfg.common.player.faithfulThreading && cfg.common.player.parallelExecution) {
+      player.Register(std::make_unique<CParallelExecutor>());
+    } else if (cfg.common.player.faithfulThreading) {
       player.Register(std::make_unique<CSequentialExecutor>());
     } else {
       player.Register(std::make_unique<CAction>());
@@ -490,6 +496,7 @@ int MainBody(int argc, char* argv[]) {
   }
 #endif
   CGits::Instance().Dispose();
+  log::Flush();
   return returnValue;
 }
 
@@ -507,6 +514,7 @@ void ShowCallstack(PEXCEPTION_POINTERS exceptionPtr) {
 LONG WINAPI ExceptionFilter(PEXCEPTION_POINTERS exceptionPtr) {
   ShowExceptionInfo(exceptionPtr);
   ShowCallstack(exceptionPtr);
+  log::Flush();
   return EXCEPTION_CONTINUE_SEARCH;
 }
 #endif
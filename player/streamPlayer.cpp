@@ -13,6 +13,7 @@
 #include "messageBus.h"
 #include "streamReader.h"
 #include "streamLegacyReader.h"
+#include "residentStreamReader.h"
 #include "streamHeader.h"
 #include "commandFactory.h"
 #include "commandId.h"
@@ -262,16 +263,35 @@ void PlayStream(const std::filesystem::path& streamPath) {
   CommonCommandFactory commonCommandFactory;
   commandFactories.push_back(&commonCommandFactory);
 
+  const unsigned loopCount = Configurator::Get().common.player.loopCount;
+  std::chrono::steady_clock::time_point passBegin;
+  std::vector<std::chrono::steady_clock::duration> passDurations;
+  unsigned framesPerPass = 0;
+
   std::unique_ptr<stream::BaseStreamReader> streamReader;
 #if defined GITS_PLATFORM_WINDOWS_X64
-  if (stream::StreamHeader::Get().IsLegacyStream()) {
+  const bool legacyStream = stream::StreamHeader::Get().IsLegacyStream();
+#else
+  const bool legacyStream = false;
+#endif
+  if (legacyStream) {
+    if (loopCount > 1) {
+      LOG_WARNING << "LoopCount is not supported for legacy streams, playing once";
+    }
     streamReader.reset(new stream::StreamLegacyReader(commandFactories, stream));
+  } else if (loopCount > 1) {
+    auto residentReader =
+        std::make_unique<stream::ResidentStreamReader>(commandFactories, stream, loopCount);
+    framesPerPass = residentReader->GetFramesPerPass();
+    residentReader->SetPassCallbacks(
+        [&passBegin](unsigned) { passBegin = std::chrono::steady_clock::now(); },
+        [&passBegin, &passDurations](unsigned) {
+          passDurations.push_back(std::chrono::steady_clock::now() - passBegin);
+        });
+    streamReader = std::move(residentReader);
   } else {
     streamReader.reset(new stream::StreamReader(commandFactories, stream));
   }
-#else
-  streamReader.reset(new stream::StreamReader(commandFactories, stream));
-#endif
 
   commonCommandFactory.Initialize(streamReader.get(), &stateRestoreTimer, &playbackTimer);
   playbackTimer.Start();
@@ -287,6 +307,12 @@ void PlayStream(const std::filesystem::path& streamPath) {
            << FormatDuration(
                   std::chrono::nanoseconds(playbackTimer.Get() - stateRestoreTimer.Get()));
   LOG_INFO << "  Total duration: " << FormatDuration(std::chrono::nanoseconds(playbackTimer.Get()));
+  for (size_t i = 0; i < passDurations.size(); ++i) {
+    const double ms = std::chrono::duration<double, std::milli>(passDurations[i]).count();
+    LOG_INFO << "  Iteration " << i + 1 << ": " << framesPerPass << " frames in "
+             << FormatDuration(passDurations[i]) << " (" << std::fixed << std::setprecision(3)
+             << (framesPerPass ? ms / framesPerPass : ms) << " ms/frame)";
+  }
 
   MessageBus::get().publish({PUBLISHER_PLAYER, TOPIC_PROGRAM_EXIT},
                             std::make_shared<ProgramMessage>());
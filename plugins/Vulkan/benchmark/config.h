@@ -17,6 +17,10 @@ struct BenchmarkConfig {
   std::string Output{"benchmark.csv"};
   // Number of leading presents excluded from the average-FPS summary (warm-up).
   unsigned WarmupFrames{3};
+  // Per-command CPU stage profiling on the replay path (player only).
+  bool ProfileCommands{};
+  // Number of most expensive commands logged when ProfileCommands is enabled.
+  unsigned TopCommands{20};
   bool IsCapture{};
 };
 
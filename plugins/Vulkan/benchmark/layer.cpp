@@ -12,7 +12,11 @@ namespace gits {
 namespace vulkan {
 
 BenchmarkLayer::BenchmarkLayer(const BenchmarkConfig& cfg, gits::MessageBus& msgBus)
-    : Layer("Benchmark"), m_Cfg(cfg), m_CpuFrameBenchmarkService(cfg, msgBus) {}
+    : Layer("Benchmark"), m_Cfg(cfg), m_CpuFrameBenchmarkService(cfg, msgBus) {
+  if (cfg.ProfileCommands && !cfg.IsCapture) {
+    m_CpuCommandProfilerService = std::make_unique<CpuCommandProfilerService>(cfg, msgBus);
+  }
+}
 
 void BenchmarkLayer::Pre(vkCreateInstanceCommand& command) {
   (void)command;
@@ -29,6 +33,9 @@ void BenchmarkLayer::Post(vkQueuePresentKHRCommand& command) {
     return;
   }
   m_CpuFrameBenchmarkService.OnPostPresent();
+  if (m_CpuCommandProfilerService) {
+    m_CpuCommandProfilerService->OnFrameEnd();
+  }
 }
 
 } // namespace vulkan
@@ -12,6 +12,9 @@
 #include "config.h"
 #include "messageBus.h"
 #include "services/cpuFrameBenchmarkService.h"
+#include "services/cpuCommandProfilerService.h"
+
+#include <memory>
 
 namespace gits {
 namespace vulkan {
@@ -23,10 +26,14 @@ public:
 
   void Pre(vkCreateInstanceCommand& command) override;
   void Post(vkQueuePresentKHRCommand& command) override;
+  CommandProfiler* GetCommandProfiler() override {
+    return m_CpuCommandProfilerService.get();
+  }
 
 private:
   BenchmarkConfig m_Cfg;
   CpuFrameBenchmarkService m_CpuFrameBenchmarkService;
+  std::unique_ptr<CpuCommandProfilerService> m_CpuCommandProfilerService;
 };
 
 } // namespace vulkan
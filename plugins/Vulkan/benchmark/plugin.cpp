@@ -43,6 +43,8 @@ public:
       BenchmarkConfig cfg{};
       cfg.Output = cfgYaml["Config"]["Output"].as<std::string>();
       cfg.WarmupFrames = cfgYaml["Config"]["WarmupFrames"].as<unsigned>();
+      cfg.ProfileCommands = cfgYaml["Config"]["ProfileCommands"].as<bool>(false);
+      cfg.TopCommands = cfgYaml["Config"]["TopCommands"].as<unsigned>(20);
 
       if (m_Context.config->common.mode == GITSMode::MODE_RECORDER) {
         std::filesystem::path outputPath = m_Context.config->common.recorder.dumpPath / cfg.Output;
@@ -0,0 +1,206 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#include "cpuCommandProfilerService.h"
+#include "commandIdsAuto.h"
+#include "log.h"
+
+#include <algorithm>
+#include <bit>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+
+namespace gits {
+namespace vulkan {
+
+namespace {
+
+constexpr unsigned kCommandSlots = static_cast<unsigned>(CommandId::ID_END) -
+                                   static_cast<unsigned>(CommandId::ID_META_BEGIN) + 1;
+
+constexpr const char* kStageNames[kCommandStageCount] = {"Decode", "Remap", "PreLayers",
+                                                         "Driver", "PostLayers"};
+
+// Everything but Decode runs on the replay thread.
+uint64_t ReplayTicks(const std::array<uint64_t, kCommandStageCount>& stageTicks) {
+  return std::accumulate(stageTicks.begin() + 1, stageTicks.end(), uint64_t{0});
+}
+
+std::string SiblingPath(const std::string& output, const std::string& suffix) {
+  std::filesystem::path path(output);
+  return (path.parent_path() / (path.stem().string() + suffix)).string();
+}
+
+} // namespace
+
+CpuCommandProfilerService::CpuCommandProfilerService(const BenchmarkConfig& cfg,
+                                                     gits::MessageBus& msgBus)
+    : m_Cfg(cfg), m_MsgBus(msgBus), m_Commands(kCommandSlots) {
+  m_SubscriptionId = m_MsgBus.subscribe({PUBLISHER_PLAYER, TOPIC_PROGRAM_EXIT},
+                                        [this](Topic t, const MessagePtr& m) { WriteResults(); });
+  m_Frames.reserve(1024);
+  MeasureOverhead();
+  m_StartTicks = ReadProfilerTicks();
+  m_StartTime = std::chrono::steady_clock::now();
+}
+
+CpuCommandProfilerService::~CpuCommandProfilerService() {
+  m_MsgBus.unsubscribe(m_SubscriptionId);
+}
+
+CpuCommandProfilerService::CommandStats* CpuCommandProfilerService::StatsFor(unsigned commandId) {
+  const unsigned index = commandId - static_cast<unsigned>(CommandId::ID_META_BEGIN);
+  return &m_Commands[std::min(index, kCommandSlots - 1)];
+}
+
+void CpuCommandProfilerService::OnCommand(unsigned commandId,
+                                          const char* commandName,
+                                          const uint64_t (&ticks)[kCommandStageCount]) {
+  CommandStats& stats = *StatsFor(commandId);
+  stats.Name = commandName;
+  ++stats.Count;
+  uint64_t replayTicks = 0;
+  for (unsigned stage = 0; stage < kCommandStageCount; ++stage) {
+    stats.StageTicks[stage] += ticks[stage];
+    m_CurrentFrame.StageTicks[stage] += ticks[stage];
+    if (stage != static_cast<unsigned>(CommandStage::Decode)) {
+      replayTicks += ticks[stage];
+    }
+  }
+  stats.MaxTicks = std::max(stats.MaxTicks, replayTicks);
+  ++stats.Histogram[std::min<unsigned>(std::bit_width(replayTicks), kHistogramBuckets - 1)];
+  ++m_CurrentFrame.Commands;
+
+  if (m_FrameEndPending) {
+    m_FrameEndPending = false;
+    m_Frames.push_back(m_CurrentFrame);
+    m_CurrentFrame = {};
+  }
+}
+
+void CpuCommandProfilerService::MeasureOverhead() {
+  // Replays what a profiled runner pays: two decode stamps, the scope's first
+  // stamp, one stamp per remaining stage and the OnCommand report.
+  constexpr unsigned kIterations = 100000;
+  uint64_t ticks[kCommandStageCount]{};
+  const uint64_t begin = ReadProfilerTicks();
+  for (unsigned i = 0; i < kIterations; ++i) {
+    for (unsigned stamp = 0; stamp < kCommandStageCount + 2; ++stamp) {
+      ticks[stamp % kCommandStageCount] = ReadProfilerTicks();
+    }
+    OnCommand(static_cast<unsigned>(CommandId::ID_END), "calibration", ticks);
+  }
+  m_OverheadTicks = static_cast<double>(ReadProfilerTicks() - begin) / kIterations;
+
+  m_Commands.back() = {};
+  m_CurrentFrame = {};
+}
+
+void CpuCommandProfilerService::WriteResults() {
+  if (m_Frames.empty() && m_CurrentFrame.Commands == 0) {
+    return;
+  }
+  if (m_CurrentFrame.Commands != 0) {
+    m_Frames.push_back(m_CurrentFrame);
+    m_CurrentFrame = {};
+  }
+
+  const double elapsedUs = std::chrono::duration<double, std::micro>(
+                               std::chrono::steady_clock::now() - m_StartTime)
+                               .count();
+  const double ticksPerUs =
+      elapsedUs > 0.0 ? static_cast<double>(ReadProfilerTicks() - m_StartTicks) / elapsedUs : 1.0;
+  const auto toUs = [ticksPerUs](double ticks) { return ticks / ticksPerUs; };
+
+  const std::string commandsPath = SiblingPath(m_Cfg.Output, "_commands.csv");
+  std::ofstream commands(commandsPath);
+  GITS_ASSERT(commands.good(),
+              "CpuCommandProfilerService - failed to create file: " + commandsPath);
+  commands << "Command,Count";
+  for (const char* stage : kStageNames) {
+    commands << "," << stage << "[us]";
+  }
+  commands << ",ReplayAvg[us],ReplayMax[us],ReplayP50[us],ReplayP99[us]\n";
+
+  std::vector<const CommandStats*> ranked;
+  uint64_t totalCommands = 0;
+  uint64_t totalReplayTicks = 0;
+  for (const auto& stats : m_Commands) {
+    if (stats.Count == 0) {
+      continue;
+    }
+    ranked.push_back(&stats);
+    totalCommands += stats.Count;
+    totalReplayTicks += ReplayTicks(stats.StageTicks);
+
+    // Percentiles are the upper bound of the log2 bucket they fall in.
+    const auto percentile = [&stats](double fraction) {
+      const uint64_t target = static_cast<uint64_t>(fraction * (stats.Count - 1)) + 1;
+      uint64_t seen = 0;
+      for (unsigned bucket = 0; bucket < kHistogramBuckets; ++bucket) {
+        seen += stats.Histogram[bucket];
+        if (seen >= target) {
+          return static_cast<double>(uint64_t{1} << bucket);
+        }
+      }
+      return static_cast<double>(stats.MaxTicks);
+    };
+
+    commands << stats.Name << "," << stats.Count;
+    for (uint64_t ticks : stats.StageTicks) {
+      commands << "," << toUs(static_cast<double>(ticks));
+    }
+    commands << "," << toUs(static_cast<double>(ReplayTicks(stats.StageTicks)) / stats.Count)
+             << "," << toUs(static_cast<double>(stats.MaxTicks)) << ","
+             << toUs(percentile(0.5)) << "," << toUs(percentile(0.99)) << "\n";
+  }
+
+  const std::string stagesPath = SiblingPath(m_Cfg.Output, "_stages.csv");
+  std::ofstream stages(stagesPath);
+  GITS_ASSERT(stages.good(), "CpuCommandProfilerService - failed to create file: " + stagesPath);
+  stages << "Frame#,Commands";
+  for (const char* stage : kStageNames) {
+    stages << "," << stage << "[ms]";
+  }
+  stages << "\n";
+  for (size_t i = 0; i < m_Frames.size(); ++i) {
+    stages << (i + 1) << "," << m_Frames[i].Commands;
+    for (uint64_t ticks : m_Frames[i].StageTicks) {
+      stages << "," << toUs(static_cast<double>(ticks)) / 1000.0;
+    }
+    stages << "\n";
+  }
+
+  std::sort(ranked.begin(), ranked.end(), [](const CommandStats* a, const CommandStats* b) {
+    return ReplayTicks(a->StageTicks) > ReplayTicks(b->StageTicks);
+  });
+  const size_t topCount = std::min<size_t>(ranked.size(), m_Cfg.TopCommands);
+  LOG_INFO << "Benchmark: top " << topCount << " commands by replay-thread CPU time:";
+  for (size_t i = 0; i < topCount; ++i) {
+    const CommandStats& stats = *ranked[i];
+    const auto& t = stats.StageTicks;
+    LOG_INFO << "  " << stats.Name << ": " << stats.Count << " calls, "
+             << toUs(static_cast<double>(ReplayTicks(t))) / 1000.0 << "ms (remap "
+             << toUs(static_cast<double>(t[1])) / 1000.0 << "ms, pre layers "
+             << toUs(static_cast<double>(t[2])) / 1000.0 << "ms, driver "
+             << toUs(static_cast<double>(t[3])) / 1000.0 << "ms, post layers "
+             << toUs(static_cast<double>(t[4])) / 1000.0 << "ms), decode "
+             << toUs(static_cast<double>(t[0])) / 1000.0 << "ms off-thread";
+  }
+
+  const double overheadUs = toUs(m_OverheadTicks * static_cast<double>(totalCommands));
+  const double replayUs = toUs(static_cast<double>(totalReplayTicks));
+  LOG_INFO << "Benchmark: command profiler overhead " << toUs(m_OverheadTicks) * 1000.0
+           << "ns per command, about " << overheadUs / 1000.0 << "ms in total ("
+           << (replayUs > 0.0 ? 100.0 * overheadUs / replayUs : 0.0)
+           << "% of measured replay time). Written to " << commandsPath << " and " << stagesPath;
+}
+
+} // namespace vulkan
+} // namespace gits
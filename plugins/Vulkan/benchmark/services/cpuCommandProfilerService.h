@@ -0,0 +1,79 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#pragma once
+
+#include "../config.h"
+#include "commandProfiler.h"
+#include "messageBus.h"
+
+#include <array>
+#include <chrono>
+#include <vector>
+
+namespace gits {
+namespace vulkan {
+
+// Aggregates the per-stage ticks the player reports for every command (see
+// CommandProfiler) into per-CommandId histograms, held in arrays sized once up
+// front, and into a per-frame stage breakdown. At exit it writes both next to
+// the frame-time .csv, logs the top-N commands by replay-thread time and
+// reports the profiler's own measured overhead.
+class CpuCommandProfilerService : public CommandProfiler {
+public:
+  CpuCommandProfilerService(const BenchmarkConfig& cfg, gits::MessageBus& msgBus);
+  ~CpuCommandProfilerService();
+  CpuCommandProfilerService(const CpuCommandProfilerService&) = delete;
+  CpuCommandProfilerService& operator=(const CpuCommandProfilerService&) = delete;
+
+  void OnCommand(unsigned commandId,
+                 const char* commandName,
+                 const uint64_t (&ticks)[kCommandStageCount]) override;
+  // The present's own runner reports after its Post layers, so the frame is
+  // closed on the next OnCommand, with the present still counted in it.
+  void OnFrameEnd() {
+    m_FrameEndPending = true;
+  }
+
+private:
+  static constexpr unsigned kHistogramBuckets = 40; // log2 of replay-thread ticks
+
+  struct CommandStats {
+    const char* Name{};
+    uint64_t Count{};
+    std::array<uint64_t, kCommandStageCount> StageTicks{};
+    uint64_t MaxTicks{};
+    std::array<uint32_t, kHistogramBuckets> Histogram{};
+  };
+  struct FrameStats {
+    uint64_t Commands{};
+    std::array<uint64_t, kCommandStageCount> StageTicks{};
+  };
+
+  CommandStats* StatsFor(unsigned commandId);
+  void MeasureOverhead();
+  void WriteResults();
+
+private:
+  const BenchmarkConfig m_Cfg;
+  gits::MessageBus& m_MsgBus;
+  unsigned m_SubscriptionId{};
+  // Indexed by CommandId - ID_META_BEGIN; the last slot takes anything else.
+  std::vector<CommandStats> m_Commands;
+  std::vector<FrameStats> m_Frames;
+  FrameStats m_CurrentFrame;
+  bool m_FrameEndPending{};
+  // Tick-to-time calibration, taken over the whole run.
+  uint64_t m_StartTicks{};
+  std::chrono::steady_clock::time_point m_StartTime{};
+  // Ticks the stamping plus OnCommand cost per command, measured at startup.
+  double m_OverheadTicks{};
+};
+
+} // namespace vulkan
+} // namespace gits
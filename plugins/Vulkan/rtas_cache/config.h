@@ -0,0 +1,23 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#pragma once
+
+#include <string>
+
+namespace gits {
+namespace vulkan {
+
+struct RtasCacheConfig {
+  std::string CacheFile{"rtas_cache.dat"};
+  bool Record{};
+  bool StateRestoreOnly{true};
+};
+
+} // namespace vulkan
+} // namespace gits
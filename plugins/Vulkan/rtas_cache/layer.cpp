@@ -0,0 +1,241 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#include "layer.h"
+#include "log.h"
+
+#include <filesystem>
+#include <iostream>
+
+namespace gits {
+namespace vulkan {
+
+RtasCacheLayer::RtasCacheLayer(const RtasCacheConfig& cfg,
+                               VkDeviceLevelDispatchTable** deviceDispatchTable,
+                               VkInstanceLevelDispatchTable** instanceDispatchTable)
+    : Layer("RtasCache"),
+      m_Cfg(cfg),
+      m_DeviceDispatchTable(deviceDispatchTable),
+      m_InstanceDispatchTable(instanceDispatchTable),
+      m_Serializer(m_Cfg.CacheFile),
+      m_Deserializer(m_Cfg.CacheFile) {
+  LOG_INFO << "RtasCache - Cache file: " << cfg.CacheFile;
+  LOG_INFO << "RtasCache - State restore only: " << (cfg.StateRestoreOnly ? "true" : "false");
+  if (!cfg.Record && !std::filesystem::exists(cfg.CacheFile)) {
+    LOG_ERROR << "RtasCache - Cache file does not exist!";
+    m_IsValid = false;
+  }
+}
+
+RtasCacheLayer::~RtasCacheLayer() {
+  try {
+    ReleaseDevice();
+    if (m_Cfg.Record) {
+      LOG_INFO << "RtasCache - Serialized " << m_Serializer.GetSerializedCount() << "/"
+               << m_BlasCount << " BLASes";
+      m_Serializer.WriteCache();
+    } else {
+      LOG_INFO << "RtasCache - Deserialized " << m_CachedBlasCount << "/" << m_BlasCount
+               << " BLASes";
+    }
+  } catch (...) {
+    std::cerr << "Exception in RtasCacheLayer::~RtasCacheLayer";
+  }
+}
+
+void RtasCacheLayer::Pre(StateRestoreBeginCommand& command) {
+  m_StateRestore = true;
+}
+
+void RtasCacheLayer::Pre(StateRestoreEndCommand& command) {
+  m_StateRestore = false;
+}
+
+void RtasCacheLayer::Post(vkCreateDeviceCommand& command) {
+  // Like the DirectX cache, only the first device is handled.
+  if (m_Device || command.m_Return.Value != VK_SUCCESS || !m_DeviceDispatchTable ||
+      !*m_DeviceDispatchTable || !m_InstanceDispatchTable || !*m_InstanceDispatchTable) {
+    return;
+  }
+  RtasCacheDevice device;
+  device.Device = *command.m_pDevice.Value;
+  device.DispatchTable = **m_DeviceDispatchTable;
+  (*m_InstanceDispatchTable)
+      ->vkGetPhysicalDeviceMemoryProperties(command.m_physicalDevice.Value,
+                                            &device.MemoryProperties);
+  m_Device = device;
+}
+
+void RtasCacheLayer::Pre(vkDestroyDeviceCommand& command) {
+  if (m_Device && command.m_device.Value == m_Device->Device) {
+    ReleaseDevice();
+  }
+}
+
+void RtasCacheLayer::Post(vkGetDeviceQueueCommand& command) {
+  if (m_Cfg.Record && command.m_pQueue.Value && OwnedByDevice(command.m_device.Value)) {
+    m_Serializer.SetQueueFamily(*command.m_pQueue.Value, command.m_queueFamilyIndex.Value);
+  }
+}
+
+void RtasCacheLayer::Post(vkGetDeviceQueue2Command& command) {
+  if (m_Cfg.Record && command.m_pQueue.Value && command.m_pQueueInfo.Value &&
+      OwnedByDevice(command.m_device.Value)) {
+    m_Serializer.SetQueueFamily(*command.m_pQueue.Value,
+                                command.m_pQueueInfo.Value->queueFamilyIndex);
+  }
+}
+
+void RtasCacheLayer::Pre(vkDestroyAccelerationStructureKHRCommand& command) {
+  if (m_Cfg.Record && OwnedByDevice(command.m_device.Value)) {
+    m_Serializer.DestroyAccelerationStructure(command.m_accelerationStructure.Value);
+  }
+}
+
+void RtasCacheLayer::ReleaseDevice() {
+  m_Serializer.Flush();
+  m_Deserializer.Release();
+  m_Device.reset();
+}
+
+void RtasCacheLayer::Pre(vkCmdBuildAccelerationStructuresKHRCommand& command) {
+  VkCommandBuffer commandBuffer = command.m_commandBuffer.Value;
+  if (!Replay() || !OwnedByDevice(commandBuffer)) {
+    return;
+  }
+
+  if (!m_Preloaded) {
+    m_Preloaded = true;
+    m_IsValid = m_Deserializer.PreloadCache(*m_Device);
+    if (!m_IsValid) {
+      LOG_WARNING << "RtasCache - Failed to preload RTAS cache. Will not deserialize. Fallback "
+                     "to performing standard builds.";
+      return;
+    }
+  }
+
+  const uint32_t infoCount = command.m_infoCount.Value;
+  const auto* infos = command.m_pInfos.Value;
+  const auto* const* ranges = command.m_ppBuildRangeInfos.Value;
+  std::vector<VkAccelerationStructureBuildGeometryInfoKHR> builtInfos;
+  std::vector<const VkAccelerationStructureBuildRangeInfoKHR*> builtRanges;
+  unsigned cachedCount = 0;
+  for (uint32_t i = 0; i < infoCount; ++i) {
+    if (IsCacheableBuild(infos[i])) {
+      ++m_BlasCount;
+      uint64_t buildKey = ComputeBuildKey(command.m_Key, i, infos[i], ranges[i]);
+      if (m_Deserializer.IsCached(buildKey)) {
+        m_Deserializer.Deserialize(commandBuffer, buildKey, infos[i].dstAccelerationStructure);
+        ++cachedCount;
+        continue;
+      }
+    }
+    builtInfos.push_back(infos[i]);
+    builtRanges.push_back(ranges[i]);
+  }
+  if (cachedCount == 0) {
+    return;
+  }
+  m_CachedBlasCount += cachedCount;
+
+  // Builds of one command are independent of each other, so the remaining
+  // ones are issued separately and the original command is skipped.  The
+  // command itself is left untouched for the layers that follow.
+  if (!builtInfos.empty()) {
+    m_Device->DispatchTable.vkCmdBuildAccelerationStructuresKHR(
+        commandBuffer, static_cast<uint32_t>(builtInfos.size()), builtInfos.data(),
+        builtRanges.data());
+  }
+  command.m_Skip = true;
+}
+
+void RtasCacheLayer::Post(vkCmdBuildAccelerationStructuresKHRCommand& command) {
+  VkCommandBuffer commandBuffer = command.m_commandBuffer.Value;
+  if (!Record() || !OwnedByDevice(commandBuffer)) {
+    return;
+  }
+  const auto* infos = command.m_pInfos.Value;
+  const auto* const* ranges = command.m_ppBuildRangeInfos.Value;
+  for (uint32_t i = 0; i < command.m_infoCount.Value; ++i) {
+    if (!IsCacheableBuild(infos[i])) {
+      continue;
+    }
+    ++m_BlasCount;
+    uint64_t buildKey = ComputeBuildKey(command.m_Key, i, infos[i], ranges[i]);
+    m_Serializer.Serialize(*m_Device, commandBuffer, buildKey, infos[i], ranges[i]);
+  }
+}
+
+void RtasCacheLayer::Post(vkBeginCommandBufferCommand& command) {
+  if (m_Cfg.Record && OwnedByDevice(command.m_commandBuffer.Value)) {
+    m_Serializer.ResetCommandBuffer(command.m_commandBuffer.Value);
+  }
+}
+
+void RtasCacheLayer::Post(vkResetCommandBufferCommand& command) {
+  if (m_Cfg.Record && OwnedByDevice(command.m_commandBuffer.Value)) {
+    m_Serializer.ResetCommandBuffer(command.m_commandBuffer.Value);
+  }
+}
+
+void RtasCacheLayer::Pre(vkFreeCommandBuffersCommand& command) {
+  if (!m_Cfg.Record || !OwnedByDevice(command.m_device.Value) ||
+      !command.m_pCommandBuffers.Value) {
+    return;
+  }
+  for (uint32_t i = 0; i < command.m_commandBufferCount.Value; ++i) {
+    m_Serializer.ResetCommandBuffer(command.m_pCommandBuffers.Value[i]);
+  }
+}
+
+void RtasCacheLayer::Post(vkQueueSubmitCommand& command) {
+  if (!m_Cfg.Record || command.m_Return.Value != VK_SUCCESS ||
+      !OwnedByDevice(command.m_queue.Value)) {
+    return;
+  }
+  std::vector<VkCommandBuffer> commandBuffers;
+  for (uint32_t i = 0; i < command.m_submitCount.Value; ++i) {
+    const auto& submit = command.m_pSubmits.Value[i];
+    commandBuffers.insert(commandBuffers.end(), submit.pCommandBuffers,
+                          submit.pCommandBuffers + submit.commandBufferCount);
+  }
+  m_Serializer.Submit(command.m_queue.Value, commandBuffers);
+}
+
+void RtasCacheLayer::Post(vkQueueSubmit2Command& command) {
+  if (!m_Cfg.Record || command.m_Return.Value != VK_SUCCESS ||
+      !OwnedByDevice(command.m_queue.Value)) {
+    return;
+  }
+  std::vector<VkCommandBuffer> commandBuffers;
+  for (uint32_t i = 0; i < command.m_submitCount.Value; ++i) {
+    const auto& submit = command.m_pSubmits.Value[i];
+    for (uint32_t j = 0; j < submit.commandBufferInfoCount; ++j) {
+      commandBuffers.push_back(submit.pCommandBufferInfos[j].commandBuffer);
+    }
+  }
+  m_Serializer.Submit(command.m_queue.Value, commandBuffers);
+}
+
+void RtasCacheLayer::Post(vkQueueSubmit2KHRCommand& command) {
+  if (!m_Cfg.Record || command.m_Return.Value != VK_SUCCESS ||
+      !OwnedByDevice(command.m_queue.Value)) {
+    return;
+  }
+  std::vector<VkCommandBuffer> commandBuffers;
+  for (uint32_t i = 0; i < command.m_submitCount.Value; ++i) {
+    const auto& submit = command.m_pSubmits.Value[i];
+    for (uint32_t j = 0; j < submit.commandBufferInfoCount; ++j) {
+      commandBuffers.push_back(submit.pCommandBufferInfos[j].commandBuffer);
+    }
+  }
+  m_Serializer.Submit(command.m_queue.Value, commandBuffers);
+}
+
+} // namespace vulkan
+} // namespace gits
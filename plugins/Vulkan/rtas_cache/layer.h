@@ -0,0 +1,76 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#pragma once
+
+#include "layerAuto.h"
+#include "config.h"
+#include "rtasCacheUtils.h"
+#include "rtasSerializer.h"
+#include "rtasDeserializer.h"
+
+#include <optional>
+
+namespace gits {
+namespace vulkan {
+
+class RtasCacheLayer : public Layer {
+public:
+  RtasCacheLayer(const RtasCacheConfig& cfg,
+                 VkDeviceLevelDispatchTable** deviceDispatchTable,
+                 VkInstanceLevelDispatchTable** instanceDispatchTable);
+  ~RtasCacheLayer();
+
+  void Pre(StateRestoreBeginCommand& command) override;
+  void Pre(StateRestoreEndCommand& command) override;
+  void Post(vkCreateDeviceCommand& command) override;
+  void Pre(vkDestroyDeviceCommand& command) override;
+  void Post(vkGetDeviceQueueCommand& command) override;
+  void Post(vkGetDeviceQueue2Command& command) override;
+  void Pre(vkDestroyAccelerationStructureKHRCommand& command) override;
+  void Pre(vkCmdBuildAccelerationStructuresKHRCommand& command) override;
+  void Post(vkCmdBuildAccelerationStructuresKHRCommand& command) override;
+  void Post(vkBeginCommandBufferCommand& command) override;
+  void Post(vkResetCommandBufferCommand& command) override;
+  void Pre(vkFreeCommandBuffersCommand& command) override;
+  void Post(vkQueueSubmitCommand& command) override;
+  void Post(vkQueueSubmit2Command& command) override;
+  void Post(vkQueueSubmit2KHRCommand& command) override;
+
+private:
+  // Whether builds are serialized / replaced right now.  Submission tracking for
+  // pending serializations runs on m_Cfg.Record alone.
+  bool Record() const {
+    return m_Cfg.Record && (m_Cfg.StateRestoreOnly ? m_StateRestore : true);
+  }
+  bool Replay() const {
+    return !m_Cfg.Record && m_IsValid && (m_Cfg.StateRestoreOnly ? m_StateRestore : true);
+  }
+  // Dispatchable handles of one device share its loader dispatch pointer.
+  template <typename Handle>
+  bool OwnedByDevice(Handle handle) const {
+    return m_Device && handle &&
+           *reinterpret_cast<void**>(handle) == *reinterpret_cast<void**>(m_Device->Device);
+  }
+  void ReleaseDevice();
+
+  RtasCacheConfig m_Cfg;
+  VkDeviceLevelDispatchTable** m_DeviceDispatchTable;
+  VkInstanceLevelDispatchTable** m_InstanceDispatchTable;
+  std::optional<RtasCacheDevice> m_Device;
+  RtasSerializer m_Serializer;
+  RtasDeserializer m_Deserializer;
+  bool m_StateRestore{false};
+  bool m_Preloaded{false};
+  bool m_IsValid{true};
+  unsigned m_CachedBlasCount{0};
+  unsigned m_BlasCount{0};
+};
+
+} // namespace vulkan
+} // namespace gits
@@ -0,0 +1,179 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#include "rtasCacheUtils.h"
+#include "log.h"
+
+namespace gits {
+namespace vulkan {
+
+namespace {
+
+// FNV-1a, fed field by field so struct padding never reaches the hash.
+class BuildHasher {
+public:
+  template <typename T>
+  void Add(const T& value) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+    for (size_t i = 0; i < sizeof(T); ++i) {
+      m_Hash ^= bytes[i];
+      m_Hash *= 0x100000001b3ull;
+    }
+  }
+
+  uint64_t Get() const {
+    return m_Hash;
+  }
+
+private:
+  uint64_t m_Hash{0xcbf29ce484222325ull};
+};
+
+uint32_t FindMemoryType(const VkPhysicalDeviceMemoryProperties& properties,
+                        uint32_t typeBits,
+                        VkMemoryPropertyFlags flags) {
+  for (uint32_t i = 0; i < properties.memoryTypeCount; ++i) {
+    if ((typeBits & (1u << i)) && (properties.memoryTypes[i].propertyFlags & flags) == flags) {
+      return i;
+    }
+  }
+  return UINT32_MAX;
+}
+
+} // namespace
+
+bool CreateHostBuffer(const RtasCacheDevice& device,
+                      VkDeviceSize size,
+                      VkBufferUsageFlags usage,
+                      HostBuffer& buffer) {
+  const auto& dt = device.DispatchTable;
+
+  VkBufferCreateInfo bufferInfo{};
+  bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  bufferInfo.size = size + kSerializedDataAlignment;
+  bufferInfo.usage = usage | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  if (dt.vkCreateBuffer(device.Device, &bufferInfo, nullptr, &buffer.Buffer) != VK_SUCCESS) {
+    return false;
+  }
+
+  VkMemoryRequirements requirements{};
+  dt.vkGetBufferMemoryRequirements(device.Device, buffer.Buffer, &requirements);
+  uint32_t memoryType =
+      FindMemoryType(device.MemoryProperties, requirements.memoryTypeBits,
+                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  if (memoryType == UINT32_MAX) {
+    DestroyHostBuffer(device, buffer);
+    return false;
+  }
+
+  VkMemoryAllocateFlagsInfo flagsInfo{};
+  flagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+  flagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+  VkMemoryAllocateInfo allocateInfo{};
+  allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocateInfo.pNext = &flagsInfo;
+  allocateInfo.allocationSize = requirements.size;
+  allocateInfo.memoryTypeIndex = memoryType;
+  if (dt.vkAllocateMemory(device.Device, &allocateInfo, nullptr, &buffer.Memory) != VK_SUCCESS ||
+      dt.vkBindBufferMemory(device.Device, buffer.Buffer, buffer.Memory, 0) != VK_SUCCESS) {
+    DestroyHostBuffer(device, buffer);
+    return false;
+  }
+
+  void* data = nullptr;
+  if (dt.vkMapMemory(device.Device, buffer.Memory, 0, VK_WHOLE_SIZE, 0, &data) != VK_SUCCESS) {
+    DestroyHostBuffer(device, buffer);
+    return false;
+  }
+
+  VkBufferDeviceAddressInfo addressInfo{};
+  addressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+  addressInfo.buffer = buffer.Buffer;
+  VkDeviceAddress address = dt.vkGetBufferDeviceAddress
+                                ? dt.vkGetBufferDeviceAddress(device.Device, &addressInfo)
+                                : dt.vkGetBufferDeviceAddressKHR(device.Device, &addressInfo);
+  // Buffer alignment does not guarantee the alignment the copies need, hence
+  // the extra space reserved above.
+  VkDeviceAddress aligned =
+      (address + kSerializedDataAlignment - 1) & ~(kSerializedDataAlignment - 1);
+  buffer.Address = aligned;
+  buffer.Data = static_cast<uint8_t*>(data) + (aligned - address);
+  buffer.Size = size;
+  return true;
+}
+
+void DestroyHostBuffer(const RtasCacheDevice& device, HostBuffer& buffer) {
+  const auto& dt = device.DispatchTable;
+  if (buffer.Buffer != VK_NULL_HANDLE) {
+    dt.vkDestroyBuffer(device.Device, buffer.Buffer, nullptr);
+  }
+  if (buffer.Memory != VK_NULL_HANDLE) {
+    dt.vkFreeMemory(device.Device, buffer.Memory, nullptr);
+  }
+  buffer = HostBuffer{};
+}
+
+bool IsCacheableBuild(const VkAccelerationStructureBuildGeometryInfoKHR& info) {
+  return info.type == VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR &&
+         info.mode == VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR &&
+         info.dstAccelerationStructure != VK_NULL_HANDLE;
+}
+
+uint64_t ComputeBuildKey(uint64_t commandKey,
+                         uint32_t infoIndex,
+                         const VkAccelerationStructureBuildGeometryInfoKHR& info,
+                         const VkAccelerationStructureBuildRangeInfoKHR* ranges) {
+  // Device addresses are left out: they differ between runs while the data
+  // behind them is identified by the command key.
+  BuildHasher hasher;
+  hasher.Add(commandKey);
+  hasher.Add(infoIndex);
+  hasher.Add(info.type);
+  hasher.Add(info.flags);
+  hasher.Add(info.geometryCount);
+  for (uint32_t g = 0; g < info.geometryCount; ++g) {
+    const VkAccelerationStructureGeometryKHR* geometry = nullptr;
+    if (info.pGeometries) {
+      geometry = &info.pGeometries[g];
+    } else if (info.ppGeometries) {
+      geometry = info.ppGeometries[g];
+    }
+    if (geometry == nullptr) {
+      continue;
+    }
+    hasher.Add(geometry->geometryType);
+    hasher.Add(geometry->flags);
+    switch (geometry->geometryType) {
+    case VK_GEOMETRY_TYPE_TRIANGLES_KHR: {
+      const auto& triangles = geometry->geometry.triangles;
+      hasher.Add(triangles.vertexFormat);
+      hasher.Add(triangles.vertexStride);
+      hasher.Add(triangles.maxVertex);
+      hasher.Add(triangles.indexType);
+      hasher.Add(triangles.transformData.deviceAddress != 0);
+      break;
+    }
+    case VK_GEOMETRY_TYPE_AABBS_KHR:
+      hasher.Add(geometry->geometry.aabbs.stride);
+      break;
+    default:
+      break;
+    }
+    if (ranges != nullptr) {
+      hasher.Add(ranges[g].primitiveCount);
+      hasher.Add(ranges[g].primitiveOffset);
+      hasher.Add(ranges[g].firstVertex);
+      hasher.Add(ranges[g].transformOffset);
+    }
+  }
+  return hasher.Get();
+}
+
+} // namespace vulkan
+} // namespace gits
@@ -0,0 +1,68 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#pragma once
+
+#include "vulkanHeader2.h"
+#include "dispatchTableAuto.h"
+
+#include <cstdint>
+
+namespace gits {
+namespace vulkan {
+
+// Serialized acceleration structure header (Vulkan spec, "Acceleration
+// Structure Serialization"): driver UUID, compatibility UUID, then the
+// serialized and deserialized sizes.
+constexpr size_t kSerializedHeaderCompatibilitySize = 2 * VK_UUID_SIZE;
+constexpr size_t kSerializedSizeOffset = 2 * VK_UUID_SIZE;
+constexpr size_t kSerializedHeaderSize = 2 * VK_UUID_SIZE + 3 * sizeof(uint64_t);
+// VUID-vkCmdCopyMemoryToAccelerationStructureKHR-pInfo-03743 and
+// VUID-vkCmdCopyAccelerationStructureToMemoryKHR-pInfo-03740.
+constexpr VkDeviceSize kSerializedDataAlignment = 256;
+
+// The device the cache operates on.  The plugin context exposes only the most
+// recently created device's dispatch table, so it is copied once when the first
+// device is created and used from then on.
+struct RtasCacheDevice {
+  VkDevice Device{VK_NULL_HANDLE};
+  VkDeviceLevelDispatchTable DispatchTable{};
+  VkPhysicalDeviceMemoryProperties MemoryProperties{};
+};
+
+// Host-visible, coherent, persistently mapped buffer with a device address.
+// Address and Data point at the first kSerializedDataAlignment aligned byte.
+struct HostBuffer {
+  VkBuffer Buffer{VK_NULL_HANDLE};
+  VkDeviceMemory Memory{VK_NULL_HANDLE};
+  VkDeviceAddress Address{};
+  VkDeviceSize Size{};
+  uint8_t* Data{nullptr};
+};
+
+bool CreateHostBuffer(const RtasCacheDevice& device,
+                      VkDeviceSize size,
+                      VkBufferUsageFlags usage,
+                      HostBuffer& buffer);
+void DestroyHostBuffer(const RtasCacheDevice& device, HostBuffer& buffer);
+
+// Only from-scratch bottom-level builds are cached: top-level structures embed
+// BLAS device addresses, and updates depend on the previous contents.
+bool IsCacheableBuild(const VkAccelerationStructureBuildGeometryInfoKHR& info);
+
+// Cache key of one build of a vkCmdBuildAccelerationStructuresKHR call.  The
+// command key identifies the build within the stream (and so the geometry data
+// it reads); the build description and ranges are hashed in as well so a cache
+// recorded from a different stream or a changed build is never applied.
+uint64_t ComputeBuildKey(uint64_t commandKey,
+                         uint32_t infoIndex,
+                         const VkAccelerationStructureBuildGeometryInfoKHR& info,
+                         const VkAccelerationStructureBuildRangeInfoKHR* ranges);
+
+} // namespace vulkan
+} // namespace gits
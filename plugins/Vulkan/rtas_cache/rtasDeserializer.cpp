@@ -0,0 +1,106 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#include "rtasDeserializer.h"
+#include "log.h"
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace gits {
+namespace vulkan {
+
+RtasDeserializer::RtasDeserializer(const std::string& cacheFile) : m_CacheFile(cacheFile) {}
+
+bool RtasDeserializer::PreloadCache(const RtasCacheDevice& device) {
+  struct CachedBlas {
+    uint64_t BuildKey{};
+    std::vector<char> Data;
+  };
+  std::vector<CachedBlas> blases;
+  VkDeviceSize totalSize = 0;
+  {
+    std::ifstream cache(m_CacheFile, std::ios_base::binary);
+    uint64_t buildKey = 0;
+    uint64_t size = 0;
+    while (cache.read(reinterpret_cast<char*>(&buildKey), sizeof(buildKey)) &&
+           cache.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+      if (size < kSerializedHeaderSize) {
+        LOG_ERROR << "RtasCache - Corrupted cache file";
+        return false;
+      }
+      CachedBlas blas{buildKey, std::vector<char>(size)};
+      if (!cache.read(blas.Data.data(), size)) {
+        LOG_ERROR << "RtasCache - Truncated cache file";
+        return false;
+      }
+      totalSize = (totalSize + kSerializedDataAlignment - 1) & ~(kSerializedDataAlignment - 1);
+      totalSize += size;
+      blases.push_back(std::move(blas));
+    }
+  }
+  if (blases.empty()) {
+    LOG_WARNING << "RtasCache - Cache file is empty";
+    return false;
+  }
+
+  // All entries come from one device and driver, so checking one is enough.
+  const auto& dt = device.DispatchTable;
+  VkAccelerationStructureVersionInfoKHR versionInfo{};
+  versionInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_VERSION_INFO_KHR;
+  versionInfo.pVersionData = reinterpret_cast<const uint8_t*>(blases.front().Data.data());
+  VkAccelerationStructureCompatibilityKHR compatibility =
+      VK_ACCELERATION_STRUCTURE_COMPATIBILITY_INCOMPATIBLE_KHR;
+  dt.vkGetDeviceAccelerationStructureCompatibilityKHR(device.Device, &versionInfo, &compatibility);
+  if (compatibility != VK_ACCELERATION_STRUCTURE_COMPATIBILITY_COMPATIBLE_KHR) {
+    LOG_ERROR << "RtasCache - Cache was recorded on an incompatible device or driver";
+    return false;
+  }
+
+  if (!CreateHostBuffer(device, totalSize,
+                        VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR,
+                        m_Buffer)) {
+    LOG_ERROR << "RtasCache - Cannot allocate " << totalSize << " bytes for the cache";
+    return false;
+  }
+  m_Device = &device;
+
+  VkDeviceSize offset = 0;
+  for (const auto& blas : blases) {
+    offset = (offset + kSerializedDataAlignment - 1) & ~(kSerializedDataAlignment - 1);
+    std::memcpy(m_Buffer.Data + offset, blas.Data.data(), blas.Data.size());
+    m_Entries[blas.BuildKey] = offset;
+    offset += blas.Data.size();
+  }
+  LOG_INFO << "RtasCache - Preloaded " << m_Entries.size() << " BLASes";
+  return true;
+}
+
+void RtasDeserializer::Deserialize(VkCommandBuffer commandBuffer,
+                                   uint64_t buildKey,
+                                   VkAccelerationStructureKHR accelerationStructure) {
+  VkCopyMemoryToAccelerationStructureInfoKHR copyInfo{};
+  copyInfo.sType = VK_STRUCTURE_TYPE_COPY_MEMORY_TO_ACCELERATION_STRUCTURE_INFO_KHR;
+  copyInfo.src.deviceAddress = m_Buffer.Address + m_Entries.at(buildKey);
+  copyInfo.dst = accelerationStructure;
+  copyInfo.mode = VK_COPY_ACCELERATION_STRUCTURE_MODE_DESERIALIZE_KHR;
+  m_Device->DispatchTable.vkCmdCopyMemoryToAccelerationStructureKHR(commandBuffer, &copyInfo);
+}
+
+void RtasDeserializer::Release() {
+  if (m_Device == nullptr) {
+    return;
+  }
+  DestroyHostBuffer(*m_Device, m_Buffer);
+  m_Entries.clear();
+  m_Device = nullptr;
+}
+
+} // namespace vulkan
+} // namespace gits
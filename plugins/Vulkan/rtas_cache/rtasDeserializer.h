@@ -0,0 +1,49 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#pragma once
+
+#include "rtasCacheUtils.h"
+
+#include <filesystem>
+#include <unordered_map>
+
+namespace gits {
+namespace vulkan {
+
+// Replaces cached BLAS builds with DESERIALIZE copies.  The whole cache file is
+// uploaded once into a single host-visible buffer, each BLAS at an offset that
+// satisfies the copy source alignment.
+class RtasDeserializer {
+public:
+  RtasDeserializer(const std::string& cacheFile);
+  ~RtasDeserializer() = default;
+  RtasDeserializer(const RtasDeserializer&) = delete;
+  RtasDeserializer& operator=(const RtasDeserializer&) = delete;
+
+  // Returns false if the cache cannot be used on this device, e.g. it was
+  // recorded with another driver.
+  bool PreloadCache(const RtasCacheDevice& device);
+  bool IsCached(uint64_t buildKey) const {
+    return m_Entries.count(buildKey) != 0;
+  }
+  void Deserialize(VkCommandBuffer commandBuffer,
+                   uint64_t buildKey,
+                   VkAccelerationStructureKHR accelerationStructure);
+  // Must be called before the device is destroyed.
+  void Release();
+
+private:
+  std::filesystem::path m_CacheFile;
+  const RtasCacheDevice* m_Device{nullptr};
+  HostBuffer m_Buffer;
+  std::unordered_map<uint64_t, VkDeviceSize> m_Entries;
+};
+
+} // namespace vulkan
+} // namespace gits
@@ -0,0 +1,368 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#include "rtasSerializer.h"
+#include "log.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace gits {
+namespace vulkan {
+
+RtasSerializer::RtasSerializer(const std::string& cacheFile) : m_CacheFile(cacheFile) {}
+
+RtasSerializer::~RtasSerializer() {
+  WriteCache();
+}
+
+void RtasSerializer::Serialize(const RtasCacheDevice& device,
+                               VkCommandBuffer commandBuffer,
+                               uint64_t buildKey,
+                               const VkAccelerationStructureBuildGeometryInfoKHR& info,
+                               const VkAccelerationStructureBuildRangeInfoKHR* ranges) {
+  if (ranges == nullptr || m_SerializedBlases.count(buildKey)) {
+    return;
+  }
+  m_Device = &device;
+  m_Used = true;
+  const auto& dt = device.DispatchTable;
+
+  // A rebuild would overwrite a structure whose previous build is not read back
+  // yet, so finish that first.
+  if (IsPending(info.dstAccelerationStructure)) {
+    RetireCompleted(true);
+  }
+
+  StagedBlas staged;
+  staged.BuildKey = buildKey;
+  staged.AccelerationStructure = info.dstAccelerationStructure;
+  VkQueryPoolCreateInfo queryPoolInfo{};
+  queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+  queryPoolInfo.queryType = VK_QUERY_TYPE_ACCELERATION_STRUCTURE_SERIALIZATION_SIZE_KHR;
+  queryPoolInfo.queryCount = 1;
+  if (dt.vkCreateQueryPool(device.Device, &queryPoolInfo, nullptr, &staged.QueryPool) !=
+      VK_SUCCESS) {
+    LOG_WARNING << "RtasCache - Cannot create serialization size query for BLAS " << buildKey;
+    return;
+  }
+
+  VkMemoryBarrier barrier{};
+  barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  barrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+  barrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR;
+  dt.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+                          VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, 0, 1, &barrier, 0,
+                          nullptr, 0, nullptr);
+
+  dt.vkCmdResetQueryPool(commandBuffer, staged.QueryPool, 0, 1);
+  dt.vkCmdWriteAccelerationStructuresPropertiesKHR(
+      commandBuffer, 1, &info.dstAccelerationStructure,
+      VK_QUERY_TYPE_ACCELERATION_STRUCTURE_SERIALIZATION_SIZE_KHR, staged.QueryPool, 0);
+
+  m_Staged[commandBuffer].push_back(std::move(staged));
+}
+
+void RtasSerializer::ResetCommandBuffer(VkCommandBuffer commandBuffer) {
+  auto it = m_Staged.find(commandBuffer);
+  if (it == m_Staged.end()) {
+    return;
+  }
+  for (auto& staged : it->second) {
+    DestroyStaged(staged);
+  }
+  m_Staged.erase(it);
+}
+
+void RtasSerializer::Submit(VkQueue queue, const std::vector<VkCommandBuffer>& commandBuffers) {
+  if (m_Device == nullptr) {
+    return;
+  }
+  RetireCompleted(false);
+
+  Submission submission;
+  submission.Queue = queue;
+  for (VkCommandBuffer commandBuffer : commandBuffers) {
+    auto it = m_Staged.find(commandBuffer);
+    if (it == m_Staged.end()) {
+      continue;
+    }
+    for (auto& staged : it->second) {
+      submission.Blases.push_back(std::move(staged));
+    }
+    m_Staged.erase(it);
+  }
+  if (submission.Blases.empty()) {
+    return;
+  }
+
+  // An empty submit signals its fence once the preceding submission, and so
+  // the size queries, have completed.
+  const auto& dt = m_Device->DispatchTable;
+  VkFenceCreateInfo fenceInfo{};
+  fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+  if (dt.vkCreateFence(m_Device->Device, &fenceInfo, nullptr, &submission.Fence) != VK_SUCCESS ||
+      dt.vkQueueSubmit(queue, 0, nullptr, submission.Fence) != VK_SUCCESS) {
+    LOG_WARNING << "RtasCache - Cannot track submission; waiting for the device";
+    if (submission.Fence != VK_NULL_HANDLE) {
+      dt.vkDestroyFence(m_Device->Device, submission.Fence, nullptr);
+      submission.Fence = VK_NULL_HANDLE;
+    }
+    dt.vkDeviceWaitIdle(m_Device->Device);
+  }
+  m_Submissions.push_back(std::move(submission));
+}
+
+void RtasSerializer::SetQueueFamily(VkQueue queue, uint32_t queueFamilyIndex) {
+  m_QueueFamilies[queue] = queueFamilyIndex;
+}
+
+void RtasSerializer::DestroyAccelerationStructure(
+    VkAccelerationStructureKHR accelerationStructure) {
+  if (m_Device == nullptr) {
+    return;
+  }
+  // Queries recorded into a command buffer that was never submitted are dropped
+  // with the command buffer.
+  if (IsPending(accelerationStructure)) {
+    RetireCompleted(true);
+  }
+}
+
+bool RtasSerializer::IsPending(VkAccelerationStructureKHR accelerationStructure) const {
+  for (const auto& submission : m_Submissions) {
+    for (const auto& staged : submission.Blases) {
+      if (staged.AccelerationStructure == accelerationStructure) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool RtasSerializer::IsCompleted(const Submission& submission, bool wait) const {
+  if (submission.Fence == VK_NULL_HANDLE) {
+    return true;
+  }
+  const auto& dt = m_Device->DispatchTable;
+  VkResult status =
+      wait ? dt.vkWaitForFences(m_Device->Device, 1, &submission.Fence, VK_TRUE, UINT64_MAX)
+           : dt.vkGetFenceStatus(m_Device->Device, submission.Fence);
+  return status == VK_SUCCESS;
+}
+
+VkCommandPool RtasSerializer::GetCommandPool(VkQueue queue) {
+  auto family = m_QueueFamilies.find(queue);
+  if (family == m_QueueFamilies.end()) {
+    return VK_NULL_HANDLE;
+  }
+  VkCommandPool& commandPool = m_CommandPools[family->second];
+  if (commandPool == VK_NULL_HANDLE) {
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = family->second;
+    m_Device->DispatchTable.vkCreateCommandPool(m_Device->Device, &poolInfo, nullptr,
+                                                &commandPool);
+  }
+  return commandPool;
+}
+
+bool RtasSerializer::SubmitCopies(Submission& submission) {
+  const auto& dt = m_Device->DispatchTable;
+
+  // The size queries have completed: allocate buffers of exactly the serialized
+  // sizes.
+  bool anyBuffer = false;
+  for (auto& staged : submission.Blases) {
+    uint64_t size = 0;
+    if (dt.vkGetQueryPoolResults(m_Device->Device, staged.QueryPool, 0, 1, sizeof(size), &size,
+                                 sizeof(size), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS ||
+        size < kSerializedHeaderSize) {
+      LOG_WARNING << "RtasCache - Cannot query serialized size of BLAS " << staged.BuildKey;
+      continue;
+    }
+    if (!CreateHostBuffer(*m_Device, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, staged.Buffer)) {
+      LOG_WARNING << "RtasCache - Cannot allocate serialization buffer for BLAS "
+                  << staged.BuildKey;
+      continue;
+    }
+    anyBuffer = true;
+  }
+  if (!anyBuffer) {
+    return false;
+  }
+
+  submission.CopyCommandPool = GetCommandPool(submission.Queue);
+  if (submission.CopyCommandPool == VK_NULL_HANDLE) {
+    LOG_WARNING << "RtasCache - Unknown queue family; cannot serialize BLASes";
+    return false;
+  }
+  VkCommandBufferAllocateInfo allocInfo{};
+  allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+  allocInfo.commandPool = submission.CopyCommandPool;
+  allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  allocInfo.commandBufferCount = 1;
+  if (dt.vkAllocateCommandBuffers(m_Device->Device, &allocInfo, &submission.CopyCommandBuffer) !=
+      VK_SUCCESS) {
+    submission.CopyCommandBuffer = VK_NULL_HANDLE;
+    LOG_WARNING << "RtasCache - Cannot allocate serialization command buffer";
+    return false;
+  }
+
+  VkCommandBufferBeginInfo beginInfo{};
+  beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  VkCommandBuffer commandBuffer = submission.CopyCommandBuffer;
+  dt.vkBeginCommandBuffer(commandBuffer, &beginInfo);
+  for (const auto& staged : submission.Blases) {
+    if (staged.Buffer.Buffer == VK_NULL_HANDLE) {
+      continue;
+    }
+    VkCopyAccelerationStructureToMemoryInfoKHR copyInfo{};
+    copyInfo.sType = VK_STRUCTURE_TYPE_COPY_ACCELERATION_STRUCTURE_TO_MEMORY_INFO_KHR;
+    copyInfo.src = staged.AccelerationStructure;
+    copyInfo.dst.deviceAddress = staged.Buffer.Address;
+    copyInfo.mode = VK_COPY_ACCELERATION_STRUCTURE_MODE_SERIALIZE_KHR;
+    dt.vkCmdCopyAccelerationStructureToMemoryKHR(commandBuffer, &copyInfo);
+  }
+  VkMemoryBarrier barrier{};
+  barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+  dt.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+                          VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+  dt.vkEndCommandBuffer(commandBuffer);
+
+  VkSubmitInfo submitInfo{};
+  submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  submitInfo.commandBufferCount = 1;
+  submitInfo.pCommandBuffers = &commandBuffer;
+  if ((submission.Fence != VK_NULL_HANDLE &&
+       dt.vkResetFences(m_Device->Device, 1, &submission.Fence) != VK_SUCCESS) ||
+      dt.vkQueueSubmit(submission.Queue, 1, &submitInfo, submission.Fence) != VK_SUCCESS) {
+    LOG_WARNING << "RtasCache - Cannot submit serialization copies";
+    dt.vkFreeCommandBuffers(m_Device->Device, submission.CopyCommandPool, 1,
+                            &submission.CopyCommandBuffer);
+    submission.CopyCommandBuffer = VK_NULL_HANDLE;
+    return false;
+  }
+  if (submission.Fence == VK_NULL_HANDLE) {
+    dt.vkQueueWaitIdle(submission.Queue);
+  }
+  return true;
+}
+
+void RtasSerializer::RetireCompleted(bool wait) {
+  for (auto it = m_Submissions.begin(); it != m_Submissions.end();) {
+    // The application's submission completes first, then the copies submitted
+    // for it.
+    if (!IsCompleted(*it, wait)) {
+      ++it;
+      continue;
+    }
+    if (it->CopyCommandBuffer == VK_NULL_HANDLE && SubmitCopies(*it) && !IsCompleted(*it, wait)) {
+      ++it;
+      continue;
+    }
+    Retire(*it);
+    it = m_Submissions.erase(it);
+  }
+}
+
+void RtasSerializer::Retire(Submission& submission) {
+  const auto& dt = m_Device->DispatchTable;
+  // Only submissions whose copies were submitted, and so have completed, are
+  // read back.
+  const bool copied = submission.CopyCommandBuffer != VK_NULL_HANDLE;
+  for (auto& staged : submission.Blases) {
+    if (copied && staged.Buffer.Buffer != VK_NULL_HANDLE) {
+      const uint8_t* data = staged.Buffer.Data;
+      uint64_t size = 0;
+      std::memcpy(&size, data + kSerializedSizeOffset, sizeof(size));
+      if (size < kSerializedHeaderSize || size > staged.Buffer.Size) {
+        LOG_WARNING << "RtasCache - Invalid serialized size " << size << " of BLAS "
+                    << staged.BuildKey;
+      } else if (m_SerializedBlases.emplace(staged.BuildKey, std::vector<char>(data, data + size))
+                     .second) {
+        m_BuildKeys.push_back(staged.BuildKey);
+      }
+    }
+    DestroyStaged(staged);
+  }
+  if (submission.CopyCommandBuffer != VK_NULL_HANDLE) {
+    dt.vkFreeCommandBuffers(m_Device->Device, submission.CopyCommandPool, 1,
+                            &submission.CopyCommandBuffer);
+  }
+  if (submission.Fence != VK_NULL_HANDLE) {
+    dt.vkDestroyFence(m_Device->Device, submission.Fence, nullptr);
+  }
+}
+
+void RtasSerializer::DestroyStaged(StagedBlas& staged) {
+  DestroyHostBuffer(*m_Device, staged.Buffer);
+  if (staged.QueryPool != VK_NULL_HANDLE) {
+    m_Device->DispatchTable.vkDestroyQueryPool(m_Device->Device, staged.QueryPool, nullptr);
+    staged.QueryPool = VK_NULL_HANDLE;
+  }
+}
+
+void RtasSerializer::Flush() {
+  if (m_Device == nullptr) {
+    return;
+  }
+  RetireCompleted(true);
+  for (auto& [commandBuffer, stagedBlases] : m_Staged) {
+    for (auto& staged : stagedBlases) {
+      DestroyStaged(staged);
+    }
+  }
+  m_Staged.clear();
+  for (auto& [queueFamilyIndex, commandPool] : m_CommandPools) {
+    if (commandPool != VK_NULL_HANDLE) {
+      m_Device->DispatchTable.vkDestroyCommandPool(m_Device->Device, commandPool, nullptr);
+    }
+  }
+  m_CommandPools.clear();
+  m_Device = nullptr;
+}
+
+void RtasSerializer::WriteCache() {
+  if (m_Written || !m_Used) {
+    return;
+  }
+
+  try {
+    Flush();
+
+    LOG_INFO << "RtasCache - Writing " << m_CacheFile.string();
+
+    std::ofstream cache(m_CacheFile, std::ios_base::binary);
+    for (uint64_t buildKey : m_BuildKeys) {
+      const auto& data = m_SerializedBlases[buildKey];
+      uint64_t size = data.size();
+      cache.write(reinterpret_cast<const char*>(&buildKey), sizeof(buildKey));
+      cache.write(reinterpret_cast<const char*>(&size), sizeof(size));
+      cache.write(data.data(), data.size());
+      if (cache.bad()) {
+        LOG_ERROR << "RtasCache - Error writing BLAS " << buildKey;
+        break;
+      }
+    }
+    cache.flush();
+
+    LOG_INFO << "RtasCache - Writing done";
+    m_Written = true;
+  } catch (...) {
+    std::cerr << "Unhandled exception caught in RtasSerializer::WriteCache()";
+  }
+}
+
+} // namespace vulkan
+} // namespace gits
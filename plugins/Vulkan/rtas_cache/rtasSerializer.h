@@ -0,0 +1,91 @@
+// ===================== begin_copyright_notice ============================
+//
+// Copyright (C) 2023-2026 Intel Corporation
+//
+// SPDX-License-Identifier: MIT
+//
+// ===================== end_copyright_notice ==============================
+
+#pragma once
+
+#include "rtasCacheUtils.h"
+
+#include <filesystem>
+#include <unordered_map>
+#include <vector>
+
+namespace gits {
+namespace vulkan {
+
+// Serializes BLASes right after they are built.  A serialization size query is
+// recorded into the application's command buffer after each build.  Once a
+// submission of that command buffer has completed, SERIALIZE copies into
+// host-visible buffers of exactly the queried sizes are submitted to the same
+// queue; when they have completed the serialized data is read back, and the
+// cache file is written at the end.
+class RtasSerializer {
+public:
+  RtasSerializer(const std::string& cacheFile);
+  ~RtasSerializer();
+  RtasSerializer(const RtasSerializer&) = delete;
+  RtasSerializer& operator=(const RtasSerializer&) = delete;
+
+  void Serialize(const RtasCacheDevice& device,
+                 VkCommandBuffer commandBuffer,
+                 uint64_t buildKey,
+                 const VkAccelerationStructureBuildGeometryInfoKHR& info,
+                 const VkAccelerationStructureBuildRangeInfoKHR* ranges);
+  // Drops the copies recorded into a command buffer that is re-recorded or
+  // freed without having been submitted.
+  void ResetCommandBuffer(VkCommandBuffer commandBuffer);
+  void Submit(VkQueue queue, const std::vector<VkCommandBuffer>& commandBuffers);
+  void SetQueueFamily(VkQueue queue, uint32_t queueFamilyIndex);
+  // Reads back pending serializations of a structure before it is destroyed.
+  void DestroyAccelerationStructure(VkAccelerationStructureKHR accelerationStructure);
+  // Waits for all submitted copies and releases every device object.  Must be
+  // called before the device is destroyed.
+  void Flush();
+  void WriteCache();
+
+  unsigned GetSerializedCount() const {
+    return static_cast<unsigned>(m_BuildKeys.size());
+  }
+
+private:
+  struct StagedBlas {
+    uint64_t BuildKey{};
+    VkAccelerationStructureKHR AccelerationStructure{VK_NULL_HANDLE};
+    VkQueryPool QueryPool{VK_NULL_HANDLE};
+    HostBuffer Buffer;
+  };
+  struct Submission {
+    VkQueue Queue{VK_NULL_HANDLE};
+    // Signaled by the application's submission, then reused for the copies.
+    VkFence Fence{VK_NULL_HANDLE};
+    VkCommandPool CopyCommandPool{VK_NULL_HANDLE};
+    VkCommandBuffer CopyCommandBuffer{VK_NULL_HANDLE};
+    std::vector<StagedBlas> Blases;
+  };
+
+  bool IsPending(VkAccelerationStructureKHR accelerationStructure) const;
+  bool IsCompleted(const Submission& submission, bool wait) const;
+  bool SubmitCopies(Submission& submission);
+  VkCommandPool GetCommandPool(VkQueue queue);
+  void DestroyStaged(StagedBlas& staged);
+  void Retire(Submission& submission);
+  void RetireCompleted(bool wait);
+
+  std::filesystem::path m_CacheFile;
+  const RtasCacheDevice* m_Device{nullptr};
+  std::unordered_map<VkCommandBuffer, std::vector<StagedBlas>> m_Staged;
+  std::vector<Submission> m_Submissions;
+  std::unordered_map<VkQueue, uint32_t> m_QueueFamilies;
+  std::unordered_map<uint32_t, VkCommandPool> m_CommandPools;
+  std::vector<uint64_t> m_BuildKeys;
+  std::unordered_map<uint64_t, std::vector<char>> m_SerializedBlases;
+  bool m_Used{false};
+  bool m_Written{false};
+};
+
+} // namespace vulkan
+} // namespace gits
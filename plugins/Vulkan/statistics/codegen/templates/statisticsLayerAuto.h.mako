@@ -35,6 +35,7 @@ public:
   void Post(UpdateWindowMetaCommand& command) override;
   void Post(RestoreContentManifestCommand& command) override;
   void Post(RestoreContentDataCommand& command) override;
+  void Post(RestoreContentCachedDataCommand& command) override;
   %for command in commands:
   <% define = get_define(command.platform) %>\
   % if define:
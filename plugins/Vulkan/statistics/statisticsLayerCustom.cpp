@@ -44,5 +44,9 @@ void StatisticsLayer::Post(RestoreContentDataCommand& command) {
   m_StatisticsService.Command("RestoreContentData");
 }
 
+void StatisticsLayer::Post(RestoreContentCachedDataCommand& command) {
+  m_StatisticsService.Command("RestoreContentCachedData");
+}
+
 } // namespace vulkan
 } // namespace gits
@@ -112,6 +112,9 @@ bool ConfigureRecorder(const std::filesystem::path& configPath, bool legacyMode)
   if (!cfg.common.shared.logToConsole.value_or(false)) {
     log::RemoveConsoleAppender();
   }
+  if (cfg.common.shared.asyncLogging) {
+    log::EnableAsyncLogging();
+  }
 
   LOG_INFO << "GITS configured for process: " << processNameHUD;
 